@@ -0,0 +1,612 @@
+#include "connection.h"
+
+// Anzahl der Pakete pro Messung
+#define BENCHMARK_PACKAGES 20000
+
+// Anzahl der Pakete, die gesendet werden, bevor der Empfänger den Socket leert
+#define BENCHMARK_ROUND 256
+
+// Port des Empfängers auf dem Loopback-Interface
+#define BENCHMARK_PORT 52000
+
+// Anzahl gleichzeitig laufender Timer der Timer-Messungen
+static const int BENCHMARK_TIMERS[] = {1000, 10000, 30000};
+
+// Laufzeit der Timer in Zeitschlitzen, wie beim Senden eines Pakets
+#define BENCHMARK_TIMER_TICKS MAX_ALLOWED_CLIENTS
+
+
+/**
+ * Struktur: linked_list_timer
+ * ----------------------------
+ * Definiert einen Eintrag in einer verketteten Liste, die Timer für Pakete speichert.
+ * Frühere Timerverwaltung von Server und Client, nur noch als Vergleich für das Timer-Rad.
+ */
+struct linked_list_timer
+{
+    struct linked_list_timer* next; // Zeiger auf den nächsten Timer
+    int packageId;                  // Paket-ID
+    int ticksToGo;                  // Verbleibende Zeit in Ticks
+};
+
+
+/**
+ * Struktur: benchmark_result
+ * ---------------------------
+ * Ergebnis einer Messung des Datagramm-Transports.
+ */
+struct benchmark_result
+{
+    long long duration_us;      // Dauer der Messung in Mikrosekunden
+    long long send_calls;       // Systemaufrufe zum Senden
+    long long send_packets;     // Gesendete Datagramme
+    long long receive_calls;    // Systemaufrufe zum Empfangen
+    long long receive_packets;  // Empfangene Datagramme
+};
+
+
+/**
+ * Struktur: timer_result
+ * -----------------------
+ * Ergebnis einer Messung der Timerverwaltung in Nanosekunden pro Operation.
+ */
+struct timer_result
+{
+    double add_ns;      // Timer starten
+    double rearm_ns;    // Timer löschen und neu starten
+    double expire_ns;   // Abgelaufenen Timer entfernen
+};
+
+
+/**
+ * Funktion: add_timer_linked_list_timer
+ * --------------------------------
+ * Fügt ein neues Element (`new_link`) zur bestehenden verketteten Liste hinzu. Die
+ * Funktion passt dabei die `ticksToGo`-Werte an, sodass jedes Element die relative
+ * Zeit bis zum nächsten Element repräsentiert.
+ *
+ * Parameter:
+ * - head: Ein Pointer auf das erste Element der verketteten Liste.
+ * - new_link: Ein Pointer auf das neue Element, das hinzugefügt werden soll.
+ *
+ * Rückgabewert:
+ * - Keiner (void).
+ */
+static void add_timer_linked_list_timer(struct linked_list_timer** head, int package_id, int ticks)
+{
+    struct linked_list_timer* new_timer = (struct linked_list_timer*)malloc(sizeof(struct linked_list_timer));
+    new_timer->packageId = package_id;
+    new_timer->ticksToGo = ticks;
+    
+    // DIESE SCHEISS ZEILE HAT MICH 5 STUNDEN MEINES LEBENS GEKOSTET !!! 
+    // Auf einem Mac erkennt er das der Wert keine gültige Speicheraddresse ist und bricht ab, ein ThinkPad erkennt das nicht
+    // Die Sau versucht auf unbekannten Speicher zuzugreifen was zu einem Absturz bei hinzufügen oder lesen eines Paketes. 
+    new_timer->next = NULL;
+
+    
+    if(*head == NULL)
+    {
+        *head = new_timer;
+        return;
+    }
+
+    // Solange wir nicht am Ende der Liste sind, reduzieren wir die `ticksToGo` des neuen Elements
+    // um die `ticksToGo` des aktuellen Elements.
+    while((*head)->next != NULL)
+    {
+        new_timer->ticksToGo -= (*head)->ticksToGo;
+        head = &((*head)->next); // Weiter zum nächsten Element in der Liste.
+    }
+
+    new_timer->ticksToGo -= (*head)->ticksToGo;
+
+
+    // Wenn wir das Ende der Liste erreicht haben, verknüpfen wir das neue Element.
+    (*head)->next = new_timer;
+}
+
+
+/**
+ * Funktion: del_timer_linked_list_timer
+ * --------------------------------
+ * Entfernt das erste Element aus der verketteten Liste. Wenn die Liste nur ein Element enthält,
+ * wird der Kopf der Liste auf NULL gesetzt.
+ *
+ * Parameter:
+ * - head: Ein Pointer auf das erste Element der verketteten Liste.
+ *
+ * Rückgabewert:
+ * - Keiner (void).
+ */
+static void del_timer_linked_list_timer(struct linked_list_timer** head, int package_id) 
+{
+    if(*head == NULL) 
+    {
+        // Liste ist leer
+        return;
+    }
+
+    // Prüfen, ob der Kopfknoten gelöscht werden soll
+    struct linked_list_timer* current = *head;
+    if(current->packageId == package_id) 
+    {
+        if(current->next != NULL)
+        {
+            current->next->ticksToGo += current->ticksToGo; // Nächster Knoten erhält die verbleibenden Ticks
+        }
+        
+        *head = current->next; // Kopf auf das nächste Element setzen
+        free(current);
+        return;
+    }
+
+    // Iterieren und nach dem zu löschenden Element suchen
+    struct linked_list_timer* previous = NULL;
+
+    while(current != NULL)
+    {
+        if(current->packageId == package_id) 
+        {
+            // Knoten gefunden, entfernen
+            if(current->next != NULL) // Wenn es der letzte Knoten ist
+            {
+                current->next->ticksToGo += current->ticksToGo; // Nächster Knoten erhält die verbleibenden Ticks
+            }
+            previous->next = current->next;
+            free(current);
+            return;
+        }
+
+        // Pointer aktualisieren
+        previous = current;
+        current = current->next;
+    }
+}
+
+
+
+
+/**
+ * Funktion: tick_timer_linked_list_timer
+ * ---------------------------------
+ * Reduziert den `ticksToGo`-Wert des ersten Elements in der verketteten Liste um 1.
+ * Wenn `ticksToGo` 0 erreicht, wird das erste Element entfernt und dessen `packageId`
+ * zurückgegeben.
+ *
+ * Parameter:
+ * - head: Ein Pointer auf das erste Element der verketteten Liste.
+ *
+ * Rückgabewert:
+ * - -1: Die Liste ist leer.
+ * - 0: Die Liste wurde aktualisiert, aber kein Timeout ist aufgetreten.
+ * - timeout_package_id: Die `packageId` des Elements, das entfernt wurde.
+ */
+static int tick_timer_linked_list_timer(struct linked_list_timer** head)
+{
+    // Wenn die Liste leer ist, geben wir -1 zurück.
+    if(*head == NULL)
+    {
+        return -1;
+    }
+
+    // Reduziere den `ticksToGo`-Wert des ersten Elements um 1.
+    (*head)->ticksToGo -= 1;
+
+    // Wenn der `ticksToGo`-Wert des ersten Elements 0 erreicht:
+    if((*head)->ticksToGo <=0)
+    {
+        // Speichere die `packageId` des Elements, das entfernt wird.
+        int timeout_package_id = (*head)->packageId;
+
+        // Entferne das erste Element aus der Liste.
+        del_timer_linked_list_timer(head, (*head)->packageId);
+
+        // Gib die `packageId` des entfernten Elements zurück.
+        return timeout_package_id;
+    }
+
+    // Kein Timeout, Rückgabewert 0.
+    return 0;
+}
+
+
+/**
+ * Funktion: expire_timer_linked_list_timer
+ * ----------------------------------------
+ * Entfernt das erste Element der verketteten Liste, wenn es im selben Tick wie ein 
+ * vorheriges Element abgelaufen ist (`ticksToGo` <= 0). Im Gegensatz zu 
+ * `tick_timer_linked_list_timer` wird dabei kein Tick verbraucht.
+ *
+ * Parameter:
+ * - head: Ein Pointer auf das erste Element der verketteten Liste.
+ *
+ * Rückgabewert:
+ * - 0: Kein weiteres Element ist abgelaufen.
+ * - timeout_package_id: Die `packageId` des Elements, das entfernt wurde.
+ *
+ * Beschreibung:
+ * - Wird nach `tick_timer_linked_list_timer` so lange aufgerufen, bis 0 zurückgegeben wird.
+ *   Damit laufen mehrere Timer, die im selben Tick gestartet wurden, auch im selben Tick ab.
+ */
+static int expire_timer_linked_list_timer(struct linked_list_timer** head)
+{
+    if(*head == NULL || (*head)->ticksToGo > 0)
+    {
+        return 0;
+    }
+
+    int timeout_package_id = (*head)->packageId;
+    del_timer_linked_list_timer(head, timeout_package_id);
+
+    return timeout_package_id;
+}
+
+
+/**
+ * Funktion: open_benchmark_socket
+ * -------------------------------
+ * Erstellt einen nicht-blockierenden UDP-Socket auf ::1 und legt die Puffer für
+ * gebündelte Systemaufrufe an.
+ *
+ * Parameter:
+ * - props: Eigenschaften, in denen Socket und Puffer abgelegt werden.
+ * - port: Port, an den gebunden wird, 0 für einen beliebigen Port.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 bei Fehlern.
+ */
+int open_benchmark_socket(struct properties* props, int port)
+{
+    props->sockfd = socket(AF_INET6, SOCK_DGRAM, 0);
+    if(props->sockfd < 0)
+    {
+        print_timestamp();
+        printf(RED "Socket konnte nicht erstellt werden\n" RESET);
+        return -1;
+    }
+
+    int flags = fcntl(props->sockfd, F_GETFL, 0);
+    fcntl(props->sockfd, F_SETFL, flags | O_NONBLOCK);
+
+    int buffer_size = DEFAULT_RECEIVE_BUFFER_SIZE;
+    setsockopt(props->sockfd, SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof(buffer_size));
+
+    memset(&props->my_addr, 0, sizeof(props->my_addr));
+    props->my_addr.sin6_family = AF_INET6;
+    props->my_addr.sin6_addr = in6addr_loopback;
+    props->my_addr.sin6_port = htons(port);
+
+    if(bind(props->sockfd, (struct sockaddr *)&props->my_addr, sizeof(props->my_addr)) < 0)
+    {
+        print_timestamp();
+        printf(RED "Socket konnte nicht auf Port %d gebunden werden\n" RESET, port);
+        perror("\t\t");
+        close_socket(props);
+        return -1;
+    }
+
+    if(transport_init(props) < 0)
+    {
+        close_socket(props);
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/**
+ * Funktion: run_transport_benchmark
+ * ---------------------------------
+ * Sendet `BENCHMARK_PACKAGES` Datenpakete über ::1 und empfängt sie wieder. Die Pakete
+ * werden in Runden zu `BENCHMARK_ROUND` Stück gesendet, damit der Empfangspuffer des
+ * Sockets nicht überläuft.
+ *
+ * Parameter:
+ * - batch_size: Anzahl an Datagrammen pro Systemaufruf.
+ * - result: Ausgabe der Messwerte.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 bei Fehlern.
+ */
+int run_transport_benchmark(int batch_size, struct benchmark_result* result)
+{
+    struct properties sender;
+    struct properties receiver;
+    memset(&sender, 0, sizeof(sender));
+    memset(&receiver, 0, sizeof(receiver));
+
+    sender.is_server = true;
+    sender.id = 1;
+    sender.batch_size = batch_size;
+    sender.sockfd = -1;
+
+    receiver.is_server = false;
+    receiver.id = 2;
+    receiver.batch_size = batch_size;
+    receiver.sockfd = -1;
+
+    if(open_benchmark_socket(&receiver, BENCHMARK_PORT) < 0 || open_benchmark_socket(&sender, 0) < 0)
+    {
+        close_socket(&receiver);
+        return -1;
+    }
+
+    struct communication com;
+    memset(&com, 0, sizeof(com));
+    com.partner = receiver.my_addr;
+    com.req.senderId = sender.id;
+    com.req.reciverId = -1;
+    com.req.type = REQ_DATA;
+    com.req.packageLen = DEFAULT_DATA_BUFFER_SIZE;
+    com.packet = PACKET_NONE;
+
+    struct communication received;
+    memset(&received, 0, sizeof(received));
+
+    // Ausgaben der Sende- und Empfangsfunktionen während der Messung unterdrücken
+    fflush(stdout);
+    int saved_stdout = dup(STDOUT_FILENO);
+    int null_fd = open("/dev/null", O_WRONLY);
+    dup2(null_fd, STDOUT_FILENO);
+
+    long long start = get_time_us();
+    long long received_packages = 0;
+
+    for(int sent = 0; sent < BENCHMARK_PACKAGES;)
+    {
+        for(int i = 0; i < BENCHMARK_ROUND && sent < BENCHMARK_PACKAGES; i++, sent++)
+        {
+            com.req.packageId = sent;
+            send_unicast(&sender, &com);
+        }
+        flush_cast(&sender);
+
+        while(receive_cast(&receiver, &received, NULL) > 0)
+        {
+            received_packages += 1;
+        }
+    }
+
+    result->duration_us = get_time_us() - start;
+
+    fflush(stdout);
+    dup2(saved_stdout, STDOUT_FILENO);
+    close(saved_stdout);
+    close(null_fd);
+
+    result->send_calls = sender.transport->send_calls;
+    result->send_packets = sender.transport->send_packets;
+    result->receive_calls = receiver.transport->receive_calls;
+    result->receive_packets = received_packages;
+
+    // Statistik wurde übernommen, beim Schließen nicht erneut ausgeben
+    free(sender.transport);
+    sender.transport = NULL;
+    free(receiver.transport);
+    receiver.transport = NULL;
+
+    close_socket(&sender);
+    close_socket(&receiver);
+
+    return 0;
+}
+
+
+/**
+ * Funktion: print_benchmark_result
+ * --------------------------------
+ * Gibt die Messwerte einer Messung aus.
+ *
+ * Parameter:
+ * - name: Bezeichnung der Messung.
+ * - result: Messwerte.
+ */
+void print_benchmark_result(const char* name, struct benchmark_result* result)
+{
+    printf("%-12s %10lld %10lld %10.3f %10lld %10.3f %12.0f\n",
+           name,
+           result->send_packets,
+           result->send_calls,
+           result->send_packets > 0 ? (double)result->send_calls / result->send_packets : 0.0,
+           result->receive_packets,
+           result->receive_packets > 0 ? (double)result->receive_calls / result->receive_packets : 0.0,
+           result->duration_us > 0 ? result->receive_packets * 1000000.0 / result->duration_us : 0.0);
+}
+
+
+/**
+ * Funktion: run_list_benchmark
+ * ----------------------------
+ * Misst die verkettete Timer-Liste: `count` Timer starten, jeden Timer wie nach einem 
+ * NACK neu starten und alle Timer ablaufen lassen.
+ *
+ * Parameter:
+ * - count: Anzahl gleichzeitig laufender Timer.
+ * - result: Ausgabe der Messwerte.
+ */
+void run_list_benchmark(int count, struct timer_result* result)
+{
+    struct linked_list_timer* timer_list = NULL;
+
+    long long start = get_time_us();
+    for(int id = 1; id <= count; id++)
+    {
+        add_timer_linked_list_timer(&timer_list, id, BENCHMARK_TIMER_TICKS);
+    }
+    result->add_ns = (get_time_us() - start) * 1000.0 / count;
+
+    // Neu starten in der Reihenfolge der Pakete, so wie NACKs für die Basis eintreffen
+    start = get_time_us();
+    for(int id = 1; id <= count; id++)
+    {
+        del_timer_linked_list_timer(&timer_list, id);
+        add_timer_linked_list_timer(&timer_list, id, BENCHMARK_TIMER_TICKS);
+    }
+    result->rearm_ns = (get_time_us() - start) * 1000.0 / count;
+
+    int expired = 0;
+    start = get_time_us();
+    while(timer_list != NULL)
+    {
+        int timeout_package_id = tick_timer_linked_list_timer(&timer_list);
+        while(timeout_package_id > 0)
+        {
+            expired += 1;
+            timeout_package_id = expire_timer_linked_list_timer(&timer_list);
+        }
+    }
+    result->expire_ns = (get_time_us() - start) * 1000.0 / (expired > 0 ? expired : 1);
+}
+
+
+/**
+ * Funktion: run_wheel_benchmark
+ * -----------------------------
+ * Misst das Timer-Rad mit derselben Last wie `run_list_benchmark`. Vor dem Ablaufen wird 
+ * die Laufzeit der Timer abgewartet, gemessen wird nur das Einsammeln der Timer.
+ *
+ * Parameter:
+ * - count: Anzahl gleichzeitig laufender Timer.
+ * - result: Ausgabe der Messwerte.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 wenn das Timer-Rad nicht angelegt werden konnte.
+ */
+int run_wheel_benchmark(int count, struct timer_result* result)
+{
+    struct timer_wheel timers = {0};
+    if(timer_wheel_init(&timers, count) < 0)
+    {
+        return -1;
+    }
+
+    long long start = get_time_us();
+    for(int id = 1; id <= count; id++)
+    {
+        timer_wheel_add(&timers, id, BENCHMARK_TIMER_TICKS * DEFAULT_SLOT_TIME);
+    }
+    result->add_ns = (get_time_us() - start) * 1000.0 / count;
+
+    start = get_time_us();
+    for(int id = 1; id <= count; id++)
+    {
+        timer_wheel_del(&timers, id);
+        timer_wheel_add(&timers, id, BENCHMARK_TIMER_TICKS * DEFAULT_SLOT_TIME);
+    }
+    result->rearm_ns = (get_time_us() - start) * 1000.0 / count;
+
+    // Warten bis alle Timer abgelaufen sind
+    usleep((BENCHMARK_TIMER_TICKS * DEFAULT_SLOT_TIME + 2 * TIMER_WHEEL_TICK_MS) * 1000);
+
+    int expired = 0;
+    start = get_time_us();
+    timer_wheel_advance(&timers);
+    while(timer_wheel_expire(&timers) > 0)
+    {
+        expired += 1;
+    }
+    result->expire_ns = (get_time_us() - start) * 1000.0 / (expired > 0 ? expired : 1);
+
+    timer_wheel_free(&timers);
+
+    if(expired != count)
+    {
+        print_timestamp();
+        printf(RED "Timer-Rad: %d von %d Timern abgelaufen\n" RESET, expired, count);
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/**
+ * Funktion: print_timer_result
+ * ----------------------------
+ * Gibt die Messwerte einer Timer-Messung aus.
+ *
+ * Parameter:
+ * - name: Bezeichnung der Timerverwaltung.
+ * - count: Anzahl gleichzeitig laufender Timer.
+ * - result: Messwerte.
+ */
+void print_timer_result(const char* name, int count, struct timer_result* result)
+{
+    printf("%-12s %10d %12.1f %12.1f %12.1f\n", name, count, result->add_ns, result->rearm_ns, result->expire_ns);
+}
+
+
+
+/**
+ * Funktion: main
+ * --------------
+ * Vergleicht den Transport mit einem Datagramm pro Systemaufruf mit dem gebündelten
+ * Transport (`sendmmsg`/`recvmmsg`) und die verkettete Timer-Liste mit dem Timer-Rad.
+ *
+ * Parameter:
+ * - argc: Anzahl der Kommandozeilenargumente.
+ * - argv: Optional die Batchgröße des Vergleichs (Standard: DEFAULT_BATCH_SIZE).
+ *
+ * Rückgabewert:
+ * - 0: Erfolgreiche Ausführung.
+ * - -1: Fehler bei der Messung.
+ *
+ * Beschreibung:
+ * - Übersetzen mit: gcc -O2 -o benchmark benchmark.c connection.c
+ * - Ausgegeben werden Systemaufrufe pro Paket beim Senden und Empfangen und Pakete pro Sekunde.
+ * - Für die Timer werden Nanosekunden pro Starten, Neustarten und Ablaufen ausgegeben.
+ */
+int main(int argc, char* argv[])
+{
+    int batch_size = DEFAULT_BATCH_SIZE;
+    if(argc > 1)
+    {
+        batch_size = atoi(argv[1]);
+        if(batch_size < 1 || batch_size > MAX_BATCH_SIZE)
+        {
+            printf(RED "Batchgröße muss zwischen 1 und %d sein.\n" RESET, MAX_BATCH_SIZE);
+            return -1;
+        }
+    }
+
+    struct benchmark_result single;
+    struct benchmark_result batched;
+
+    if(run_transport_benchmark(1, &single) < 0 || run_transport_benchmark(batch_size, &batched) < 0)
+    {
+        print_timestamp();
+        printf("Programm wird beendet\n");
+        return -1;
+    }
+
+    printf("%-12s %10s %10s %10s %10s %10s %12s\n", "Batch", "gesendet", "sendcalls", "calls/pkt", "empfangen", "calls/pkt", "Pakete/s");
+
+    char name[32];
+    snprintf(name, sizeof(name), "1");
+    print_benchmark_result(name, &single);
+    snprintf(name, sizeof(name), "%d", batch_size);
+    print_benchmark_result(name, &batched);
+
+    printf("\n%-12s %10s %12s %12s %12s\n", "Timer", "Anzahl", "ns/start", "ns/neustart", "ns/ablauf");
+
+    for(size_t i = 0; i < sizeof(BENCHMARK_TIMERS) / sizeof(BENCHMARK_TIMERS[0]); i++)
+    {
+        struct timer_result list;
+        struct timer_result wheel;
+
+        run_list_benchmark(BENCHMARK_TIMERS[i], &list);
+        if(run_wheel_benchmark(BENCHMARK_TIMERS[i], &wheel) < 0)
+        {
+            return -1;
+        }
+
+        print_timer_result("Liste", BENCHMARK_TIMERS[i], &list);
+        print_timer_result("Timer-Rad", BENCHMARK_TIMERS[i], &wheel);
+    }
+
+    return 0;
+}
@@ -3,65 +3,36 @@
 
 
 /**
- * Struktur: queue
- * ---------------------
- * Speichert die Pakete in der Warteschlange und notiert ob ein TIMEOUT registriert wurde.
- */
-struct queue 
-{
-    bool timeout;
-    bool recived;
-    struct request req;
-};
-
-
-/**
- * Funktion: shift_queue
- * ---------------------
- * Verschiebt die Elemente einer Warteschlange (`queue`) um eine Position nach vorne.
- * Das erste Element wird entfernt, und alle nachfolgenden Elemente werden einen Schritt 
- * nach vorne verschoben.
- *
- * Parameter:
- * - queue: Ein Pointer auf einen Pointer zur Warteschlange (Array von `queue`-Elementen).
- * - packages_in_queue: Anzahl der Elemente in der Warteschlange.
- *
- * Rückgabewert:
- * - Keiner (void).
- *
- * Beschreibung:
- * - Die Funktion überprüft die Gültigkeit der Eingaben und verschiebt die Elemente 
- *   der Warteschlange um eine Position nach vorne.
- * - Das erste Element der Warteschlange wird dabei "überschrieben", sodass Platz für ein neues Element frei wird.
- * - Die Funktion geht davon aus, dass die Warteschlange als Array von Strukturen implementiert ist.
- *
- * Einschränkungen:
- * - Die Funktion bearbeitet nur die ersten `packages_in_queue` Elemente im Array.
- * - Es wird nicht überprüft, ob genügend Speicherplatz im Array vorhanden ist.
+ * Funktion: checkpoint_path
+ * -------------------------
+ * Bildet den Pfad des Prüfpunkts neben der Zieldatei (Pfad der Datei mit CHECKPOINT_SUFFIX). 
+ * Mit --stripes hat jeder Streifen einen eigenen Prüfpunkt mit seinem Index als Endung.
  */
-void shift_queue(struct queue** queue, int queue_length)
+static void checkpoint_path(struct properties* props, char* path, size_t size, bool temporary)
 {
-    // Elemente verschieben
-    for(int i = 1; i < queue_length; i++)
+    if(props->stripes > 1)
     {
-        (*queue)[i - 1] = (*queue)[i]; // Verschiebe jedes Element um eine Position nach vorne
+        snprintf(path, size, "%s%s.%d%s", props->file_path, CHECKPOINT_SUFFIX, props->stripe, temporary ? ".tmp" : "");
+        return;
     }
 
-    memset(&((*queue)[queue_length-1]), 0, sizeof(struct queue));
+    snprintf(path, size, "%s%s%s", props->file_path, CHECKPOINT_SUFFIX, temporary ? ".tmp" : "");
 }
 
+
 /**
  * Funktion: open_file
  * --------------------
- * Überprüft, ob eine Datei existiert, und erstellt sie, wenn sie nicht existiert.
+ * Überprüft, ob eine Datei existiert, und erstellt sie, wenn sie nicht existiert. Liegt neben 
+ * einer existierenden Datei ein Prüfpunkt, wird sie zum Fortsetzen der Übertragung geöffnet.
  *
  * Parameter:
  * - props: Ein Pointer auf die Struktur `properties`, die den Dateipfad und 
  *          den Datei-Zeiger enthält.
  *
  * Rückgabewert:
- * - 0: Datei wurde erfolgreich erstellt.
- * - -1: Datei existiert bereits oder konnte nicht erstellt werden.
+ * - 0: Datei wurde erfolgreich erstellt oder wird fortgesetzt (`resume`).
+ * - -1: Datei existiert ohne Prüfpunkt bereits oder konnte nicht erstellt werden.
  */
 int open_file(struct properties* props)
 {
@@ -69,12 +40,30 @@ int open_file(struct properties* props)
     props->file = fopen(props->file_path, "r");
     if (props->file != NULL) 
     {
-        print_timestamp();
-        printf(RED "Die Datei existiert schon\n" RESET);
-
         fclose(props->file); // Sicherstellen, dass die Datei geschlossen wird
 
-        return -1;
+        char path[sizeof(props->file_path) + 16];
+        checkpoint_path(props, path, sizeof(path), false);
+        if(access(path, F_OK) < 0)
+        {
+            print_timestamp();
+            printf(RED "Die Datei existiert schon\n" RESET);
+            return -1;
+        }
+
+        // Ohne Kürzen öffnen, die schon geschriebenen Segmente bleiben erhalten
+        props->file = fopen(props->file_path, "r+");
+        if (props->file == NULL) 
+        {
+            print_timestamp();
+            printf(RED "Fehler beim Öffnen der Datei\n" RESET);
+            return -1;
+        }
+
+        props->resume = true;
+        print_timestamp();
+        printf(GREEN "Datei mit Prüfpunkt gefunden, Übertragung wird fortgesetzt\n" RESET);
+        return 0;
     }
 
     // Datei im Schreibmodus erstellen
@@ -93,97 +82,1844 @@ int open_file(struct properties* props)
 }
 
 
-void write_to_file(struct properties* props, char* line)
+/**
+ * Funktion: segment_map_index
+ * ---------------------------
+ * Bestimmt den Index eines Segments in der Bitmap aus seiner Byte-Position. Mit --stripes 
+ * enthält die Bitmap nur die Segmente des eigenen Streifens.
+ *
+ * Parameter:
+ * - map: Die Bitmap der geschriebenen Segmente.
+ * - offset: Byte-Position des Segments in der Datei.
+ *
+ * Rückgabewert:
+ * - Der Index (Paket-ID - 1), -1 wenn das Segment zu einem anderen Streifen gehört.
+ */
+static long long segment_map_index(struct segment_map* map, long long offset)
+{
+    long long segment = offset / map->segment_size;
+    if(segment % map->stripes != map->stripe)
+    {
+        return -1;
+    }
+
+    return segment / map->stripes;
+}
+
+
+/**
+ * Funktion: segment_map_has
+ * -------------------------
+ * Prüft, ob ein Segment schon geschrieben ist oder in der Schreibwarteschlange liegt.
+ *
+ * Parameter:
+ * - map: Die Bitmap der geschriebenen Segmente.
+ * - index: Index des Segments (Paket-ID - 1).
+ */
+static bool segment_map_has(struct segment_map* map, long long index)
 {
-    fprintf(props->file, "%s", line);
+    unsigned char bit = (unsigned char)(1 << (index % 8));
+    return (map->bits[index / 8] & bit) || (map->pending != NULL && (map->pending[index / 8] & bit));
 }
 
 
+#ifdef __linux__
 /**
- * Funktion: prepare_hello_package
- * -------------------------------
- * Erstellt ein "Hello"-Antwortpaket (`ANS_HELLO`) und speichert es 
- * in der `communication`-Struktur.
+ * Funktion: writer_write_batch
+ * ----------------------------
+ * Schreibt mit --uring den Auftrag `first` und alle weiteren wartenden Aufträge (bis zu 
+ * MAX_BATCH_SIZE) mit einem `io_uring_enter` und gibt sie über `done` zurück.
  *
  * Parameter:
- * - props: Ein Pointer auf die Struktur `properties`, die die ID des Senders enthält.
- * - com: Ein Pointer auf die Struktur `communication`, in der die Antwort gespeichert wird.
+ * - w: Der Schreib-Thread mit dem Ring.
+ * - first: Der schon aus `jobs` genommene Auftrag.
+ *
+ * Beschreibung:
+ * - Mit registriertem Pool schreibt der Kernel direkt aus den festen Puffern (WRITE_FIXED), 
+ *   ohne die Seiten bei jedem Auftrag neu anzuheften.
+ * - Aufträge zum Anhängen (Textmodus) bekommen in ihrer Reihenfolge feste Positionen hinter 
+ *   `append`, damit die Reihenfolge der Abschlüsse keine Rolle spielt.
+ * - Ein kurzer Schreibzugriff wird mit `pwrite` vervollständigt, ebenso Aufträge, die wegen 
+ *   eines Fehlers des Rings nicht übergeben wurden.
  */
-void prepare_hello_package(struct properties* props, struct communication* com)
+static void writer_write_batch(struct writer* w, const struct write_job* first)
 {
-    struct answer ans;         // Lokale Antwortstruktur erstellen
-    ans.senderId = props->id;  // Sender-ID setzen
-    ans.reciverId = com->req.senderId;  // Empfänger-ID setzen
-    ans.type = ANS_HELLO;      // Pakettyp auf "Hello" setzen
-    ans.packageId = 0;         // PacketId auf 0 setzen
+    struct write_job jobs[MAX_BATCH_SIZE];
+    int results[MAX_BATCH_SIZE];
+    int count = 1;
+    jobs[0] = *first;
+    while(count < MAX_BATCH_SIZE && spsc_ring_pop(&w->jobs, &jobs[count]))
+    {
+        count += 1;
+    }
 
-    com->ans = ans;            // Antwort in die Kommunikationsstruktur kopieren
+    int queued = 0;
+    for(int i = 0; i < count; i++)
+    {
+        if(jobs[i].offset < 0)
+        {
+            jobs[i].offset = w->append;
+            w->append += jobs[i].length;
+        }
+
+        struct io_uring_sqe* sqe = uring_get_sqe(&w->ring);
+        if(sqe == NULL)
+        {
+            results[i] = -EBUSY;
+            continue;
+        }
+
+        sqe->opcode = w->fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        sqe->fd = 0; // Feste Datei 0, die Zieldatei
+        sqe->flags = IOSQE_FIXED_FILE;
+        sqe->addr = (unsigned long long)(uintptr_t)jobs[i].data;
+        sqe->len = (unsigned int)jobs[i].length;
+        sqe->off = (unsigned long long)jobs[i].offset;
+        sqe->buf_index = 0;
+        sqe->user_data = (unsigned long long)i;
+        results[i] = 0;
+        queued += 1;
+    }
+
+    // Alle Aufträge übergeben und auf ihre Abschlüsse warten
+    int done = 0;
+    while(done < queued)
+    {
+        if(uring_submit(&w->ring, (unsigned int)(queued - done)) < 0)
+        {
+            // Ohne Ring weiter mit pwrite bzw. fwrite ab der bisherigen Position
+            print_timestamp();
+            printf(RED "Fehler bei io_uring_enter, der Schreib-Thread schreibt ohne io_uring weiter\n" RESET);
+            perror("\t\t");
+            uring_free(&w->ring);
+            fseeko(w->file, (off_t)w->append, SEEK_SET);
+            break;
+        }
+
+        struct io_uring_cqe* cqe;
+        while((cqe = uring_peek(&w->ring)) != NULL)
+        {
+            results[cqe->user_data] = cqe->res;
+            uring_seen(&w->ring);
+            done += 1;
+        }
+    }
+
+    int fd = fileno(w->file);
+    for(int i = 0; i < count; i++)
+    {
+        int written = results[i];
+        if(written >= 0 && written < jobs[i].length)
+        {
+            // Rest eines kurzen Schreibzugriffs, ein nicht übergebener Auftrag beginnt bei 0
+            ssize_t rest = pwrite(fd, jobs[i].data + written, (size_t)(jobs[i].length - written), (off_t)(jobs[i].offset + written));
+            written = rest == jobs[i].length - written ? jobs[i].length : -errno;
+        }
+
+        if(written < 0)
+        {
+            errno = -written;
+            print_timestamp();
+            printf(RED "Schreiben von %d Bytes fehlgeschlagen\n" RESET, jobs[i].length);
+            perror("\t\t");
+            jobs[i].length = -1;
+        }
+
+        spsc_ring_push(&w->done, &jobs[i]);
+    }
+
+    wakeup_signal(&w->network_wake);
 }
+#endif
+
+
+/**
+ * Funktion: run_writer
+ * --------------------
+ * Schreib-Thread des Clients mit --writequeue. Schreibt die Aufträge aus dem Ring `jobs` 
+ * in ihrer Reihenfolge in die Datei und gibt sie über `done` an den Empfangsthread zurück.
+ *
+ * Parameter:
+ * - arg: Pointer auf die `writer`-Struktur.
+ *
+ * Rückgabewert:
+ * - NULL.
+ *
+ * Beschreibung:
+ * - Es sind nie mehr als `bound` Aufträge unterwegs, `done` kann daher nicht überlaufen.
+ * - Der Thread endet erst, wenn `jobs` nach dem Setzen von `stop` leer ist.
+ */
+static void* run_writer(void* arg)
+{
+    struct writer* w = (struct writer*)arg;
 
+    while(true)
+    {
+        struct write_job job;
+        if(!spsc_ring_pop(&w->jobs, &job))
+        {
+            if(atomic_load(&w->stop))
+            {
+                break;
+            }
+
+            // Auf Aufträge warten, nach der Ankündigung wird der Ring noch einmal geprüft
+            wakeup_arm(&w->writer_wake);
+            if(spsc_ring_empty(&w->jobs) && !atomic_load(&w->stop))
+            {
+                struct pollfd pfd;
+                pfd.fd = w->writer_wake.read_fd;
+                pfd.events = POLLIN;
+                pfd.revents = 0;
+                poll(&pfd, 1, -1);
+            }
+            wakeup_drain(&w->writer_wake);
+            continue;
+        }
+
+#ifdef __linux__
+        if(w->ring.fd >= 0)
+        {
+            writer_write_batch(w, &job);
+            continue;
+        }
+#endif
+
+        bool written;
+        if(job.offset >= 0)
+        {
+            written = pwrite(fileno(w->file), job.data, (size_t)job.length, (off_t)job.offset) == job.length;
+        }
+        else
+        {
+            written = fwrite(job.data, 1, (size_t)job.length, w->file) == (size_t)job.length;
+        }
+
+        if(!written)
+        {
+            print_timestamp();
+            printf(RED "Schreiben von %d Bytes fehlgeschlagen\n" RESET, job.length);
+            perror("\t\t");
+            job.length = -1;
+        }
+
+        spsc_ring_push(&w->done, &job);
+        wakeup_signal(&w->network_wake);
+    }
+
+    return NULL;
+}
 
 
 /**
- * Funktion: prepare_nack_package
- * ------------------------------
- * Erstellt ein "Negative Acknowledgment"-Antwortpaket (`ANS_NACK`) und speichert 
- * es in der `communication`-Struktur. Zusätzlich wird die Paket-ID (`packageId`) 
- * angegeben, auf die sich das NACK bezieht.
+ * Funktion: writer_uring_init
+ * ---------------------------
+ * Legt für --uring den Ring des Schreib-Threads an und registriert die Zieldatei als feste 
+ * Datei 0. Ohne io_uring schreibt der Thread wie bisher mit `pwrite` bzw. `fwrite`.
  *
  * Parameter:
- * - props: Ein Pointer auf die Struktur `properties`, die die ID des Senders enthält.
- * - com: Ein Pointer auf die Struktur `communication`, in der die Antwort gespeichert wird.
- * - packageId: Die ID des Pakets, das nicht erfolgreich verarbeitet wurde.
+ * - w: Der Schreib-Thread, der noch nicht läuft.
+ *
+ * Beschreibung:
+ * - Gepufferte Daten der Datei werden vorher geschrieben. Angehängt wird danach ab der 
+ *   aktuellen Position (`append`), `writer_free` setzt die Datei wieder dahinter.
  */
-void prepare_nack_package(struct properties* props, struct communication* com, int packageId)
+static void writer_uring_init(struct writer* w)
 {
-    struct answer ans;            // Lokale Antwortstruktur erstellen
-    ans.senderId = props->id;     // Sender-ID setzen
-    ans.reciverId = com->req.senderId; // Setze EmpfängerID
-    ans.type = ANS_NACK;          // Pakettyp auf "NACK" setzen
-    ans.packageId = packageId;    // ID des betroffenen Pakets setzen
+    int fd = fileno(w->file);
+    fflush(w->file);
+    w->append = (long long)ftello(w->file);
+
+    if(w->append >= 0 && uring_init(&w->ring, MAX_BATCH_SIZE) == 0)
+    {
+#ifdef __linux__
+        if(uring_register(&w->ring, IORING_REGISTER_FILES, &fd, 1) == 0)
+        {
+            print_timestamp();
+            printf(GREEN "Schreib-Thread schreibt über io_uring\n" RESET);
+            return;
+        }
+#endif
+        uring_free(&w->ring);
+    }
+
+    print_timestamp();
+    printf(RED "io_uring nicht verfügbar, der Schreib-Thread verwendet pwrite und fwrite\n" RESET);
+    perror("\t\t");
+}
+
+
+/**
+ * Funktion: writer_init
+ * ---------------------
+ * Startet den Schreib-Thread für --writequeue. Pool und Bitmap werden mit dem Fenster 
+ * beim HELLO gesetzt.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties`, erhält den Schreib-Thread in `writer`.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 wenn Speicher, Ringe oder Thread nicht angelegt werden konnten.
+ */
+int writer_init(struct properties* props)
+{
+    struct writer* w = (struct writer*)calloc(1, sizeof(struct writer));
+    if(w == NULL)
+    {
+        print_timestamp();
+        printf(RED "Speicher für den Schreib-Thread konnte nicht reserviert werden\n" RESET);
+        return -1;
+    }
+
+    props->writer = w;
+    w->file = props->file;
+    w->bound = props->write_queue;
+    atomic_init(&w->stop, false);
+    w->writer_wake.read_fd = w->writer_wake.write_fd = -1;
+    w->network_wake.read_fd = w->network_wake.write_fd = -1;
+    w->ring.fd = -1;
+
+    if(wakeup_init(&w->writer_wake) < 0 || wakeup_init(&w->network_wake) < 0
+        || spsc_ring_init(&w->jobs, w->bound, sizeof(struct write_job)) < 0
+        || spsc_ring_init(&w->done, w->bound, sizeof(struct write_job)) < 0)
+    {
+        return -1;
+    }
+
+    if(props->uring)
+    {
+        writer_uring_init(w);
+    }
+
+    if(pthread_create(&w->thread, NULL, run_writer, w) != 0)
+    {
+        print_timestamp();
+        printf(RED "Schreib-Thread konnte nicht gestartet werden\n" RESET);
+        return -1;
+    }
+    w->started = true;
+
+    print_timestamp();
+    printf(GREEN "Schreib-Thread mit bis zu %d wartenden Paketen gestartet\n" RESET, w->bound);
+    return 0;
+}
+
+
+/**
+ * Funktion: writer_collect
+ * ------------------------
+ * Übernimmt die Rückmeldungen des Schreib-Threads: Die Puffer gehen an den Pool zurück und 
+ * geschriebene Segmente werden in der Bitmap gesetzt. Wartet nicht.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties` mit dem Schreib-Thread.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg oder ohne Schreib-Thread.
+ * - -1 wenn ein Schreibzugriff fehlgeschlagen ist.
+ */
+int writer_collect(struct properties* props)
+{
+    struct writer* w = props->writer;
+    if(w == NULL)
+    {
+        return 0;
+    }
+
+    struct write_job job;
+    while(spsc_ring_pop(&w->done, &job))
+    {
+        w->inflight -= 1;
+        packet_unref(w->pool, job.packet);
+
+        if(job.length < 0)
+        {
+            w->failed = true;
+            continue;
+        }
+
+        struct segment_map* map = w->map;
+        if(job.offset >= 0 && map != NULL && map->bits != NULL)
+        {
+            long long index = segment_map_index(map, job.offset);
+            unsigned char bit = (unsigned char)(1 << (index % 8));
+            map->pending[index / 8] &= (unsigned char)~bit;
+            if(!(map->bits[index / 8] & bit))
+            {
+                map->bits[index / 8] |= bit;
+                map->done += 1;
+            }
+        }
+    }
+
+    return w->failed ? -1 : 0;
+}
+
+
+/**
+ * Funktion: writer_wait
+ * ---------------------
+ * Wartet, bis höchstens `limit` Aufträge unterwegs sind.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties` mit dem Schreib-Thread.
+ * - limit: Erlaubte Anzahl noch nicht zurückgemeldeter Aufträge, 0 wartet auf alle.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg oder ohne Schreib-Thread.
+ * - -1 wenn ein Schreibzugriff fehlgeschlagen ist.
+ */
+static int writer_wait(struct properties* props, int limit)
+{
+    struct writer* w = props->writer;
+    if(w == NULL)
+    {
+        return 0;
+    }
+
+    int result = writer_collect(props);
+    while(w->inflight > limit)
+    {
+        // Auf Rückmeldungen warten, nach der Ankündigung wird der Ring noch einmal geprüft
+        wakeup_arm(&w->network_wake);
+        if(spsc_ring_empty(&w->done))
+        {
+            struct pollfd pfd;
+            pfd.fd = w->network_wake.read_fd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            poll(&pfd, 1, -1);
+        }
+        wakeup_drain(&w->network_wake);
+        result = writer_collect(props);
+    }
+
+    return result;
+}
+
+
+/**
+ * Funktion: writer_flush
+ * ----------------------
+ * Wartet, bis der Schreib-Thread alle Aufträge geschrieben hat, z. B. vor dem Freigeben 
+ * des Fensters oder der Prüfung der Bitmap.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties` mit dem Schreib-Thread.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg oder ohne Schreib-Thread.
+ * - -1 wenn ein Schreibzugriff fehlgeschlagen ist.
+ */
+int writer_flush(struct properties* props)
+{
+    return writer_wait(props, 0);
+}
+
+
+/**
+ * Funktion: writer_set_pool
+ * -------------------------
+ * Übergibt dem Schreib-Thread Pool und Bitmap des neuen Fensters. Mit --uring wird der 
+ * Speicher des Pools beim Ring registriert, eine Registrierung des alten Pools wird gelöst.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties` mit dem Schreib-Thread.
+ * - pool: Der Paketpool des Fensters.
+ * - map: Die Bitmap der geschriebenen Segmente.
+ *
+ * Beschreibung:
+ * - Der Schreib-Thread muss vorher mit `writer_flush` geleert sein, er greift dann bis zum 
+ *   nächsten Auftrag nicht auf den Ring zu.
+ * - Schlägt die Registrierung fehl (z. B. wegen RLIMIT_MEMLOCK), wird ohne feste Puffer 
+ *   geschrieben.
+ */
+void writer_set_pool(struct properties* props, struct packet_pool* pool, struct segment_map* map)
+{
+    struct writer* w = props->writer;
+    if(w == NULL)
+    {
+        return;
+    }
+
+#ifdef __linux__
+    if(w->ring.fd >= 0)
+    {
+        if(w->fixed)
+        {
+            uring_register(&w->ring, IORING_UNREGISTER_BUFFERS, NULL, 0);
+        }
+
+        struct iovec iov;
+        iov.iov_base = pool->memory;
+        iov.iov_len = (size_t)pool->count * (size_t)pool->buffer_size;
+        w->fixed = uring_register(&w->ring, IORING_REGISTER_BUFFERS, &iov, 1) == 0;
+        if(!w->fixed)
+        {
+            print_timestamp();
+            printf(RED "Paketpool konnte nicht beim Ring registriert werden\n" RESET);
+            perror("\t\t");
+        }
+    }
+#endif
+
+    w->pool = pool;
+    w->map = map;
+}
+
+
+/**
+ * Funktion: writer_submit
+ * -----------------------
+ * Übergibt Nutzdaten an den Schreib-Thread. Liegen sie in einem Puffer des Pools, wird nur 
+ * das Handle weitergegeben, sonst (aus der Parität wiederhergestellt) werden sie in einen 
+ * neuen Puffer kopiert.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties` mit dem Schreib-Thread.
+ * - packet: Puffer im Pool, der die Nutzdaten enthält, sonst PACKET_NONE.
+ * - data: Die Nutzdaten.
+ * - length: Länge der Nutzdaten in Bytes.
+ * - offset: Byte-Position in der Datei, -1 zum Anhängen.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 wenn ein Schreibzugriff fehlgeschlagen ist.
+ *
+ * Beschreibung:
+ * - Sind schon `bound` Aufträge unterwegs, wartet der Empfangsthread, bis der Schreib-Thread 
+ *   einen zurückmeldet. Der Socket wird dann nicht gelesen und die Verluste werden wie 
+ *   sonst per NACK repariert.
+ * - Ist der Pool erschöpft, wird nach dem Leeren der Warteschlange direkt geschrieben, 
+ *   damit die Reihenfolge im Textmodus erhalten bleibt.
+ */
+int writer_submit(struct properties* props, int packet, const char* data, int length, long long offset)
+{
+    struct writer* w = props->writer;
+
+    if(writer_wait(props, w->bound - 1) < 0)
+    {
+        return -1;
+    }
+
+    struct write_job job;
+    job.packet = packet;
+    job.length = length;
+    job.offset = offset;
+
+    if(packet == PACKET_NONE)
+    {
+        job.packet = packet_alloc(w->pool);
+        if(job.packet == PACKET_NONE)
+        {
+            if(writer_flush(props) < 0)
+            {
+                return -1;
+            }
+
+            // Mit --uring wird auch im Textmodus an die vom Schreib-Thread geführte Position geschrieben
+            if(offset < 0 && w->ring.fd >= 0)
+            {
+                offset = w->append;
+                w->append += length;
+            }
+
+            bool written = offset >= 0 
+                ? pwrite(fileno(w->file), data, (size_t)length, (off_t)offset) == length 
+                : fwrite(data, 1, (size_t)length, w->file) == (size_t)length;
+            return written ? 0 : -1;
+        }
+
+        job.data = packet_payload(w->pool, job.packet);
+        memcpy(job.data, data, (size_t)length);
+    }
+    else
+    {
+        packet_ref(w->pool, packet);
+        job.data = (char*)data;
+    }
+
+    spsc_ring_push(&w->jobs, &job);
+    w->inflight += 1;
+    wakeup_signal(&w->writer_wake);
+    return 0;
+}
+
+
+/**
+ * Funktion: writer_free
+ * ---------------------
+ * Schreibt alle wartenden Aufträge, beendet den Schreib-Thread und gibt ihn frei. Ein 
+ * Aufruf ohne Schreib-Thread ist unschädlich.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties` mit dem Schreib-Thread.
+ */
+void writer_free(struct properties* props)
+{
+    struct writer* w = props->writer;
+    if(w == NULL)
+    {
+        return;
+    }
+
+    if(w->started)
+    {
+        writer_flush(props);
+        atomic_store(&w->stop, true);
+        wakeup_notify(&w->writer_wake);
+        pthread_join(w->thread, NULL);
+    }
+
+    // Mit --uring steht die Datei noch vor den angehängten Daten
+    if(w->ring.fd >= 0)
+    {
+        uring_free(&w->ring);
+        fseeko(w->file, (off_t)w->append, SEEK_SET);
+    }
+
+    spsc_ring_free(&w->jobs);
+    spsc_ring_free(&w->done);
+    wakeup_free(&w->writer_wake);
+    wakeup_free(&w->network_wake);
+
+    free(w);
+    props->writer = NULL;
+}
+
+
+/**
+ * Funktion: write_to_file
+ * -----------------------
+ * Hängt die Nutzdaten eines Pakets (eine Zeile im Textmodus) an die Datei an. Binäre 
+ * Segmente kommen hier nicht an, sie werden schon beim Empfang mit `write_segment` geschrieben.
+ * Mit --writequeue übernimmt das der Schreib-Thread.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties` mit dem Datei-Zeiger.
+ * - slot: Die Kopfdaten des zu schreibenden Pakets.
+ * - data: Die Nutzdaten des Pakets (`packageLen` Bytes).
+ *
+ * Beschreibung:
+ * - Fehler des Schreib-Threads meldet `writer_collect` in der Zustandsmaschine.
+ */
+void write_to_file(struct properties* props, struct window_slot* slot, char* data)
+{
+    if(slot->packageLen <= 0)
+    {
+        return;
+    }
+
+    if(props->writer != NULL)
+    {
+        writer_submit(props, slot->packet, data, slot->packageLen, -1);
+        return;
+    }
+
+    fwrite(data, 1, slot->packageLen, props->file);
+}
+
+
+/**
+ * Funktion: segment_map_init
+ * --------------------------
+ * Legt die Bitmap der geschriebenen Segmente an und reserviert die Zieldatei in voller 
+ * Größe, damit Segmente in beliebiger Reihenfolge an ihre Position geschrieben werden können.
+ * Mit --stripes enthält die Bitmap nur die Segmente des eigenen Streifens.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties` mit dem Datei-Zeiger.
+ * - map: Die anzulegende Bitmap.
+ * - file_size: Größe der Datei laut HELLO, -1 wenn unbekannt.
+ * - segment_size: Nutzdaten pro Segment in Bytes.
+ * - file_hash: Prüfsumme der Datei laut HELLO, kennzeichnet den Prüfpunkt.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 wenn kein Speicher reserviert oder die Datei nicht vergrößert werden konnte.
+ *
+ * Beschreibung:
+ * - Ist die Dateigröße unbekannt, wird nichts reserviert. Die Datei wächst dann mit den 
+ *   Schreibzugriffen und die Vollständigkeit kann am Ende nicht geprüft werden.
+ */
+int segment_map_init(struct properties* props, struct segment_map* map, long long file_size, int segment_size, unsigned long long file_hash)
+{
+    map->file_size = file_size;
+    map->segment_size = segment_size;
+    map->count = 0;
+    map->done = 0;
+    map->bits = NULL;
+    map->pending = NULL;
+    map->file_hash = file_hash;
+    map->stripe = props->stripe;
+    map->stripes = props->stripes;
+
+    if(file_size <= 0 || segment_size <= 0)
+    {
+        return 0;
+    }
+
+    // Streifen k enthält die Segmente k, k + stripes, ...
+    long long segments = (file_size + segment_size - 1) / segment_size;
+    map->count = segments > map->stripe ? (segments - map->stripe + map->stripes - 1) / map->stripes : 0;
+    map->bits = calloc((size_t)((map->count + 7) / 8), 1);
+    if(props->writer != NULL)
+    {
+        map->pending = calloc((size_t)((map->count + 7) / 8), 1);
+    }
+
+    if(map->bits == NULL || (props->writer != NULL && map->pending == NULL))
+    {
+        print_timestamp();
+        printf(RED "Speicher für die Segmentbitmap konnte nicht reserviert werden\n" RESET);
+        return -1;
+    }
+
+    fflush(props->file);
+    int fd = fileno(props->file);
+
+#ifdef __linux__
+    // Blöcke sofort belegen, sonst wird die Datei beim Schreiben an beliebiger Stelle zerstückelt
+    posix_fallocate(fd, 0, (off_t)file_size);
+#endif
+
+    // Eine fortgesetzte Datei kann auch länger sein und wird dann gekürzt
+    if(ftruncate(fd, (off_t)file_size) < 0)
+    {
+        print_timestamp();
+        printf(RED "Datei konnte nicht auf %lld Bytes vergrößert werden\n" RESET, file_size);
+        perror("\t\t");
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/**
+ * Funktion: segment_map_free
+ * --------------------------
+ * Gibt die Bitmap frei. Ein mehrfacher Aufruf ist unschädlich.
+ *
+ * Parameter:
+ * - map: Die freizugebende Bitmap.
+ */
+void segment_map_free(struct segment_map* map)
+{
+    free(map->bits);
+    free(map->pending);
+    map->bits = NULL;
+    map->pending = NULL;
+    map->count = 0;
+    map->done = 0;
+}
+
+
+/**
+ * Funktion: write_segment
+ * -----------------------
+ * Schreibt ein binäres Segment sofort an seine Byte-Position in der Datei und merkt es 
+ * in der Bitmap vor. Auf fehlende Segmente davor wird nicht gewartet. Mit --writequeue 
+ * wird es nur an den Schreib-Thread übergeben und bis zur Rückmeldung in `pending` vorgemerkt.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties` mit dem Datei-Zeiger.
+ * - map: Die Bitmap der geschriebenen Segmente.
+ * - req: Die Kopfdaten des Segments.
+ * - data: Die Nutzdaten des Segments (`packageLen` Bytes).
+ * - packet: Puffer im Pool, der `data` enthält, sonst PACKET_NONE.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg oder wenn das Segment schon geschrieben war.
+ * - -1 wenn das Segment außerhalb der Datei liegt oder nicht geschrieben werden konnte.
+ */
+int write_segment(struct properties* props, struct segment_map* map, const struct request* req, const char* data, int packet)
+{
+    if(req->packageLen <= 0)
+    {
+        return 0;
+    }
+
+    if(req->offset < 0 || (map->file_size >= 0 && req->offset + req->packageLen > map->file_size))
+    {
+        print_timestamp();
+        printf(RED "Segment %d liegt außerhalb der Datei\n" RESET, req->packageId);
+        return -1;
+    }
+
+    long long index = segment_map_index(map, req->offset);
+    if(index < 0)
+    {
+        print_timestamp();
+        printf(RED "Segment %d gehört nicht zu Streifen %d\n" RESET, req->packageId, map->stripe);
+        return -1;
+    }
+
+    if(map->bits != NULL && segment_map_has(map, index))
+    {
+        return 0;
+    }
+
+    if(props->writer != NULL)
+    {
+        if(map->pending != NULL)
+        {
+            map->pending[index / 8] |= (unsigned char)(1 << (index % 8));
+        }
+        return writer_submit(props, packet, data, req->packageLen, req->offset);
+    }
+
+    if(pwrite(fileno(props->file), data, (size_t)req->packageLen, (off_t)req->offset) != req->packageLen)
+    {
+        print_timestamp();
+        printf(RED "Segment %d konnte nicht geschrieben werden\n" RESET, req->packageId);
+        perror("\t\t");
+        return -1;
+    }
+
+    if(map->bits != NULL)
+    {
+        map->bits[index / 8] |= (unsigned char)(1 << (index % 8));
+        map->done += 1;
+    }
+
+    return 0;
+}
+
+
+/**
+ * Funktion: print_segment_map
+ * ---------------------------
+ * Gibt aus, ob alle Segmente der Datei geschrieben wurden, und listet sonst die fehlenden auf.
+ *
+ * Parameter:
+ * - map: Die Bitmap der geschriebenen Segmente.
+ */
+void print_segment_map(struct segment_map* map)
+{
+    if(map->bits == NULL)
+    {
+        return;
+    }
+
+    print_timestamp();
+    if(map->done == map->count)
+    {
+        printf(GREEN "Alle %lld Segmente geschrieben\n" RESET, map->count);
+        return;
+    }
+
+    printf(RED "%lld von %lld Segmenten fehlen:" , map->count - map->done, map->count);
+    for(long long i = 0; i < map->count; i++)
+    {
+        if(!(map->bits[i / 8] & (1 << (i % 8))))
+        {
+            printf(" %lld", i * map->stripes + map->stripe); // Index des Segments in der Datei
+        }
+    }
+    printf("\n" RESET);
+}
+
+
+/**
+ * Funktion: checkpoint_put / checkpoint_get
+ * -----------------------------------------
+ * Schreiben bzw. lesen eine Zahl mit `bytes` Bytes in Netzwerk-Byte-Reihenfolge, wie auf 
+ * der Leitung, damit ein Prüfpunkt nicht von der Architektur abhängt.
+ */
+static void checkpoint_put(unsigned char* buffer, unsigned long long value, int bytes)
+{
+    for(int i = bytes - 1; i >= 0; i--)
+    {
+        buffer[i] = (unsigned char)(value & 0xFF);
+        value >>= 8;
+    }
+}
+
+static unsigned long long checkpoint_get(const unsigned char* buffer, int bytes)
+{
+    unsigned long long value = 0;
+    for(int i = 0; i < bytes; i++)
+    {
+        value = (value << 8) | buffer[i];
+    }
+    return value;
+}
+
+
+/**
+ * Funktion: checkpoint_save
+ * -------------------------
+ * Sichert die Bitmap der geschriebenen Segmente zusammen mit Prüfsumme, Dateigröße und 
+ * Segmentgröße als Prüfpunkt neben der Zieldatei. Der Prüfpunkt wird erst in eine temporäre 
+ * Datei geschrieben und dann umbenannt, ein Absturz hinterlässt also immer einen vollständigen.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties` mit dem Pfad der Zieldatei.
+ * - map: Die Bitmap der geschriebenen Segmente.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg oder wenn es keine Bitmap gibt.
+ * - -1 wenn der Prüfpunkt nicht geschrieben werden konnte.
+ *
+ * Beschreibung:
+ * - Die Segmente selbst werden nicht auf die Platte gezwungen. Nach einem Absturz des Clients 
+ *   liegen sie schon im Seitencache, nur nach einem Absturz des Systems kann der Prüfpunkt 
+ *   Segmente enthalten, die nie auf der Platte ankamen.
+ */
+int checkpoint_save(struct properties* props, struct segment_map* map)
+{
+    if(map->bits == NULL)
+    {
+        return 0;
+    }
+
+    char path[sizeof(props->file_path) + 16];
+    char temporary[sizeof(props->file_path) + 16];
+    checkpoint_path(props, path, sizeof(path), false);
+    checkpoint_path(props, temporary, sizeof(temporary), true);
+
+    unsigned char header[CHECKPOINT_HEADER_SIZE];
+    memcpy(header, CHECKPOINT_MAGIC, 8);
+    checkpoint_put(header + 8, map->file_hash, 8);
+    checkpoint_put(header + 16, (unsigned long long)map->file_size, 8);
+    checkpoint_put(header + 24, (unsigned long long)map->segment_size, 4);
+
+    size_t length = (size_t)((map->count + 7) / 8);
+    FILE* file = fopen(temporary, "w");
+    if(file == NULL
+        || fwrite(header, 1, sizeof(header), file) != sizeof(header)
+        || fwrite(map->bits, 1, length, file) != length
+        || fclose(file) != 0
+        || rename(temporary, path) < 0)
+    {
+        print_timestamp();
+        printf(RED "Prüfpunkt konnte nicht gespeichert werden\n" RESET);
+        perror("\t\t");
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/**
+ * Funktion: checkpoint_load
+ * -------------------------
+ * Übernimmt die Bitmap aus dem Prüfpunkt neben der Zieldatei, wenn er zur Übertragung laut 
+ * HELLO gehört (gleiche Prüfsumme, Dateigröße und Segmentgröße). Sonst bleibt die Bitmap 
+ * leer und die Datei wird vollständig neu geschrieben.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties` mit dem Pfad der Zieldatei.
+ * - map: Die frisch angelegte Bitmap mit den Werten aus dem HELLO.
+ *
+ * Rückgabewert:
+ * - 0 wenn der Prüfpunkt übernommen wurde.
+ * - -1 wenn er fehlt, unlesbar ist oder zu einer anderen Übertragung gehört.
+ */
+int checkpoint_load(struct properties* props, struct segment_map* map)
+{
+    if(map->bits == NULL)
+    {
+        return -1;
+    }
+
+    char path[sizeof(props->file_path) + 16];
+    checkpoint_path(props, path, sizeof(path), false);
+
+    unsigned char header[CHECKPOINT_HEADER_SIZE];
+    size_t length = (size_t)((map->count + 7) / 8);
+    bool valid = false;
+
+    FILE* file = fopen(path, "r");
+    if(file != NULL)
+    {
+        valid = fread(header, 1, sizeof(header), file) == sizeof(header)
+            && memcmp(header, CHECKPOINT_MAGIC, 8) == 0
+            && checkpoint_get(header + 8, 8) == map->file_hash
+            && (long long)checkpoint_get(header + 16, 8) == map->file_size
+            && (int)checkpoint_get(header + 24, 4) == map->segment_size
+            && fread(map->bits, 1, length, file) == length;
+        fclose(file);
+    }
+
+    if(!valid)
+    {
+        memset(map->bits, 0, length);
+        print_timestamp();
+        printf(RED "Prüfpunkt gehört nicht zu dieser Übertragung, Datei wird neu geschrieben\n" RESET);
+        return -1;
+    }
+
+    // Nur Bits vorhandener Segmente zählen, der Rest des letzten Bytes bleibt leer
+    map->done = 0;
+    for(long long i = 0; i < map->count; i++)
+    {
+        if(map->bits[i / 8] & (1 << (i % 8)))
+        {
+            map->done += 1;
+        }
+    }
+    if(map->count % 8 != 0)
+    {
+        map->bits[length - 1] &= (unsigned char)((1 << (map->count % 8)) - 1);
+    }
+
+    print_timestamp();
+    printf(GREEN "Prüfpunkt übernommen, %lld von %lld Segmenten sind schon geschrieben\n" RESET, map->done, map->count);
+    return 0;
+}
+
+
+/**
+ * Funktion: checkpoint_finish
+ * ---------------------------
+ * Löscht den Prüfpunkt, wenn alle Segmente geschrieben sind, und sichert sonst den letzten 
+ * Stand, damit ein Neustart die Übertragung fortsetzen kann.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties` mit dem Pfad der Zieldatei.
+ * - map: Die Bitmap der geschriebenen Segmente.
+ */
+void checkpoint_finish(struct properties* props, struct segment_map* map)
+{
+    if(map->bits == NULL)
+    {
+        return;
+    }
+
+    if(map->done < map->count)
+    {
+        if(props->checkpoint_interval > 0 && checkpoint_save(props, map) == 0)
+        {
+            print_timestamp();
+            printf(RED "Übertragung unvollständig, Prüfpunkt zum Fortsetzen gespeichert\n" RESET);
+        }
+        return;
+    }
+
+    char path[sizeof(props->file_path) + 16];
+    checkpoint_path(props, path, sizeof(path), false);
+    if(unlink(path) == 0)
+    {
+        print_timestamp();
+        printf(GREEN "Prüfpunkt gelöscht\n" RESET);
+    }
+}
+
+
+/**
+ * Funktion: prepare_hello_package
+ * -------------------------------
+ * Erstellt ein "Hello"-Antwortpaket (`ANS_HELLO`) und speichert es 
+ * in der `communication`-Struktur.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties`, die die ID des Senders enthält.
+ * - com: Ein Pointer auf die Struktur `communication`, in der die Antwort gespeichert wird.
+ * - join: Bestätigter Beitrittspunkt bei spätem Beitritt, sonst 0 (Anmeldung bzw. Bitte um Beitritt).
+ */
+void prepare_hello_package(struct properties* props, struct communication* com, int join)
+{
+    struct answer ans;         // Lokale Antwortstruktur erstellen
+    ans.senderId = props->id;  // Sender-ID setzen
+    ans.reciverId = com->req.senderId;  // Empfänger-ID setzen
+    ans.type = ANS_HELLO;      // Pakettyp auf "Hello" setzen
+    ans.packageId = join;      // Beitrittspunkt, 0 ohne späten Beitritt
+    ans.lossLen = 0;
+
+    com->ans = ans;            // Antwort in die Kommunikationsstruktur kopieren
+}
+
+
+
+/**
+ * Funktion: prepare_nack_package
+ * ------------------------------
+ * Erstellt ein "Negative Acknowledgment"-Antwortpaket (`ANS_NACK`) und speichert 
+ * es in der `communication`-Struktur. Zusätzlich wird die Paket-ID (`packageId`) 
+ * angegeben, auf die sich das NACK bezieht.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties`, die die ID des Senders enthält.
+ * - com: Ein Pointer auf die Struktur `communication`, in der die Antwort gespeichert wird.
+ * - packageId: Die ID des Pakets, das nicht erfolgreich verarbeitet wurde.
+ */
+void prepare_nack_package(struct properties* props, struct communication* com, int packageId)
+{
+    struct answer ans;            // Lokale Antwortstruktur erstellen
+    ans.senderId = props->id;     // Sender-ID setzen
+    ans.reciverId = com->req.senderId; // Setze EmpfängerID
+    ans.type = ANS_NACK;          // Pakettyp auf "NACK" setzen
+    ans.packageId = packageId;    // ID des betroffenen Pakets setzen
+    ans.lossLen = 0;              // Weitere fehlende Pakete trägt `send_nack` ein
+
+    com->ans = ans;               // Antwort in die Kommunikationsstruktur kopieren
+}
+
+
+
+/**
+ * Funktion: prepare_report_package
+ * --------------------------------
+ * Erstellt eine Meldung der Verlustrate (`ANS_REPORT`) an den Server. Die Verlustrate und 
+ * das Echo des Zeitstempels werden wie bei jeder Antwort beim Senden eingetragen.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties`, die die ID des Senders enthält.
+ * - com: Ein Pointer auf die Struktur `communication`, in der die Antwort gespeichert wird.
+ * - base: Die Basis-ID des Fensters.
+ */
+void prepare_report_package(struct properties* props, struct communication* com, int base)
+{
+    struct answer ans;            // Lokale Antwortstruktur erstellen
+    ans.senderId = props->id;     // Sender-ID setzen
+    ans.reciverId = com->req.senderId; // Setze EmpfängerID
+    ans.type = ANS_REPORT;        // Pakettyp auf "Report" setzen
+    ans.packageId = base;         // Erstes noch fehlendes Paket
+    ans.lossLen = 0;
+
+    com->ans = ans;               // Antwort in die Kommunikationsstruktur kopieren
+}
+
+
+
+/**
+ * Funktion: prepare_ack_package
+ * -----------------------------
+ * Erstellt eine kumulative Bestätigung (`ANS_ACK`) aller Pakete vor `base`.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties`, die die ID des Senders enthält.
+ * - com: Ein Pointer auf die Struktur `communication`, in der die Antwort gespeichert wird.
+ * - base: Die Basis-ID des Fensters, das erste noch nicht geschriebene Paket.
+ */
+void prepare_ack_package(struct properties* props, struct communication* com, int base)
+{
+    struct answer ans;            // Lokale Antwortstruktur erstellen
+    ans.senderId = props->id;     // Sender-ID setzen
+    ans.reciverId = com->req.senderId; // Setze EmpfängerID
+    ans.type = ANS_ACK;           // Pakettyp auf "ACK" setzen
+    ans.packageId = base;         // Alle Pakete davor liegen vor
+    ans.lossLen = 0;
+
+    com->ans = ans;               // Antwort in die Kommunikationsstruktur kopieren
+}
+
+
+
+/**
+ * Funktion: prepare_close_package
+ * -------------------------------
+ * Erstellt ein "Close"-Antwortpaket (`ANS_CLOSE`) und speichert es 
+ * in der `communication`-Struktur. Die Paket-ID bestätigt wie ein ACK auch das CLOSE-Paket selbst.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties`, die die ID des Senders enthält.
+ * - com: Ein Pointer auf die Struktur `communication`, in der die Antwort gespeichert wird.
+ */
+void prepare_close_package(struct properties* props, struct communication* com)
+{
+    struct answer ans;         // Lokale Antwortstruktur erstellen
+    ans.reciverId = com->req.senderId;  // Empfänger-ID setzen
+    ans.senderId = props->id;  // Sender-ID setzen
+    ans.type = ANS_CLOSE;      // Pakettyp auf "Close" setzen
+    ans.packageId = com->req.packageId + 1; // Alle Pakete bis einschließlich CLOSE liegen vor
+    ans.lossLen = 0;
+
+    com->ans = ans;            // Antwort in die Kommunikationsstruktur kopieren
+}
+
+
+
+/**
+ * Funktion: prepare_catchup_package
+ * ---------------------------------
+ * Erstellt nach spätem Beitritt eine Meldung des Aufholens (`ANS_CATCHUP`) mit dem ersten 
+ * fehlenden Segment vor `limit` und, wie ein NACK, der Bitmap der weiteren fehlenden. Reicht 
+ * die Bitmap nicht bis `limit`, hat sie immer die volle Länge NACK_BITMAP_SIZE, auch wenn das 
+ * nächste fehlende Segment weit dahinter liegt.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties`, die die ID des Senders enthält.
+ * - com: Ein Pointer auf die Struktur `communication`, in der die Antwort gespeichert wird.
+ * - map: Die Bitmap der geschriebenen Segmente.
+ * - next: Pointer auf das erste möglicherweise fehlende Segment, wird weitergezählt.
+ * - limit: Erstes Segment, das nicht mehr aufgeholt wird (Basis des Fensters bzw. CLOSE).
+ *
+ * Rückgabewert:
+ * - Das erste fehlende Segment, `limit` wenn keines mehr fehlt.
+ */
+int prepare_catchup_package(struct properties* props, struct communication* com, struct segment_map* map, int* next, int limit)
+{
+    // Segment i liegt im Bit i - 1, ohne Bitmap (Dateigröße unbekannt) gibt es nichts aufzuholen
+    while(*next < limit && (map->bits == NULL || *next > map->count || segment_map_has(map, *next - 1)))
+    {
+        *next += 1;
+    }
+
+    struct answer ans;            // Lokale Antwortstruktur erstellen
+    ans.senderId = props->id;     // Sender-ID setzen
+    ans.reciverId = com->req.senderId; // Setze EmpfängerID
+    ans.type = ANS_CATCHUP;       // Pakettyp auf "Catchup" setzen
+    ans.packageId = *next;        // Erstes fehlendes Segment
+    ans.lossLen = 0;
+
+    for(int id = *next + 1; id < limit && id <= map->count; id++)
+    {
+        if(!segment_map_has(map, id - 1) && !nack_mark_loss(&ans, id))
+        {
+            // Bitmap voll, der Rest folgt mit der nächsten Meldung. Die volle Länge zeigt dem 
+            // Server, dass hinter der Bitmap noch Segmente fehlen können
+            memset(ans.lossMap + ans.lossLen, 0, NACK_BITMAP_SIZE - ans.lossLen);
+            ans.lossLen = NACK_BITMAP_SIZE;
+            break;
+        }
+    }
+
+    com->ans = ans;               // Antwort in die Kommunikationsstruktur kopieren
+    return *next;
+}
+
+
+
+/**
+ * Funktion: advance_window
+ * ------------------------
+ * Schreibt alle ab `base` lückenlos vorhandenen Pakete in die Datei und verschiebt 
+ * das Fenster entsprechend weiter.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties`, die die Datei und Fenstergröße enthält.
+ * - window: Das Empfangsfenster.
+ * - base: Pointer auf die Basis-ID des Fensters, wird erhöht.
+ */
+void advance_window(struct properties* props, struct window* window, int* base)
+{
+    while(window_has(window, *base, WINDOW_RECEIVED))
+    {
+        // Der Schreib-Thread hält eine eigene Referenz, der Puffer bleibt bis zum Schreiben erhalten
+        write_to_file(props, window_get_slot(window, *base), window_get_payload(window, *base));
+        window_clear(window, *base);
+        *base += 1;
+    }
+}
+
+
+/**
+ * Funktion: mark_losses
+ * ---------------------
+ * Trägt alle Lücken zwischen `from` und `to`, die noch nicht angefordert wurden, in die 
+ * Verlust-Bitmap des NACKs in `com->ans` ein und markiert sie im Fenster als angefordert, 
+ * damit beim Aufrücken kein zweites NACK für sie gesendet wird.
+ *
+ * Parameter:
+ * - com: Ein Pointer auf die Struktur `communication` mit dem vorbereiteten NACK.
+ * - window: Das Empfangsfenster.
+ * - from: Erste zu prüfende Paket-ID.
+ * - to: Erste nicht mehr zu prüfende Paket-ID, höchstens das Ende des Fensters.
+ *
+ * Rückgabewert:
+ * - Anzahl der eingetragenen Pakete.
+ */
+int mark_losses(struct communication* com, struct window* window, int from, int to)
+{
+    int losses = 0;
+    for(int id = from; id < to; id++)
+    {
+        if(window_has(window, id, WINDOW_RECEIVED | WINDOW_TIMEOUT))
+        {
+            continue;
+        }
+
+        if(!nack_mark_loss(&com->ans, id))
+        {
+            break;
+        }
+
+        window_set(window, id, WINDOW_TIMEOUT);
+        losses += 1;
+    }
+
+    return losses;
+}
+
+
+/**
+ * Funktion: dispatch_nack
+ * -----------------------
+ * Sendet das vorbereitete NACK in `com->ans` sofort per Unicast an den Server oder plant 
+ * es mit --suppress für später ein. Geplante Pakete werden im Fenster vorgemerkt und nach 
+ * einer zufälligen Wartezeit gemeinsam von `send_pending_nacks` angefordert.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties`.
+ * - com: Ein Pointer auf die Struktur `communication` mit dem NACK und der Adresse des Servers.
+ * - window: Das Empfangsfenster.
+ * - losses: Anzahl der Pakete in der Verlust-Bitmap des NACKs.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg, -1 wenn das NACK nicht gesendet werden konnte.
+ */
+int dispatch_nack(struct properties* props, struct communication* com, struct window* window, int losses)
+{
+    if(props->group_size <= 0)
+    {
+        if(send_unicast(props, com)<0)
+        {
+            return -1;
+        }
+
+        print_timestamp();
+        printf(RED "Sende NACK für Paket %d und %d weitere\n" RESET, com->ans.packageId, losses);
+        return 0;
+    }
+
+    for(int id = com->ans.packageId; id >= 0; id = nack_next_loss(&com->ans, id))
+    {
+        window_set(window, id, WINDOW_PENDING);
+    }
+
+    if(props->nack_due == 0)
+    {
+        int backoff = nack_backoff_ms(props->group_size);
+        props->nack_due = get_time_us() + backoff * 1000LL;
+
+        print_timestamp();
+        printf(BLUE "NACK für Paket %d und %d weitere in %d ms geplant\n" RESET, com->ans.packageId, losses, backoff);
+    }
+
+    return 0;
+}
+
+
+/**
+ * Funktion: send_nack
+ * -------------------
+ * Sendet ein NACK für ein Paket, merkt sich im Fenster, dass für das Paket bereits ein 
+ * NACK gesendet wurde, und startet den Timer des Pakets neu. Alle weiteren Lücken bis 
+ * `highest_id`, die noch nicht angefordert wurden, werden in der Verlust-Bitmap desselben 
+ * NACKs mit angefordert.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties`.
+ * - com: Ein Pointer auf die Struktur `communication` mit der Adresse des Servers.
+ * - window: Das Empfangsfenster.
+ * - timers: Das Timer-Rad des Clients.
+ * - package_id: Die ID des fehlenden Pakets, immer die Basis des Fensters.
+ * - highest_id: Die höchste bisher empfangene Paket-ID, nur Pakete davor gelten als verloren.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg, -1 wenn das NACK nicht gesendet werden konnte.
+ */
+int send_nack(struct properties* props, struct communication* com, struct window* window, struct timer_wheel* timers, int package_id, int highest_id)
+{
+    window_set(window, package_id, WINDOW_TIMEOUT);
+    prepare_nack_package(props, com, package_id);
+
+    int end = package_id + props->windows_size;
+    int losses = mark_losses(com, window, package_id + 1, highest_id < end ? highest_id : end);
+
+    timer_wheel_add(timers, package_id, nack_timeout_ms(props));
+
+    return dispatch_nack(props, com, window, losses);
+}
+
+
+/**
+ * Funktion: send_loss_nack
+ * ------------------------
+ * Fordert neu entstandene Lücken hinter `base` an, während für `base` selbst schon ein NACK 
+ * läuft. Es wird kein Timer gestartet: Die Pakete werden wie `base` einmal angefordert und 
+ * erst ausgelassen, wenn sie als Basis des Fensters ohne Wiederholung ablaufen.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties`.
+ * - com: Ein Pointer auf die Struktur `communication` mit der Adresse des Servers.
+ * - window: Das Empfangsfenster.
+ * - base: Die Basis-ID des Fensters.
+ * - highest_id: Die höchste bisher empfangene Paket-ID, nur Pakete davor gelten als verloren.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg oder ohne neue Lücke, -1 wenn das NACK nicht gesendet werden konnte.
+ */
+int send_loss_nack(struct properties* props, struct communication* com, struct window* window, int base, int highest_id)
+{
+    int end = base + props->windows_size;
+    if(highest_id < end)
+    {
+        end = highest_id;
+    }
+
+    // Erste noch nicht angeforderte Lücke wird die Paket-ID des NACKs
+    int first = base + 1;
+    while(first < end && window_has(window, first, WINDOW_RECEIVED | WINDOW_TIMEOUT))
+    {
+        first += 1;
+    }
+
+    if(first >= end)
+    {
+        return 0;
+    }
+
+    window_set(window, first, WINDOW_TIMEOUT);
+    prepare_nack_package(props, com, first);
+    int losses = mark_losses(com, window, first + 1, end);
+
+    return dispatch_nack(props, com, window, losses);
+}
+
+
+/**
+ * Funktion: send_pending_nacks
+ * ----------------------------
+ * Sendet nach Ablauf der Wartezeit (--suppress) ein NACK für alle geplanten Pakete, die 
+ * weder empfangen noch von einem anderen Client angefordert wurden. Das NACK geht per 
+ * Unicast an den Server und per Multicast an die anderen Clients.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties`.
+ * - com: Ein Pointer auf die Struktur `communication` mit der Adresse des Servers.
+ * - window: Das Empfangsfenster.
+ * - base: Die Basis-ID des Fensters.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg oder wenn alle geplanten NACKs unterdrückt wurden.
+ * - -1 wenn das NACK nicht gesendet werden konnte.
+ */
+int send_pending_nacks(struct properties* props, struct communication* com, struct window* window, int base)
+{
+    props->nack_due = 0;
+
+    int first = -1;
+    int losses = 0;
+    for(int id = base; id < base + props->windows_size; id++)
+    {
+        if(!window_has(window, id, WINDOW_PENDING))
+        {
+            continue;
+        }
+
+        if(first < 0)
+        {
+            first = id;
+            prepare_nack_package(props, com, id);
+        }
+        else if(!nack_mark_loss(&com->ans, id))
+        {
+            // Passt nicht mehr ins NACK und wird beim nächsten Mal gesendet
+            props->nack_due = get_time_us();
+            break;
+        }
+        else
+        {
+            losses += 1;
+        }
+
+        window_unset(window, id, WINDOW_PENDING);
+    }
+
+    if(first < 0)
+    {
+        print_timestamp();
+        printf(GREEN "Alle geplanten NACKs wurden unterdrückt\n" RESET);
+        return 0;
+    }
+
+    if(send_unicast(props, com) < 0 || send_multicast(props, com) < 0)
+    {
+        return -1;
+    }
+
+    print_timestamp();
+    printf(RED "Sende NACK für Paket %d und %d weitere\n" RESET, com->ans.packageId, losses);
+    return 0;
+}
+
+
+/**
+ * Funktion: handle_peer_nack
+ * --------------------------
+ * Verarbeitet ein mitgehörtes NACK eines anderen Clients (--suppress). Pakete, die darin 
+ * angefordert werden, gelten auch für diesen Client als angefordert: Geplante eigene NACKs 
+ * für sie werden verworfen, die Wiederholung kommt per Multicast auch hier an.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties`.
+ * - com: Ein Pointer auf die Struktur `communication` mit dem NACK in `ans`.
+ * - window: Das Empfangsfenster.
+ * - base: Die Basis-ID des Fensters.
+ */
+void handle_peer_nack(struct properties* props, struct communication* com, struct window* window, int base)
+{
+    int suppressed = 0;
+    for(int id = com->ans.packageId; id >= 0; id = nack_next_loss(&com->ans, id))
+    {
+        if(id < base || id >= base + props->windows_size || window_has(window, id, WINDOW_RECEIVED))
+        {
+            continue;
+        }
+
+        if(window_has(window, id, WINDOW_PENDING))
+        {
+            window_unset(window, id, WINDOW_PENDING);
+            suppressed += 1;
+        }
+
+        window_set(window, id, WINDOW_TIMEOUT);
+    }
+
+    print_timestamp();
+    printf(GREEN "NACK von Empfänger mit ID %d für Paket %d mitgehört, %d eigene unterdrückt\n" RESET, com->ans.senderId, com->ans.packageId, suppressed);
+}
+
+
+/**
+ * Funktion: skip_package
+ * ----------------------
+ * Markiert das Paket `base`, auf dessen NACK nicht reagiert wurde, als verloren, 
+ * schreibt die folgenden vorhandenen Pakete und fordert bei Bedarf das nächste fehlende Paket an.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties`.
+ * - com: Ein Pointer auf die Struktur `communication` mit der Adresse des Servers.
+ * - window: Das Empfangsfenster.
+ * - base: Pointer auf die Basis-ID des Fensters.
+ * - timers: Das Timer-Rad des Clients.
+ * - highest_id: Die höchste bisher empfangene Paket-ID.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg, -1 wenn ein NACK nicht gesendet werden konnte.
+ */
+int skip_package(struct properties* props, struct communication* com, struct window* window, int* base, struct timer_wheel* timers, int highest_id)
+{
+    print_timestamp();
+    printf(RED "Paket %d wird ausgelassen!\n" RESET, *base);
+
+    // Hier wird ein Paket auf desen Nack nicht reagiert wurde als verloren markiert
+    // Im Textmodus wird eine leere Zeile geschrieben, im Binärmodus bleibt eine Lücke
+    struct window_slot* slot = window_get_slot(window, *base);
+    slot->type = props->binary ? REQ_SEGMENT : REQ_DATA;
+    slot->packageLen = 0;
+    if(!props->binary)
+    {
+        char* payload = window_reserve(window, *base);
+        if(payload != NULL)
+        {
+            payload[0] = '\n';
+            slot->packageLen = 1;
+        }
+    }
+    window_set(window, *base, WINDOW_USED | WINDOW_RECEIVED);
+
+    timer_wheel_del(timers, *base);
+
+    // Fenster verschieben
+    advance_window(props, window, base);
+    
+    // Stimmt immer noch nicht
+    if(highest_id > *base)
+    {
+        return send_nack(props, com, window, timers, *base, highest_id);
+    }
+
+    timer_wheel_add(timers, *base, nack_timeout_ms(props));
+    return 0;
+}
+
+
+/**
+ * Funktion: store_package
+ * -----------------------
+ * Übernimmt ein empfangenes Paket in das Fenster. Zeilen werden gepuffert, bis sie der 
+ * Reihe nach geschrieben werden können, binäre Segmente sofort an ihre Position geschrieben. 
+ * Im Fenster bleiben von Segmenten nur die Kopfdaten, damit `advance_window` nichts mehr schreibt.
+ * Danach wird das Paket in die Parität seines FEC-Streifens eingerechnet.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties`.
+ * - com: Ein Pointer auf die Struktur `communication` mit dem empfangenen Paket.
+ * - window: Das Empfangsfenster.
+ * - segments: Die Bitmap der geschriebenen Segmente.
+ * - fec: Die FEC-Streifen der Blöcke im Fenster.
+ *
+ * Beschreibung:
+ * - Eine Zeile ohne Puffer aus dem Pool (wiederhergestellt aus der Parität) wird in einen 
+ *   eigenen Puffer des Fensters kopiert, da die Parität danach verändert wird.
+ */
+void store_package(struct properties* props, struct communication* com, struct window* window, struct segment_map* segments, struct fec* fec)
+{
+    const char* payload = com->payload != NULL ? com->payload : com->req.data;
+
+    if(com->req.type == REQ_SEGMENT)
+    {
+        write_segment(props, segments, &com->req, payload, com->packet);
+        window_store(window, &com->req, PACKET_NONE);
+    }
+    else if(com->packet == PACKET_NONE)
+    {
+        char* data = window_reserve(window, com->req.packageId);
+        if(data != NULL)
+        {
+            memcpy(data, payload, com->req.packageLen);
+        }
+        window_store(window, &com->req, PACKET_NONE);
+    }
+    else
+    {
+        window_store(window, &com->req, com->packet);
+    }
+
+    window_set(window, com->req.packageId, WINDOW_RECEIVED);
+
+    if(fec->source > 0)
+    {
+        fec_add_source(fec, &com->req, payload);
+    }
+}
+
+
+/**
+ * Funktion: handle_data_package
+ * -----------------------------
+ * Verarbeitet ein empfangenes Datenpaket: Pakete im Fenster werden mit `store_package` 
+ * übernommen, das Fenster wird verschoben und bei einer Lücke ein NACK für `base` gesendet.
+ * Mit FEC werden nur Lücken in bereits abgeschlossenen Blöcken angefordert, Lücken im Block 
+ * des empfangenen Pakets können noch aus dessen Parität wiederhergestellt werden.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties`.
+ * - com: Ein Pointer auf die Struktur `communication` mit dem empfangenen Paket.
+ * - window: Das Empfangsfenster.
+ * - base: Pointer auf die Basis-ID des Fensters.
+ * - timers: Das Timer-Rad des Clients.
+ * - segments: Die Bitmap der geschriebenen Segmente.
+ * - fec: Die FEC-Streifen der Blöcke im Fenster.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg, -1 wenn ein NACK nicht gesendet werden konnte.
+ *
+ * Beschreibung:
+ * - Wurde für `base` bereits ein NACK gesendet, wird auf die Wiederholung oder den Timeout
+ *   gewartet. Da der Server mehrere Pakete direkt hintereinander sendet, würde das nächste 
+ *   Paket der Lücke sonst vor der Wiederholung ankommen.
+ */
+int handle_data_package(struct properties* props, struct communication* com, struct window* window, int* base, struct timer_wheel* timers, struct segment_map* segments, struct fec* fec)
+{
+    print_timestamp();
+    printf(GREEN "Erwarte Paket %d, erhalten %d\n" RESET, *base, com->req.packageId);
+
+    if(com->req.packageId == *base)
+    {
+        if(!window_has(window, *base, WINDOW_RECEIVED))
+        {
+            store_package(props, com, window, segments, fec);
+        }
+
+        timer_wheel_del(timers, *base);
+
+        // Fenster verschieben
+        advance_window(props, window, base);
+
+        timer_wheel_add(timers, *base, nack_timeout_ms(props));
+    }
+    else if(com->req.packageId > *base)
+    {   
+        // Puffern wenn es ins  Fenster passt
+        if(com->req.packageId < *base + props->windows_size && !window_has(window, com->req.packageId, WINDOW_RECEIVED))
+        {
+            store_package(props, com, window, segments, fec);
+        }
+
+        // Mit FEC gelten nur Pakete vor dem Block des empfangenen Pakets als verloren
+        int limit = fec->source > 0 ? fec_block_start(fec, com->req.packageId) : com->req.packageId;
+        if(*base >= limit)
+        {
+            return 0;
+        }
+
+        // Wenn erster Timeout vorliegt dann NACK senden
+        if(!window_has(window, *base, WINDOW_TIMEOUT))
+        {
+            return send_nack(props, com, window, timers, *base, limit);
+        }
+
+        // Für `base` läuft bereits ein NACK, neue Lücken dahinter sofort anfordern
+        return send_loss_nack(props, com, window, *base, limit);
+    }
+    else
+    {
+        print_timestamp();
+        printf("Paket %d kleiner Base wird ignoriert.\n", com->req.packageId);
+    }
+
+    return 0;
+}
+
+
+/**
+ * Funktion: recover_package
+ * -------------------------
+ * Stellt das einzige fehlende Paket im FEC-Streifen von `package_id` aus der Parität wieder 
+ * her und verarbeitet es wie ein empfangenes Paket.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties`.
+ * - com: Ein Pointer auf die Struktur `communication`, `req` wird überschrieben.
+ * - window: Das Empfangsfenster.
+ * - base: Pointer auf die Basis-ID des Fensters.
+ * - timers: Das Timer-Rad des Clients.
+ * - segments: Die Bitmap der geschriebenen Segmente.
+ * - fec: Die FEC-Streifen der Blöcke im Fenster.
+ * - package_id: Eine Paket-ID des Streifens.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg oder wenn nichts wiederhergestellt werden kann.
+ * - -1 wenn ein NACK nicht gesendet werden konnte.
+ */
+int recover_package(struct properties* props, struct communication* com, struct window* window, int* base, struct timer_wheel* timers, struct segment_map* segments, struct fec* fec, int package_id)
+{
+    // Blöcke außerhalb des Fensters würden einen belegten Platz im Ring der FEC-Blöcke leeren
+    int block_start = fec->source > 0 ? fec_block_start(fec, package_id) : 0;
+    if(fec->source == 0 || block_start + fec->source <= *base || block_start >= *base + props->windows_size)
+    {
+        return 0;
+    }
+
+    char* payload;
+    int id = fec_recover(fec, package_id, &com->req, &payload);
+    if(id < *base || id >= *base + props->windows_size || window_has(window, id, WINDOW_RECEIVED))
+    {
+        return 0;
+    }
+
+    com->req.type = props->binary ? REQ_SEGMENT : REQ_DATA;
+    com->req.offset = props->binary ? segment_offset(props, id) : 0;
+    com->packet = PACKET_NONE;
+    com->payload = payload;
+
+    print_timestamp();
+    printf(GREEN "Paket %d aus Parität wiederhergestellt\n" RESET, id);
+
+    return handle_data_package(props, com, window, base, timers, segments, fec);
+}
+
+
+/**
+ * Funktion: handle_parity_package
+ * -------------------------------
+ * Rechnet ein empfangenes Paritätspaket in seinen Streifen ein und stellt, wenn möglich, 
+ * das fehlende Paket des Streifens wieder her. Parität für Blöcke außerhalb des Fensters 
+ * wird ignoriert, damit sie keinen Platz im Ring der FEC-Blöcke belegt.
+ *
+ * Parameter: wie `recover_package`, `com` enthält das Paritätspaket.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg, -1 wenn ein NACK nicht gesendet werden konnte.
+ */
+int handle_parity_package(struct properties* props, struct communication* com, struct window* window, int* base, struct timer_wheel* timers, struct segment_map* segments, struct fec* fec)
+{
+    int block_start = fec->source > 0 ? fec_block_start(fec, com->req.packageId) : 0;
+    if(fec->source == 0 || block_start + fec->source <= *base || block_start >= *base + props->windows_size)
+    {
+        return 0;
+    }
 
-    com->ans = ans;               // Antwort in die Kommunikationsstruktur kopieren
-}
+    fec_add_parity(fec, &com->req, com->payload != NULL ? com->payload : com->req.data);
 
+    return recover_package(props, com, window, base, timers, segments, fec, com->req.packageId);
+}
 
 
 /**
- * Funktion: prepare_close_package
- * -------------------------------
- * Erstellt ein "Close"-Antwortpaket (`ANS_CLOSE`) und speichert es 
- * in der `communication`-Struktur.
+ * Funktion: handle_timeout
+ * ------------------------
+ * Reagiert auf den abgelaufenen Timer von `base`. Beim ersten Timeout wird ein NACK 
+ * gesendet, wurde bereits ein NACK gesendet, wird das Paket ausgelassen.
  *
  * Parameter:
- * - props: Ein Pointer auf die Struktur `properties`, die die ID des Senders enthält.
- * - com: Ein Pointer auf die Struktur `communication`, in der die Antwort gespeichert wird.
+ * - props: Ein Pointer auf die Struktur `properties`.
+ * - com: Ein Pointer auf die Struktur `communication` mit der Adresse des Servers.
+ * - window: Das Empfangsfenster.
+ * - base: Pointer auf die Basis-ID des Fensters.
+ * - timers: Das Timer-Rad des Clients.
+ * - timeout_package_id: Die ID des Pakets, dessen Timer abgelaufen ist.
+ * - highest_id: Die höchste bisher empfangene Paket-ID.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg, -1 wenn ein NACK nicht gesendet werden konnte.
  */
-void prepare_close_package(struct properties* props, struct communication* com)
+int handle_timeout(struct properties* props, struct communication* com, struct window* window, int* base, struct timer_wheel* timers, int timeout_package_id, int highest_id)
 {
-    struct answer ans;         // Lokale Antwortstruktur erstellen
-    ans.reciverId = com->req.senderId;  // Empfänger-ID setzen
-    ans.senderId = props->id;  // Sender-ID setzen
-    ans.type = ANS_CLOSE;      // Pakettyp auf "Close" setzen
+    print_timestamp();
+    printf(RED "Paket %d TIMEOUT\n" RESET, *base);
 
-    com->ans = ans;            // Antwort in die Kommunikationsstruktur kopieren
-}
+    if(!window_has(window, *base, WINDOW_TIMEOUT))
+    {
+        return send_nack(props, com, window, timers, timeout_package_id, highest_id);
+    }
 
+    return skip_package(props, com, window, base, timers, highest_id);
+}
 
 
+/**
+ * Funktion: run_state_machine
+ * ---------------------------
+ * Implementiert die Zustandsmaschine des Clients. Jede Iteration wartet in 
+ * `event_loop_wait` auf Pakete oder den nächsten Zeitschlitz und verarbeitet danach 
+ * alle wartenden Pakete und abgelaufenen Timer.
+ *
+ * Parameter:
+ * - props: Pointer auf die `properties`-Struktur mit Client-Informationen.
+ */
 void run_state_machine(struct properties* props) 
 {
     // Lokale Variablen initialisieren
     struct communication com;               // Kommunikation: Anfragen und Antworten
         
-    struct queue* queue = NULL;             // Warteschlange für zu sendende Pakete
-    int packages_in_queue;                  // Anzahl der Pakete in der Warteschlange
+    struct window window = {0};             // Empfangsfenster als Ringpuffer
     int base;                               // Basis-ID des aktuellen Fensters
-
-    struct linked_list_timer* timer_list;   // Timer-Liste zur Verwaltung von Timeouts
+    int highest_id = 0;                     // Höchste bisher empfangene Paket-ID
+
+    struct timer_wheel timers = {0};        // Timer-Rad zur Verwaltung von Timeouts
+    struct segment_map segments = {0};      // Bereits geschriebene Segmente im Binärmodus
+    struct fec fec = {0};                   // Parität der Blöcke im Fenster (--fec des Servers)
+    struct loss_history losses;             // Verlustintervalle für die Verlustrate (--congestion des Servers)
+    long long report_due = 0;               // Zeitpunkt der nächsten Meldung der Verlustrate in µs
+    int acked = 1;                          // Zuletzt per ACK bestätigte Basis-ID
+    long long ack_due = 0;                  // Spätester Zeitpunkt des nächsten ACKs in µs
+    struct sockaddr_in6 server_addr;        // Adresse des Servers, mitgehörte NACKs überschreiben `com.partner`
+    int join = 1;                           // Erstes Paket per Multicast, davor wird nach spätem Beitritt aufgeholt
+    long long join_due = 0;                 // Frühester Zeitpunkt der nächsten Bitte um Beitritt in µs
+    int catchup_next = 1;                   // Erstes möglicherweise noch fehlendes Segment vor `join`
+    long long catchup_due = 0;              // Zeitpunkt der nächsten Meldung des Aufholens in µs
+    long long catchup_heard = 0;            // Empfang des letzten aufgeholten Segments in µs
+    int close_id = 0;                       // ID des CLOSE, solange nach dessen Empfang noch aufgeholt wird
+    long long checkpoint_due = 0;           // Frühester Zeitpunkt des nächsten Prüfpunkts in µs
+    long long checkpoint_done = -1;         // Anzahl geschriebener Segmente im letzten Prüfpunkt
+    struct event_loop loop;                 // Ereignisschleife für Socket und Zeitschlitze
     
     // Startzustand setzen
     connection_state state = STATE_INIT;   // Initialzustand
     bool running = true;                   // Steuerung der Hauptschleife
 
+    // Zufällige Wartezeiten vor NACKs müssen sich zwischen den Clients unterscheiden
+    srand(time(NULL) ^ props->id);
+
+    if(event_loop_init(&loop, props, DEFAULT_SLOT_TIME) < 0)
+    {
+        running = false;
+    }
+
+    // Mit --writequeue schreibt ein eigener Thread, der Empfang wartet nicht auf die Festplatte
+    if(running && props->write_queue > 0 && writer_init(props) < 0)
+    {
+        running = false;
+    }
 
     // Hauptschleife der Zustandsmaschine
     while(running) 
@@ -196,10 +1932,11 @@ void run_state_machine(struct properties* props)
                 com.req.type = '0';
 
                 // Variablen initialisieren
-                packages_in_queue = 0;
                 base = 1;
-
-                timer_list = NULL; // Timer-Liste initialisieren
+                highest_id = 0;
+                acked = 1;
+                join = 1;
+                close_id = 0;
 
                 // Zustand wechseln
                 print_timestamp();
@@ -210,235 +1947,382 @@ void run_state_machine(struct properties* props)
 
             case STATE_IDLE:
             {
-                if(receive_cast(props, &com, NULL)) // Paket empfangen
+                int ticks = 0;
+                if(event_loop_wait(&loop, -1, &ticks) < 0)
+                {
+                    running = false;
+                    break;
+                }
+
+                int result;
+                while((result = receive_cast(props, &com, NULL)) > 0) // Paket empfangen
                 {
-                    if(com.req.type == REQ_HELLO)
+                    // Segmente einer laufenden Übertragung: um späten Beitritt bitten
+                    if(com.kind == WIRE_KIND_REQUEST && com.req.type == REQ_SEGMENT && get_time_us() >= join_due)
+                    {
+                        prepare_hello_package(props, &com, 0);
+                        if(send_unicast(props, &com) < 0)
+                        {
+                            running = false;
+                            break;
+                        }
+
+                        join_due = get_time_us() + DEFAULT_JOIN_INTERVAL * 1000LL;
+                        print_timestamp();
+                        printf("Übertragung läuft bereits, bitte um Beitritt\n");
+                        continue;
+                    }
+
+                    if(com.kind == WIRE_KIND_REQUEST && com.req.type == REQ_HELLO)
                     {
+                        if(com.req.packageLen < 1 || com.req.packageLen > MAX_WINDOW_SIZE || com.req.offset < 0 || com.req.offset > MAX_PAYLOAD_SIZE
+                            || com.req.groupSize < 0 || com.req.groupSize > MAX_GROUP_SIZE
+                            || com.req.fecSource < 0 || com.req.fecSource > MAX_FEC_SOURCE
+                            || (com.req.fecSource > 0 && (com.req.fecParity < 1 || com.req.fecParity > com.req.fecSource))
+                            || com.req.packageId < 0 || (com.req.packageId > 0 && com.req.offset == 0))
+                        {
+                            print_timestamp();
+                            printf(RED "Ungültiges HELLO ignoriert\n" RESET);
+                            continue;
+                        }
+
+                        // Mit --stripes gehört jede Übertragung zu genau einem Streifen der Datei
+                        if(com.req.stripe != props->stripe || com.req.stripes != props->stripes || (props->stripes > 1 && com.req.offset == 0))
+                        {
+                            print_timestamp();
+                            printf(RED "HELLO für Streifen %d von %d ignoriert, erwartet Streifen %d von %d im Binärmodus\n" RESET, 
+                                com.req.stripe, com.req.stripes, props->stripe, props->stripes);
+                            continue;
+                        }
+
                         props->windows_size = com.req.packageLen;
-                        queue = malloc(sizeof(struct queue) * props->windows_size);
-                        memset(queue, 0, sizeof(struct queue)*props->windows_size);
+                        props->binary = com.req.offset > 0;
+                        props->segment_size = (int)com.req.offset;
+                        props->group_size = com.req.groupSize;
+                        props->fec_source = com.req.fecSource;
+                        props->fec_parity = com.req.fecParity;
+                        props->nack_due = 0;
+                        props->loss_rate = 0;
+                        loss_history_init(&losses);
+                        server_addr = com.partner;
+
+                        // Später Beitritt: Das Fenster beginnt am Beitrittspunkt, alles davor wird aufgeholt
+                        join = com.req.packageId > 0 ? com.req.packageId : 1;
+                        base = join;
+                        highest_id = join - 1;
+                        acked = join;
+                        losses.highest = join - 1;
+                        catchup_next = 1;
+                        catchup_due = 0;
+                        catchup_heard = get_time_us();
+
+                        if(join > 1)
+                        {
+                            print_timestamp();
+                            printf(GREEN "Später Beitritt bei Paket %d, %d Segmente werden aufgeholt\n" RESET, join, join - 1);
+                        }
+
+                        if(props->binary)
+                        {
+                            print_timestamp();
+                            printf(GREEN "Binärmodus mit %d Bytes pro Segment\n" RESET, props->segment_size);
+                        }
+
+                        if(props->group_size > 0)
+                        {
+                            print_timestamp();
+                            printf(GREEN "NACK-Unterdrückung für %d Empfänger, höchstens %d ms Wartezeit\n" RESET, props->group_size, nack_backoff_max_ms(props->group_size));
+                        }
+
+                        if(props->fec_source > 0)
+                        {
+                            print_timestamp();
+                            printf(GREEN "FEC mit %d Paritätspaketen je %d Paketen\n" RESET, props->fec_parity, props->fec_source);
+                        }
+
+                        // Wartende Aufträge halten noch Puffer des alten Fensters
+                        if(writer_flush(props) < 0)
+                        {
+                            running = false;
+                            break;
+                        }
+
+                        transport_attach_pool(props, NULL);
+                        window_free(&window);
+                        timer_wheel_free(&timers);
+                        segment_map_free(&segments);
+                        fec_free(&fec);
+
+                        // Im Binärmodus werden Segmente sofort geschrieben und nicht im Fenster gehalten
+                        if(window_init(&window, props->windows_size, props->binary ? props->segment_size : DEFAULT_DATA_BUFFER_SIZE, !props->binary, 0) < 0 
+                            || timer_wheel_init(&timers, window.capacity) < 0
+                            || (props->binary && segment_map_init(props, &segments, com.req.fileSize, props->segment_size, com.req.fileHash) < 0)
+                            || (props->fec_source > 0 && fec_init(&fec, props->fec_source, props->fec_parity, window.payload_size, window.capacity / props->fec_source + 2) < 0))
+                        {
+                            running = false;
+                            break;
+                        }
+
+                        writer_set_pool(props, &window.pool, &segments);
+
+                        // Fortsetzen braucht die Bitmap, also den Binärmodus mit bekannter Dateigröße
+                        if(props->resume && segments.bits == NULL)
+                        {
+                            print_timestamp();
+                            printf(RED "Fortsetzen nur im Binärmodus mit bekannter Dateigröße möglich\n" RESET);
+                            running = false;
+                            break;
+                        }
+
+                        if(props->resume)
+                        {
+                            checkpoint_load(props, &segments);
+                        }
+                        checkpoint_due = 0;
+                        checkpoint_done = -1;
+
+                        // Ab jetzt direkt in Puffer des Fensters empfangen
+                        transport_attach_pool(props, &window.pool);
 
                         print_timestamp();
                         printf("Wechsel zu STATE_PREPARE\n");
                         state = STATE_PREPARE;
+                        break;
                     }
                 }
+
+                if(result < 0)
+                {
+                    running = false;
+                }
                 
                 break;
             }
 
             case STATE_PREPARE:
             {
-                prepare_hello_package(props, &com);
+                prepare_hello_package(props, &com, join > 1 ? join : 0);
                 if(send_unicast(props, &com)<0)
                 {
                     running = false;
                 }
 
+                event_loop_reset(&loop);
+
                 print_timestamp();
                 printf("Wechsel zu STATE_ESTABLISHED\n");
                 state = STATE_ESTABLISHED;
                 break;
             }
 
-            // Bisschen Kacke geschrieben alles ngl, könnte mit Funktionen besser werden
             case STATE_ESTABLISHED:
             {                  
-                int timeout_package_id = tick_timer_linked_list_timer(&timer_list);
-              
-                if(com.req.type == REQ_DATA)
+                // Warten auf Pakete, den nächsten Zeitschlitz, den nächsten Timer, geplante NACKs, ACKs oder Meldungen
+                int wait_ms = -1;
+                if(props->nack_due > 0)
                 {
-                    print_timestamp();
-                    printf(GREEN "Erwarte Paket %d, erhalten %d\n" RESET, base, com.req.packageId);
+                    long long due_us = props->nack_due - get_time_us();
+                    wait_ms = due_us > 0 ? (int)((due_us + 999) / 1000) : 0;
+                }
+                if(base > acked)
+                {
+                    long long due_us = ack_due - get_time_us();
+                    int ack_ms = due_us > 0 ? (int)((due_us + 999) / 1000) : 0;
+                    wait_ms = (wait_ms < 0 || ack_ms < wait_ms) ? ack_ms : wait_ms;
+                }
+                if(props->loss_rate > 0)
+                {
+                    long long due_us = report_due - get_time_us();
+                    int report_ms = due_us > 0 ? (int)((due_us + 999) / 1000) : 0;
+                    wait_ms = (wait_ms < 0 || report_ms < wait_ms) ? report_ms : wait_ms;
+                }
+                if(join > 1 && catchup_next < (close_id > 0 ? close_id : base))
+                {
+                    long long due_us = catchup_due - get_time_us();
+                    int catchup_ms = due_us > 0 ? (int)((due_us + 999) / 1000) : 0;
+                    wait_ms = (wait_ms < 0 || catchup_ms < wait_ms) ? catchup_ms : wait_ms;
+                }
 
-                    if(com.req.packageId == base)
-                    {
-                        if(!queue[0].recived)
-                        {
-                            queue[0].req = com.req;
-                            queue[0].recived = true;
-                        }
+                int ticks = 0;
+                if(event_loop_wait(&loop, timer_wheel_wait_ms(&timers, wait_ms), &ticks) < 0)
+                {
+                    running = false;
+                    break;
+                }
 
-                        del_timer_linked_list_timer(&timer_list, base);
+                // Alle wartenden Pakete verarbeiten
+                int result = 0;
+                while(running && (result = receive_cast(props, &com, NULL)) > 0)
+                {
+                    if(com.kind == WIRE_KIND_ANSWER)
+                    {
+                        handle_peer_nack(props, &com, &window, base);
+                        com.partner = server_addr;
+                        continue;
+                    }
 
-                        // Fenster verschieben
-                        while(queue[0].recived)
+                    if(com.req.type == REQ_PARITY)
+                    {
+                        if(handle_parity_package(props, &com, &window, &base, &timers, &segments, &fec) < 0)
                         {
-                            write_to_file(props, queue[0].req.data);
-                            shift_queue(&queue, props->windows_size);
-                            base += 1;
+                            running = false;
                         }
-
-                        del_timer_linked_list_timer(&timer_list, base);
-                        add_timer_linked_list_timer(&timer_list, base, MAX_ALLOWED_CLIENTS);
+                        continue;
                     }
-                    else if(com.req.packageId > base)
-                    {   
-                        // Puffern wenn es ins  Fenster passt
-                        if(com.req.packageId < base + props->windows_size && com.req.packageId >= base)
-                        {
-                            queue[com.req.packageId - base].req = com.req;
-                            queue[com.req.packageId - base].timeout = false;
-                            queue[com.req.packageId - base].recived = true;
-                        }
 
-                        // Wenn erster Timeout vorliegt dann NACK senden
-                        if(!queue[0].timeout)
+                    // Segmente vor dem Beitrittspunkt kommen beim Aufholen und werden direkt geschrieben
+                    if(com.req.type == REQ_SEGMENT && com.req.packageId < join)
+                    {
+                        catchup_heard = get_time_us();
+                        if(write_segment(props, &segments, &com.req, com.payload != NULL ? com.payload : com.req.data, com.packet) < 0)
                         {
-                            queue[0].timeout = true;
-                            prepare_nack_package(props, &com, base);
-
-                            del_timer_linked_list_timer(&timer_list, base);
-                            add_timer_linked_list_timer(&timer_list, base, MAX_ALLOWED_CLIENTS);
-
-                            if(send_unicast(props, &com)<0)
-                            {
-                                running = false;
-                            }
-
-                            print_timestamp();
-                            printf(RED "Sende NACK für Paket %d\n" RESET, com.ans.packageId);
+                            running = false;
                         }
-                        else
-                        {
-                            print_timestamp();
-                            printf(RED "Paket %d wird ausgelassen!\n" RESET, base);
-
-                            // Hier wird ein Paket auf desen Nack nicht reagiert wurde als verloren markiert
-                            queue[0].req.type = REQ_DATA;
-                            queue[0].req.data[0] = '\n';
-                            queue[0].req.packageLen = 0;
-                            queue[0].recived = true;
+                        continue;
+                    }
 
-                            del_timer_linked_list_timer(&timer_list, base);
+                    if(com.req.type != REQ_DATA && com.req.type != REQ_SEGMENT && com.req.type != REQ_CLOSE)
+                    {
+                        continue;
+                    }
 
-                            // Fenster verschieben
-                            while(queue[0].recived)
-                            {
-                                write_to_file(props, queue[0].req.data);
-                                shift_queue(&queue, props->windows_size);
-                                base += 1;
-                            }
-                            
-                            // Stimmt immer noch nicht
-                            if(com.req.packageId > base)
-                            {
-                                queue[0].timeout = true;
-                                prepare_nack_package(props, &com, base);
-                                del_timer_linked_list_timer(&timer_list, base);
-                                add_timer_linked_list_timer(&timer_list, base, MAX_ALLOWED_CLIENTS);
-
-                                if(send_unicast(props, &com)<0)
-                                {
-                                    running = false;
-                                }
-
-                                print_timestamp();
-                                printf(RED "Sende NACK für Paket %d\n" RESET, com.ans.packageId);
-                            }
-                            else
-                            {
-                                del_timer_linked_list_timer(&timer_list, base);
-                                add_timer_linked_list_timer(&timer_list, base, MAX_ALLOWED_CLIENTS);
-                            }
-                        }                        
+                    if(com.req.packageId > highest_id)
+                    {
+                        highest_id = com.req.packageId;
                     }
-                    else
+
+                    // Lücken hinter der höchsten ID gehen in die Verlustrate ein, auch wenn sie später repariert werden
+                    if(loss_history_add(&losses, com.req.packageId, props->rto))
                     {
-                        printf("Paket %d kleiner Base wird ignoriert.\n", com.ans.packageId);
+                        props->loss_rate = loss_event_rate(&losses);
+                        print_timestamp();
+                        printf(RED "Verlustereignis bei Paket %d, Verlustrate %.4f\n" RESET, losses.event_start, props->loss_rate);
                     }
-                }
-                else if(timeout_package_id > 0)
-                {
-                    print_timestamp();
-                    printf(RED "Paket %d TIMEOUT\n" RESET, base);
-                    if(!queue[0].timeout)
+                    else if(losses.event_start > 0)
                     {
-                        queue[0].timeout = true;
-                        prepare_nack_package(props, &com, timeout_package_id);
-                        del_timer_linked_list_timer(&timer_list, timeout_package_id);
-                        add_timer_linked_list_timer(&timer_list, timeout_package_id, MAX_ALLOWED_CLIENTS);
-
-                        if(send_unicast(props, &com)<0)
-                        {
-                            running = false;
-                        }
+                        props->loss_rate = loss_event_rate(&losses);
+                    }
 
+                    if(com.req.type == REQ_CLOSE)
+                    {
                         print_timestamp();
-                        printf(RED "Sende NACK für Paket %d\n" RESET, com.ans.packageId);
+                        printf("Wechsel zu STATE_CLOSE\n");
+                        state = STATE_CLOSE;
+                        break;
                     }
-                    else
+
+                    // Danach kann der Streifen des Pakets ein verlorenes Paket wiederherstellen
+                    int package_id = com.req.packageId;
+                    if(handle_data_package(props, &com, &window, &base, &timers, &segments, &fec) < 0
+                        || recover_package(props, &com, &window, &base, &timers, &segments, &fec, package_id) < 0)
                     {
-                        print_timestamp();
-                        printf(RED "Paket %d wird ausgelassen!\n" RESET, timeout_package_id);
+                        running = false;
+                    }
+                }
 
-                        // Hier wird ein Paket auf desen Nack nicht reagiert wurde als verloren markiert
-                        queue[0].req.type = REQ_DATA;
-                        queue[0].req.data[0] = '\n';
-                        queue[0].req.packageLen = 0;
-                        queue[0].recived = true;
+                // Geschriebene Pakete des Schreib-Threads übernehmen
+                if(result < 0 || writer_collect(props) < 0)
+                {
+                    running = false;
+                }
 
-                        del_timer_linked_list_timer(&timer_list, base);
+                // Abgelaufene Timer verwalten
+                if(running && state == STATE_ESTABLISHED)
+                {
+                    timer_wheel_advance(&timers);
 
-                        // Fenster verschieben
-                        while(queue[0].recived)
-                        {
-                            write_to_file(props, queue[0].req.data);
-                            shift_queue(&queue, props->windows_size);
-                            base += 1;
-                        }
-                        
-                        // Stimmt immer noch nicht
-                        if(com.req.packageId > base)
-                        {
-                            queue[0].timeout = true;
-                            prepare_nack_package(props, &com, base);
-                            del_timer_linked_list_timer(&timer_list, base);
-                            add_timer_linked_list_timer(&timer_list, base, MAX_ALLOWED_CLIENTS);
+                    int timeout_package_id = timer_wheel_expire(&timers);
+                    if(timeout_package_id <= 0 && ticks > 0)
+                    {
+                        print_timestamp();
+                        printf(RED "Kein TIMEOUT\n" RESET);
+                    }
 
-                            if(send_unicast(props, &com)<0)
+                    while(timeout_package_id > 0)
+                    {
+                        // Ein Timeout für ein bereits geschriebenes Paket ist hinfällig
+                        if(timeout_package_id >= base)
+                        {
+                            if(handle_timeout(props, &com, &window, &base, &timers, timeout_package_id, highest_id) < 0)
                             {
                                 running = false;
                             }
-
-                            print_timestamp();
-                            printf(RED "Sende NACK für Paket %d\n" RESET, com.ans.packageId);
-                        }
-                        else
-                        {
-                            del_timer_linked_list_timer(&timer_list, base);
-                            add_timer_linked_list_timer(&timer_list, base, MAX_ALLOWED_CLIENTS);
                         }
+
+                        timeout_package_id = timer_wheel_expire(&timers);
                     }
-                
-                    
                 }
-                else
+
+                // Geplante NACKs senden, die nicht von anderen Clients vorweggenommen wurden
+                if(running && state == STATE_ESTABLISHED && props->nack_due > 0 && get_time_us() >= props->nack_due)
                 {
-                    print_timestamp();
-                    printf(RED "Kein TIMEOUT\n" RESET);
+                    if(send_pending_nacks(props, &com, &window, base) < 0)
+                    {
+                        running = false;
+                    }
                 }
 
-                print_timestamp();
-                print_timer_linked_list_timer(&timer_list); // Timer anzeigen
+                // Nach DEFAULT_ACK_INTERVAL Paketen (höchstens einem Viertel des Fensters) oder spätestens 
+                // nach einem RTO bestätigen, damit der Server sein Fenster ohne Timeout verschieben kann
+                int ack_every = props->windows_size / 4 < 1 ? 1 : (props->windows_size / 4 > DEFAULT_ACK_INTERVAL ? DEFAULT_ACK_INTERVAL : props->windows_size / 4);
+                if(running && state == STATE_ESTABLISHED && base > acked && (base - acked >= ack_every || get_time_us() >= ack_due))
+                {
+                    prepare_ack_package(props, &com, base);
+                    if(send_unicast(props, &com) < 0)
+                    {
+                        running = false;
+                    }
+                    acked = base;
+                    ack_due = get_time_us() + props->rto * 1000LL;
+                }
 
-                com.ans.type = '0';
-                com.req.type = '0';
-            
-                // Empfang von Paketen
-                if(receive_cast(props, &com, NULL) < 0)
+                // Verlustrate regelmäßig melden, damit der Server seine Senderate anpassen kann
+                if(running && state == STATE_ESTABLISHED && props->loss_rate > 0 && get_time_us() >= report_due)
                 {
-                    running = false;
+                    prepare_report_package(props, &com, base);
+                    if(send_unicast(props, &com) < 0)
+                    {
+                        running = false;
+                    }
+                    report_due = get_time_us() + DEFAULT_REPORT_INTERVAL * 1000LL;
+                }
+
+                // Nach spätem Beitritt regelmäßig die noch fehlenden Segmente melden, einmal auch, 
+                // dass vor dem Beitrittspunkt nichts mehr fehlt, damit der Server das Aufholen beendet
+                int catchup_limit = close_id > 0 ? close_id : base;
+                if(running && join > 1 && catchup_next < catchup_limit && get_time_us() >= catchup_due)
+                {
+                    int catchup_from = catchup_next;
+                    if((prepare_catchup_package(props, &com, &segments, &catchup_next, catchup_limit) < catchup_limit || catchup_from < join) 
+                        && send_unicast(props, &com) < 0)
+                    {
+                        running = false;
+                    }
+                    catchup_due = get_time_us() + DEFAULT_REPORT_INTERVAL * 1000LL;
+                }
+
+                // Empfangsstand regelmäßig sichern, ein Neustart fordert dann nur die fehlenden Segmente an
+                if(running && props->checkpoint_interval > 0 && segments.bits != NULL && segments.done != checkpoint_done && get_time_us() >= checkpoint_due)
+                {
+                    checkpoint_save(props, &segments);
+                    checkpoint_done = segments.done;
+                    checkpoint_due = get_time_us() + props->checkpoint_interval * 1000LL;
                 }
 
-                if(com.req.type == REQ_CLOSE)
+                // Nach dem CLOSE erst schließen, wenn alles aufgeholt ist oder der Server nichts mehr sendet
+                if(running && close_id > 0 && (catchup_next >= close_id || get_time_us() - catchup_heard > DEFAULT_CATCHUP_TIMEOUT * 1000LL))
                 {
+                    com.req.type = REQ_CLOSE;
+                    com.req.packageId = close_id;
+                    close_id = 0;
                     print_timestamp();
                     printf("Wechsel zu STATE_CLOSE\n");
                     state = STATE_CLOSE;
-                    break;
                 }
 
+                print_timestamp();
+                print_timer_wheel(&timers); // Timer anzeigen
+
                 break;
             }
 
@@ -452,9 +2336,24 @@ void run_state_machine(struct properties* props)
                     break; 
                 }
 
+                // Nach spätem Beitritt fehlende Segmente vor dem Schließen aufholen
+                if(join > 1 && prepare_catchup_package(props, &com, &segments, &catchup_next, com.req.packageId) < com.req.packageId
+                    && get_time_us() - catchup_heard <= DEFAULT_CATCHUP_TIMEOUT * 1000LL)
+                {
+                    close_id = com.req.packageId;
+                    print_timestamp();
+                    printf("CLOSE erhalten, warte auf Aufholen ab Segment %d\n", catchup_next);
+                    state = STATE_ESTABLISHED;
+                    break;
+                }
+
                 prepare_close_package(props, &com);
                 send_unicast(props, &com);
 
+                // Erst nach dem Schreiben aller Aufträge ist die Bitmap vollständig
+                writer_flush(props);
+                print_segment_map(&segments);
+
                 running = false;
 
                 break;
@@ -462,8 +2361,19 @@ void run_state_machine(struct properties* props)
         }
     }
 
+    // Wartende Aufträge schreiben, danach ist die Bitmap für den Prüfpunkt aktuell
+    writer_free(props);
+
+    // Prüfpunkt löschen bzw. den letzten Stand sichern
+    checkpoint_finish(props, &segments);
+
     // Ressourcen freigeben
-    free(queue);
+    transport_attach_pool(props, NULL);
+    window_free(&window);
+    timer_wheel_free(&timers);
+    segment_map_free(&segments);
+    fec_free(&fec);
+    event_loop_close(&loop);
     close_socket(props);
     print_timestamp();
     printf("Programm wird beendet\n");
@@ -472,6 +2382,95 @@ void run_state_machine(struct properties* props)
 
 
 
+/**
+ * Funktion: run_stripe
+ * --------------------
+ * Thread eines Streifens (--stripes): Erstellt den Socket des Streifens und führt die 
+ * Zustandsmaschine aus.
+ *
+ * Parameter:
+ * - arg: Pointer auf die `properties`-Struktur des Streifens.
+ *
+ * Rückgabewert:
+ * - NULL.
+ */
+static void* run_stripe(void* arg)
+{
+    struct properties* props = (struct properties*)arg;
+
+    if(start_socket(props) < 0)
+    {
+        close_socket(props);
+        return NULL;
+    }
+
+    run_state_machine(props);
+    close_socket(props);
+    return NULL;
+}
+
+
+/**
+ * Funktion: run_stripes
+ * ---------------------
+ * Empfängt die Datei mit --stripes über mehrere Übertragungen gleichzeitig. Jeder Streifen 
+ * läuft in einem eigenen Thread mit eigenem Socket, Fenster und eigener Bitmap, alle 
+ * schreiben ihre Segmente mit pwrite an ihre Position in dieselbe Datei.
+ *
+ * Parameter:
+ * - props: Eigenschaften der Kommandozeile mit der geöffneten Datei.
+ *
+ * Rückgabewert:
+ * - 0: Alle Streifen wurden gestartet und sind beendet.
+ * - -1: Fehler beim Starten eines Streifens.
+ */
+int run_stripes(struct properties* props)
+{
+    struct properties* stripes = (struct properties*)calloc(props->stripes, sizeof(struct properties));
+    pthread_t* threads = (pthread_t*)calloc(props->stripes, sizeof(pthread_t));
+    if(stripes == NULL || threads == NULL)
+    {
+        free(stripes);
+        free(threads);
+        return -1;
+    }
+
+    int result = 0;
+    int created = 0;
+    for(; created < props->stripes; created++)
+    {
+        stripes[created] = *props;
+        if(stripe_properties(&stripes[created], created) < 0)
+        {
+            result = -1;
+            break;
+        }
+
+        if(pthread_create(&threads[created], NULL, run_stripe, &stripes[created]) != 0)
+        {
+            print_timestamp();
+            printf(RED "Thread für Streifen %d konnte nicht gestartet werden\n" RESET, created);
+            result = -1;
+            break;
+        }
+    }
+
+    print_timestamp();
+    printf(BLUE "%d von %d Streifen gestartet\n" RESET, created, props->stripes);
+
+    for(int k = 0; k < created; k++)
+    {
+        pthread_join(threads[k], NULL);
+    }
+
+    free(threads);
+    free(stripes);
+    return result;
+}
+
+
+
+
 int main(int argc, char* argv[]) 
 {       
     struct properties props; 
@@ -485,7 +2484,8 @@ int main(int argc, char* argv[])
         return -1;
     }
 
-    if(start_socket(&props)<0)
+    // Mit --stripes erstellt jeder Streifen in seinem Thread einen eigenen Socket
+    if(props.stripes <= 1 && start_socket(&props)<0)
     {  
         print_timestamp();
         printf("Programm wird beendet\n");
@@ -507,7 +2507,14 @@ int main(int argc, char* argv[])
     }
 
 
-    run_state_machine(&props);
+    if(props.stripes > 1)
+    {
+        run_stripes(&props);
+    }
+    else
+    {
+        run_state_machine(&props);
+    }
 
     
     fclose(props.file);
@@ -20,23 +20,25 @@
 **  - Keiner (void)
 **
 ** Beschreibung:
-** Diese Funktion verwendet die Systemfunktionen `gettimeofday` und `localtime`, um die
+** Diese Funktion verwendet die Systemfunktionen `gettimeofday` und `localtime_r`, um die
 ** aktuelle Zeit bis auf Millisekunden genau zu ermitteln und auf die Konsole auszugeben.
 **
 ** Besonderheiten:
 ** - `gettimeofday` liefert die aktuelle Zeit in Sekunden und Mikrosekunden.
-** - `localtime` wandelt die Sekunden in eine lokale Zeitstruktur um.
+** - `localtime_r` wandelt die Sekunden in eine lokale Zeitstruktur um, ohne einen gemeinsamen 
+**   Puffer zu benutzen, und darf damit aus mehreren Threads (--sessions) aufgerufen werden.
 */
 void print_timestamp() 
 {
     struct timeval tv;         // Struktur, um Zeit mit Sekunden und Mikrosekunden zu speichern
-    struct tm *timeinfo;       // Struktur, um die lokale Zeit zu speichern
+    struct tm local;           // Struktur, um die lokale Zeit zu speichern
+    struct tm *timeinfo = &local;
 
     // Aktuelle Zeit mit Mikrosekunden abrufen
     gettimeofday(&tv, NULL);
 
     // Sekundenwert in lokale Zeit umwandeln
-    timeinfo = localtime(&tv.tv_sec);
+    localtime_r(&tv.tv_sec, &local);
 
     // Uhrzeit mit Millisekunden formatieren und ausgeben
     printf("%02d:%02d:%02d.%03d\t", 
@@ -47,6 +49,30 @@ void print_timestamp()
 }
 
 
+/* 
+** get_time_us
+** ------------
+** Liefert die Zeit einer monotonen Uhr in Mikrosekunden.
+**
+** Parameter:
+**  - Keine
+**
+** Rückgabewert:
+**  - Zeit in Mikrosekunden seit einem beliebigen, festen Startpunkt
+**
+** Beschreibung:
+** Im Gegensatz zu `gettimeofday` springt `CLOCK_MONOTONIC` nicht bei Änderungen der
+** Systemzeit. Die Funktion eignet sich daher für Zeitschlitze und die Senderate.
+*/
+long long get_time_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+
 /* 
 ** setup_properties
 ** -----------------
@@ -73,6 +99,40 @@ int setup_properties(int argc, char** argv, struct properties* props)
     // Initialisieren von Standardwerten für die properties-Struktur
     props->sockfd = -1;                 // Dateideskriptor initialisieren, -1 bedeutet "nicht gesetzt"
     props->local = 0;                   // Standardwert für "local" ist false (0)
+    props->loop = false;                // Standardwert für "loop" ist false
+    props->batch_size = DEFAULT_BATCH_SIZE; // Standardanzahl an Datagrammen pro Systemaufruf
+    props->uring = false;               // Standardmäßig sendmmsg/recvmmsg und stdio
+    props->binary = false;              // Standardmäßig zeilenweise Übertragung
+    props->mtu = 0;                     // MTU wird von der Schnittstelle abgefragt
+    props->use_mmap = false;            // Standardmäßig mit stdio lesen
+    props->pipeline = false;            // Standardmäßig alles in einem Thread
+    props->map = NULL;
+    props->map_size = 0;
+    props->map_pos = 0;
+    props->file_size = -1;              // Wird beim Öffnen der Datei ermittelt
+    props->file_hash = 0;               // Wird im Binärmodus nach dem Öffnen berechnet
+    props->resume = false;              // Wird beim Anlegen der Zieldatei erkannt
+    props->checkpoint_interval = DEFAULT_CHECKPOINT_INTERVAL; // Standardmäßig regelmäßige Prüfpunkte
+    props->write_queue = 0;             // Standardmäßig im Empfangsthread schreiben
+    props->writer = NULL;               // Wird erst mit der Zustandsmaschine gestartet
+    props->stripes = 1;                 // Standardmäßig eine Übertragung für die ganze Datei
+    props->stripe = 0;                  // Wird mit stripe_properties gesetzt
+    props->sessions_path[0] = '\0';     // Standardmäßig eine Sitzung
+    props->threads = 0;                 // Standardmäßig ein Thread je Kern
+    props->group_size = 0;              // Standardmäßig NACKs ohne Unterdrückung
+    props->fec_source = 0;              // Standardmäßig ohne Vorwärtsfehlerkorrektur
+    props->fec_parity = 0;
+    props->nack_due = 0;
+    props->rto = DEFAULT_RTO;           // Bis zur ersten Messung feste Timer wie bisher
+    props->echo = 0;
+    props->echo_received = 0;
+    props->loss_rate = 0;
+    props->congestion = false;          // Standardmäßig feste Senderate
+    props->catchup_rate = 0;            // Standardmäßig ein Teil von --rate
+    props->rate_log_path[0] = '\0';     // Standardmäßig ohne Rate-Log
+    props->rate_log = NULL;
+    props->segment_size = 0;            // Wird in start_socket aus der MTU berechnet
+    props->transport = NULL;            // Puffer werden erst in start_socket angelegt
     props->id = time(NULL) % 2147483647; // Generiert eine eindeutige ID basierend auf der aktuellen Zeit (Modulo, um Überlauf zu vermeiden)
 
     props->debug_code = 0;              // Standard-Debug-Code ist 0
@@ -82,6 +142,7 @@ int setup_properties(int argc, char** argv, struct properties* props)
     {
         props->port_server = DEFAULT_PORT_SERVER;         // Standardport für den Server
         props->windows_size = DEFAULT_WINDOW_SIZE;        // Standardfenstergröße
+        props->rate = DEFAULT_RATE;                       // Standardsenderate
         props->port_client = DEFAULT_PORT_CLIENT;         // Standardport für den Client
     }
     else // Konfiguration, wenn die Anwendung als Client läuft
@@ -130,14 +191,199 @@ int setup_properties(int argc, char** argv, struct properties* props)
             shift += 1;
             props->windows_size = atoi(argv[shift]); // Fenstergröße setzen
 
-            if(props->windows_size < 1 || props->windows_size>10)
+            if(props->windows_size < 1 || props->windows_size > MAX_WINDOW_SIZE)
+            {
+                printf(RED "Fenstergröße muss zwischen 1 und %d sein.\n" RESET, MAX_WINDOW_SIZE);
+                return -1;
+            }
+
+            continue;
+        }
+        // Verarbeiten des Arguments --rate (nur gültig für den Server)
+        else if (strcmp(argv[shift], "--rate") == 0 && shift + 1 < argc && props->is_server)
+        {
+            shift += 1;
+            props->rate = atoi(argv[shift]); // Senderate setzen
+
+            if(props->rate < 1 || props->rate > MAX_RATE)
+            {
+                printf(RED "Senderate muss zwischen 1 und %d kbit/s sein.\n" RESET, MAX_RATE);
+                return -1;
+            }
+
+            continue;
+        }
+        // Verarbeiten des Arguments --congestion (nur gültig für den Server)
+        else if (strcmp(argv[shift], "--congestion") == 0 && props->is_server)
+        {
+            props->congestion = true; // Senderate nach TFMCC anpassen, --rate ist die Obergrenze
+            continue;
+        }
+        // Verarbeiten des Arguments --catchup (nur gültig für den Server)
+        else if (strcmp(argv[shift], "--catchup") == 0 && shift + 1 < argc && props->is_server)
+        {
+            shift += 1;
+            props->catchup_rate = atoi(argv[shift]); // Senderate für spät beigetretene Clients setzen
+
+            if(props->catchup_rate < 1 || props->catchup_rate > MAX_RATE)
+            {
+                printf(RED "Senderate zum Aufholen muss zwischen 1 und %d kbit/s sein.\n" RESET, MAX_RATE);
+                return -1;
+            }
+
+            continue;
+        }
+        // Verarbeiten des Arguments --sessions (nur gültig für den Server)
+        else if (strcmp(argv[shift], "--sessions") == 0 && shift + 1 < argc && props->is_server)
+        {
+            shift += 1;
+            strncpy(props->sessions_path, argv[shift], sizeof(props->sessions_path) - 1); // Pfad kopieren
+            props->sessions_path[sizeof(props->sessions_path) - 1] = '\0';
+            continue;
+        }
+        // Verarbeiten des Arguments --threads (nur gültig für den Server)
+        else if (strcmp(argv[shift], "--threads") == 0 && shift + 1 < argc && props->is_server)
+        {
+            shift += 1;
+            props->threads = atoi(argv[shift]); // Anzahl der Threads für --sessions bzw. --stripes setzen
+
+            if(props->threads < 1 || props->threads > CPU_SETSIZE)
+            {
+                printf(RED "Anzahl der Threads muss zwischen 1 und %d sein.\n" RESET, CPU_SETSIZE);
+                return -1;
+            }
+
+            continue;
+        }
+        // Verarbeiten des Arguments --stripes
+        else if (strcmp(argv[shift], "--stripes") == 0 && shift + 1 < argc)
+        {
+            shift += 1;
+            props->stripes = atoi(argv[shift]); // Anzahl der Streifen setzen
+
+            if(props->stripes < 1 || props->stripes > MAX_STRIPES)
+            {
+                printf(RED "Anzahl der Streifen muss zwischen 1 und %d sein.\n" RESET, MAX_STRIPES);
+                return -1;
+            }
+
+            continue;
+        }
+        // Verarbeiten des Arguments --checkpoint (nur gültig für den Client)
+        else if (strcmp(argv[shift], "--checkpoint") == 0 && shift + 1 < argc && !props->is_server)
+        {
+            shift += 1;
+            props->checkpoint_interval = atoi(argv[shift]); // Abstand der Prüfpunkte setzen
+
+            if(props->checkpoint_interval < 0 || props->checkpoint_interval > MAX_RTO)
+            {
+                printf(RED "Abstand der Prüfpunkte muss zwischen 0 und %d ms sein.\n" RESET, MAX_RTO);
+                return -1;
+            }
+
+            continue;
+        }
+        // Verarbeiten des Arguments --writequeue (nur gültig für den Client)
+        else if (strcmp(argv[shift], "--writequeue") == 0 && shift + 1 < argc && !props->is_server)
+        {
+            shift += 1;
+            props->write_queue = atoi(argv[shift]); // Größe der Schreibwarteschlange setzen
+
+            if(props->write_queue < 0 || props->write_queue > MAX_WRITE_QUEUE)
+            {
+                printf(RED "Schreibwarteschlange muss zwischen 0 und %d Paketen sein.\n" RESET, MAX_WRITE_QUEUE);
+                return -1;
+            }
+
+            continue;
+        }
+        // Verarbeiten des Arguments --ratelog (nur gültig für den Server)
+        else if (strcmp(argv[shift], "--ratelog") == 0 && shift + 1 < argc && props->is_server)
+        {
+            shift += 1;
+            strncpy(props->rate_log_path, argv[shift], 254); // Pfad kopieren
+            continue;
+        }
+        // Verarbeiten des Arguments --binary (nur gültig für den Server)
+        else if (strcmp(argv[shift], "--binary") == 0 && props->is_server)
+        {
+            props->binary = true; // Segmente fester Größe statt Zeilen
+            continue;
+        }
+        // Verarbeiten des Arguments --mmap (nur gültig für den Server)
+        else if (strcmp(argv[shift], "--mmap") == 0 && props->is_server)
+        {
+            props->use_mmap = true; // Nutzdaten direkt aus der eingeblendeten Datei senden
+            continue;
+        }
+        // Verarbeiten des Arguments --pipeline (nur gültig für den Server)
+        else if (strcmp(argv[shift], "--pipeline") == 0 && props->is_server)
+        {
+            props->pipeline = true; // Lesen und Empfangen in eigenen Threads
+            continue;
+        }
+        // Verarbeiten des Arguments --suppress (nur gültig für den Server)
+        else if (strcmp(argv[shift], "--suppress") == 0 && shift + 1 < argc && props->is_server)
+        {
+            shift += 1;
+            props->group_size = atoi(argv[shift]); // Erwartete Gruppengröße, wird im HELLO verteilt
+
+            if(props->group_size < 1 || props->group_size > MAX_GROUP_SIZE)
+            {
+                printf(RED "Gruppengröße muss zwischen 1 und %d sein.\n" RESET, MAX_GROUP_SIZE);
+                return -1;
+            }
+
+            continue;
+        }
+        // Verarbeiten des Arguments --fec (nur gültig für den Server)
+        else if (strcmp(argv[shift], "--fec") == 0 && shift + 1 < argc && props->is_server)
+        {
+            shift += 1;
+            if(sscanf(argv[shift], "%d:%d", &props->fec_source, &props->fec_parity) != 2 
+                || props->fec_source < 1 || props->fec_source > MAX_FEC_SOURCE 
+                || props->fec_parity < 1 || props->fec_parity > props->fec_source)
+            {
+                printf(RED "FEC muss als n:k mit 1 <= k <= n <= %d angegeben werden.\n" RESET, MAX_FEC_SOURCE);
+                return -1;
+            }
+
+            continue;
+        }
+        // Verarbeiten des Arguments --mtu (nur gültig für den Server)
+        else if (strcmp(argv[shift], "--mtu") == 0 && shift + 1 < argc && props->is_server)
+        {
+            shift += 1;
+            props->mtu = atoi(argv[shift]);
+
+            if(props->mtu < MIN_MTU || props->mtu > MAX_MTU)
+            {
+                printf(RED "MTU muss zwischen %d und %d sein.\n" RESET, MIN_MTU, MAX_MTU);
+                return -1;
+            }
+
+            continue;
+        }
+        // Verarbeiten des Arguments --batch und Setzen der Datagramme pro Systemaufruf
+        else if (strcmp(argv[shift], "--batch") == 0 && shift + 1 < argc)
+        {
+            shift += 1;
+            props->batch_size = atoi(argv[shift]);
+
+            if(props->batch_size < 1 || props->batch_size > MAX_BATCH_SIZE)
             {
-                printf(RED "Fenstergröße muss zwischen 1 und 10 sein.\n" RESET);
+                printf(RED "Batchgröße muss zwischen 1 und %d sein.\n" RESET, MAX_BATCH_SIZE);
                 return -1;
             }
 
             continue;
         }
+        // Verarbeiten des Arguments --uring
+        else if (strcmp(argv[shift], "--uring") == 0)
+        {
+            props->uring = true; // Socket und Datei über io_uring, falls der Kernel es kann
+            continue;
+        }
         // Verarbeiten des Arguments --local und Aktivieren der lokalen Port-Wiederverwendung
         else if (strcmp(argv[shift], "--local") == 0)
         {
@@ -197,9 +443,112 @@ int setup_properties(int argc, char** argv, struct properties* props)
             "    Überschreibt den Standardwert, auch bei Verwendung von --local.\n"
             "    Standard: %s\n\n"
             "  --windowsize <Größe>\n"
-            "    Legt die Fenstergröße (1-10) für den Server fest.\n"
+            "    Legt die Fenstergröße (1-%d) für den Server fest.\n"
+            "    Gilt nur, wenn die Anwendung als Server läuft.\n"
+            "    Standard: %d\n\n"
+            "  --rate <kbit/s>\n"
+            "    Legt die Senderate des Servers fest. Pakete werden gesendet, sobald\n"
+            "    das Fenster es erlaubt und die Senderate nicht überschritten wird.\n"
             "    Gilt nur, wenn die Anwendung als Server läuft.\n"
             "    Standard: %d\n\n"
+            "  --congestion\n"
+            "    Passt die Senderate wie TFMCC an die Empfänger an: Jeder Client meldet\n"
+            "    seine Verlustereignisrate, der Server sendet mit der TCP-freundlichen Rate\n"
+            "    des langsamsten Empfängers, höchstens mit --rate.\n"
+            "    Gilt nur, wenn die Anwendung als Server läuft.\n"
+            "    Standard: deaktiviert.\n\n"
+            "  --catchup <kbit/s>\n"
+            "    Clients können einer laufenden Übertragung im Binärmodus beitreten und\n"
+            "    erhalten die verpassten Segmente per Unicast mit höchstens dieser Rate.\n"
+            "    Sie wird auf --rate angerechnet und bremst damit die laufenden Pakete.\n"
+            "    Gilt nur, wenn die Anwendung als Server läuft.\n"
+            "    Standard: ein Viertel von --rate.\n\n"
+            "  --ratelog <Dateipfad>\n"
+            "    Schreibt Senderate, begrenzenden Empfänger, Verlustrate und RTT als CSV\n"
+            "    in die Datei, z. B. um --congestion mit --debug zu prüfen.\n"
+            "    Gilt nur, wenn die Anwendung als Server läuft.\n"
+            "    Standard: deaktiviert.\n\n"
+            "  --binary\n"
+            "    Überträgt die Datei byte-genau in Segmenten, deren Größe an die MTU\n"
+            "    angepasst ist, statt Zeile für Zeile. Damit sind beliebige Dateien möglich.\n"
+            "    Gilt nur, wenn die Anwendung als Server läuft.\n"
+            "    Standard: deaktiviert.\n\n"
+            "  --mmap\n"
+            "    Blendet die Datei in den Speicher ein und sendet die Nutzdaten direkt\n"
+            "    aus der Datei, ohne sie zu kopieren. Mit --loop kommt jede weitere\n"
+            "    Runde aus dem Seitencache.\n"
+            "    Gilt nur, wenn die Anwendung als Server läuft.\n"
+            "    Standard: deaktiviert.\n\n"
+            "  --pipeline\n"
+            "    Teilt den Server in drei Threads: einer liest die Datei voraus, einer\n"
+            "    empfängt und dekodiert die Antworten der Clients, einer sendet und\n"
+            "    behandelt Timer. Ein langsamer Lesezugriff oder viele Antworten\n"
+            "    verzögern damit nicht mehr das nächste Paket.\n"
+            "    Gilt nur, wenn die Anwendung als Server läuft.\n"
+            "    Standard: deaktiviert.\n\n"
+            "  --suppress <Gruppengröße>\n"
+            "    Clients senden NACKs nach einer zufälligen, mit der erwarteten Anzahl an\n"
+            "    Empfängern (1-%d) wachsenden Wartezeit auch per Multicast und verwerfen\n"
+            "    ihr NACK, wenn ein anderer Client dieselben Pakete schon angefordert hat.\n"
+            "    Wiederholungen werden dann per Multicast an alle gesendet.\n"
+            "    Gilt nur, wenn die Anwendung als Server läuft.\n"
+            "    Standard: deaktiviert.\n\n"
+            "  --fec <n>:<k>\n"
+            "    Sendet nach je n Paketen (1-%d) k Paritätspakete (XOR, verschachtelt).\n"
+            "    Clients stellen damit bis zu k verlorene Pakete eines Blocks ohne NACK\n"
+            "    wieder her, sofern sie nicht an Positionen mit gleichem Rest modulo k liegen.\n"
+            "    Gilt nur, wenn die Anwendung als Server läuft.\n"
+            "    Standard: deaktiviert.\n\n"
+            "  --mtu <Bytes>\n"
+            "    Legt die MTU des Pfads (%d-%d, Jumbo-Frames bis %d) für --binary fest.\n"
+            "    Gilt nur, wenn die Anwendung als Server läuft.\n"
+            "    Standard: MTU der Schnittstelle, sonst %d.\n\n"
+            "  --batch <Anzahl>\n"
+            "    Legt fest, wie viele Datagramme (1-%d) mit einem Systemaufruf\n"
+            "    gesendet bzw. empfangen werden. 1 sendet jedes Paket sofort einzeln.\n"
+            "    Standard: %d\n\n"
+            "  --uring\n"
+            "    Sendet und empfängt die Datagramme über io_uring: Empfangsaufträge\n"
+            "    liegen dauerhaft beim Kernel und Abschlüsse werden ohne Systemaufruf\n"
+            "    abgeholt. Der Schreib-Thread des Clients (--writequeue) und der\n"
+            "    Lese-Thread des Servers (--pipeline, --binary) lesen bzw. schreiben\n"
+            "    gebündelt in registrierte Puffer des Paketpools. Ohne io_uring im\n"
+            "    Kernel wird wie bisher sendmmsg/recvmmsg bzw. stdio verwendet.\n"
+            "    Standard: deaktiviert.\n\n"
+            "  --sessions <Dateipfad>\n"
+            "    Startet mehrere unabhängige Übertragungen in einem Prozess. Jede Zeile\n"
+            "    der Datei enthält die Optionen einer Sitzung, z. B. --filepath,\n"
+            "    --multicastaddress, --portserver und --portclient, und ergänzt bzw.\n"
+            "    überschreibt die übrigen Optionen. Jede Sitzung braucht einen eigenen\n"
+            "    --portserver. Leere Zeilen und Zeilen mit # werden übersprungen.\n"
+            "    Gilt nur, wenn die Anwendung als Server läuft.\n"
+            "    Standard: eine Sitzung mit den übrigen Optionen.\n\n"
+            "  --threads <Anzahl>\n"
+            "    Verteilt die Sitzungen von --sessions bzw. die Streifen von --stripes auf\n"
+            "    so viele Threads, die jeweils an einen eigenen Kern gebunden werden.\n"
+            "    Gilt nur, wenn die Anwendung als Server läuft.\n"
+            "    Standard: Anzahl der erlaubten Kerne (z. B. mit taskset), höchstens\n"
+            "    eine je Sitzung, mit --stripes einer je Streifen.\n\n"
+            "  --stripes <Anzahl>\n"
+            "    Verteilt die Datei im Binärmodus auf so viele (1 bis %d) Übertragungen,\n"
+            "    jede in einem eigenen Thread mit eigenem Socket. Streifen k sendet bzw.\n"
+            "    empfängt die Segmente k, k + n, ... über --multicastaddress, --portserver\n"
+            "    und --portclient plus k. Server und Clients brauchen denselben Wert.\n"
+            "    Standard: 1\n\n"
+            "  --checkpoint <ms>\n"
+            "    Sichert im Binärmodus alle so viele Millisekunden (0 = nie) die schon\n"
+            "    geschriebenen Segmente neben der Zieldatei (Endung %s). Existiert die\n"
+            "    Zieldatei mit Prüfpunkt, setzt ein Neustart die Übertragung fort und\n"
+            "    fordert nur die fehlenden Segmente an.\n"
+            "    Gilt nur, wenn die Anwendung als Client läuft.\n"
+            "    Standard: %d\n\n"
+            "  --writequeue <Anzahl>\n"
+            "    Schreibt die empfangenen Pakete in einem eigenen Thread in die Datei,\n"
+            "    damit das Empfangen nicht auf die Festplatte wartet. Sind so viele\n"
+            "    Pakete (1 bis %d) noch nicht geschrieben, wartet der Empfang auf den\n"
+            "    Schreib-Thread. 0 schreibt direkt im Empfangsthread.\n"
+            "    Gilt nur, wenn die Anwendung als Client läuft.\n"
+            "    Standard: 0\n\n"
             "  --local\n"
             "    Aktiviert die Wiederverwendung lokaler Ports (lokale Bindung).\n"
             "    Wenn gesetzt, wird die lokale Multicast-Adresse (%s) und das Loopback-Interface verwendet.\n"
@@ -228,7 +577,7 @@ int setup_properties(int argc, char** argv, struct properties* props)
             "  - Verwendet /path/to/file als Dateipfad.\n"
             "  - Aktiviert die lokale Port-Wiederverwendung und setzt Loopback-Interface.\n"
             "  - Simuliert eine Wahrscheinlichkeit von 10%% für Paketverlust beim Server.\n\n",
-            DEFAULT_PORT_SERVER, DEFAULT_PORT_CLIENT, DEFAULT_FILE_PATH, DEFAULT_MULTI_ADRESS, DEFAULT_WINDOW_SIZE, DEFAULT_MULTI_ADRESS_LOCAL);
+            DEFAULT_PORT_SERVER, DEFAULT_PORT_CLIENT, DEFAULT_FILE_PATH, DEFAULT_MULTI_ADRESS, MAX_WINDOW_SIZE, DEFAULT_WINDOW_SIZE, DEFAULT_RATE, MAX_GROUP_SIZE, MAX_FEC_SOURCE, MIN_MTU, MAX_MTU, MAX_MTU, DEFAULT_MTU, MAX_BATCH_SIZE, DEFAULT_BATCH_SIZE, MAX_STRIPES, CHECKPOINT_SUFFIX, DEFAULT_CHECKPOINT_INTERVAL, MAX_WRITE_QUEUE, DEFAULT_MULTI_ADRESS_LOCAL);
 
             return -1;
         }
@@ -244,6 +593,60 @@ int setup_properties(int argc, char** argv, struct properties* props)
 }
 
 
+/**
+ * Funktion: stripe_properties
+ * ---------------------------
+ * Leitet die Eigenschaften des Streifens `stripe` (--stripes) aus denen der Kommandozeile ab: 
+ * Multicast-Adresse, Server- und Client-Port werden um `stripe` erhöht.
+ *
+ * Parameter:
+ * - props: Eine Kopie der Eigenschaften der Kommandozeile, wird angepasst.
+ * - stripe: Index des Streifens, 0 bis `stripes` - 1.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 wenn die Adresse ungültig ist oder Adresse bzw. Ports überlaufen würden.
+ */
+int stripe_properties(struct properties* props, int stripe)
+{
+    struct in6_addr addr;
+    if(inet_pton(AF_INET6, props->multi_address, &addr) <= 0 
+        || addr.s6_addr[15] + stripe > 255 || props->port_server + stripe > 65535 || props->port_client + stripe > 65535)
+    {
+        print_timestamp();
+        printf(RED "Keine Adresse bzw. Ports für Streifen %d ab %s\n" RESET, stripe, props->multi_address);
+        return -1;
+    }
+
+    addr.s6_addr[15] += stripe;
+    inet_ntop(AF_INET6, &addr, props->multi_address, sizeof(props->multi_address));
+    props->port_server += stripe;
+    props->port_client += stripe;
+    props->stripe = stripe;
+
+    return 0;
+}
+
+
+/**
+ * Funktion: segment_offset
+ * ------------------------
+ * Berechnet die Byte-Position eines Segments in der Datei. Mit --stripes zählen die 
+ * Paket-IDs je Streifen, die Segmente eines Streifens liegen `stripes` Segmente auseinander.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties` mit Segmentgröße und Streifen.
+ * - package_id: Die Paket-ID des Segments (ab 1).
+ *
+ * Rückgabewert:
+ * - Die Byte-Position des Segments.
+ */
+long long segment_offset(struct properties* props, int package_id)
+{
+    return ((long long)(package_id - 1) * props->stripes + props->stripe) * props->segment_size;
+}
+
+
 /**
  * Funktion: start_socket
  * -----------------------
@@ -431,6 +834,20 @@ int start_socket(struct properties* props)
         printf(GREEN "Schnittstelle auf %s gesetzt\n" RESET, default_interfaces[i]);
     }
 
+    // MTU der Schnittstelle übernehmen, falls nicht angegeben, und Segmentgröße berechnen
+    if(props->mtu == 0)
+    {
+        props->mtu = get_interface_mtu(props->mreq.ipv6mr_interface);
+    }
+
+    props->segment_size = props->mtu - IPV6_UDP_HEADER_SIZE - WIRE_REQUEST_HEADER_SIZE;
+
+    if(props->binary)
+    {
+        print_timestamp();
+        printf(GREEN "MTU %d, Segmente mit %d Bytes Nutzdaten\n" RESET, props->mtu, props->segment_size);
+    }
+
     // Konfiguration der Adresse für den Server oder Client
     memset(&props->my_addr, 0, sizeof(props->my_addr));
     props->my_addr.sin6_family = AF_INET6;         // IPv6
@@ -458,10 +875,23 @@ int start_socket(struct properties* props)
     print_timestamp();
     printf(GREEN "Socket auf Port %d gebunden\n" RESET, htons(props->my_addr.sin6_port));
 
+    // Multicast-Zieladresse einmalig umwandeln, damit sie nicht bei jedem Senden konvertiert wird
+    memset(&props->multi_addr, 0, sizeof(props->multi_addr));
+    props->multi_addr.sin6_family = AF_INET6; // Adresse ist IPv6
+    props->multi_addr.sin6_port = htons(props->port_client); // Port konvertieren zu Netzwerk-Byte-Reihenfolge
+
+    if(inet_pton(AF_INET6, props->multi_address, &props->multi_addr.sin6_addr) <= 0) 
+    {
+        print_timestamp();
+        printf(RED "Ungültige Multicast-Adresse\n" RESET);
+        close(props->sockfd);
+        return -1;
+    }
+
     // Multicast-Registrierung für Clients
     if(!props->is_server) 
     {
-        inet_pton(AF_INET6, props->multi_address, &props->mreq.ipv6mr_multiaddr); // Multicast-Adresse konvertieren
+        props->mreq.ipv6mr_multiaddr = props->multi_addr.sin6_addr; // Multicast-Adresse übernehmen
 
         if (setsockopt(props->sockfd, IPPROTO_IPV6, IPV6_JOIN_GROUP, &props->mreq, sizeof(props->mreq)) < 0) 
         {
@@ -477,7 +907,7 @@ int start_socket(struct properties* props)
 
 
     // Empfangspuffergröße festlegen
-    int buffer_size = sizeof(struct communication) * MAX_ALLOWED_CLIENTS; // Beispielgröße
+    int buffer_size = DEFAULT_RECEIVE_BUFFER_SIZE;
     if(setsockopt(props->sockfd, SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof(buffer_size)) < 0) 
     {
         print_timestamp();
@@ -490,16 +920,72 @@ int start_socket(struct properties* props)
     print_timestamp();
     printf(GREEN "Empfangspuffer auf %d Bytes gesetzt\n" RESET, buffer_size);
 
+    // Puffer für gebündelte Systemaufrufe anlegen
+    if(transport_init(props) < 0)
+    {
+        close(props->sockfd);
+        return -1;
+    }
+
     return 0;
 }
 
 
+/**
+ * Funktion: get_interface_mtu
+ * ---------------------------
+ * Fragt die MTU einer Netzwerkschnittstelle ab und begrenzt sie auf den unterstützten Bereich.
+ *
+ * Parameter:
+ * - ifindex: Index der Schnittstelle.
+ *
+ * Rückgabewert:
+ * - Die MTU zwischen MIN_MTU und MAX_MTU.
+ * - DEFAULT_MTU, wenn die MTU nicht abgefragt werden kann.
+ */
+int get_interface_mtu(unsigned int ifindex)
+{
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+
+    if(ifindex == 0 || if_indextoname(ifindex, ifr.ifr_name) == NULL)
+    {
+        return DEFAULT_MTU;
+    }
+
+    int fd = socket(AF_INET6, SOCK_DGRAM, 0);
+    if(fd < 0)
+    {
+        return DEFAULT_MTU;
+    }
+
+    int mtu = DEFAULT_MTU;
+    if(ioctl(fd, SIOCGIFMTU, &ifr) == 0)
+    {
+        mtu = ifr.ifr_mtu;
+    }
+    close(fd);
+
+    if(mtu < MIN_MTU)
+    {
+        mtu = MIN_MTU;
+    }
+    if(mtu > MAX_MTU)
+    {
+        mtu = MAX_MTU; // z. B. Loopback mit 65536
+    }
+
+    return mtu;
+}
+
+
 /**
  * Funktion: close_socket
  * ----------------------
  * Diese Funktion schließt den Socket, der in der `properties`-Struktur 
  * gespeichert ist. Sie stellt sicher, dass der Socket freigegeben wird, 
- * um Ressourcenlecks zu vermeiden.
+ * um Ressourcenlecks zu vermeiden. Noch wartende Datagramme werden vorher 
+ * gesendet. Ein mehrfacher Aufruf ist unschädlich.
  *
  * Parameter:
  * - props: Ein Pointer auf eine Struktur `properties`, die den zu 
@@ -507,466 +993,4716 @@ int start_socket(struct properties* props)
  */
 void close_socket(struct properties* props)
 {
-    close(props->sockfd); // Schließt den Socket und gibt Ressourcen frei
-}
+    if(props->transport != NULL)
+    {
+        flush_cast(props); // Wartende Datagramme senden
+        transport_free(props);
+    }
 
+    if(props->sockfd >= 0)
+    {
+        close(props->sockfd); // Schließt den Socket und gibt Ressourcen frei
+        props->sockfd = -1;
+    }
+}
 
 
 /**
- * Funktion: send_unicast
- * ----------------------
- * Diese Funktion sendet eine Unicast-Nachricht an einen spezifischen Partner
- * unter Verwendung eines definierten Sockets. Die Nachricht wird direkt an die
- * in der `communication`-Struktur angegebene Zieladresse gesendet.
+ * Funktion: transport_uring_init
+ * ------------------------------
+ * Legt für --uring den io_uring des Transports an. Der Socket wird als feste Datei 0 
+ * registriert, damit der Kernel ihn nicht bei jedem Auftrag nachschlagen muss, und ein 
+ * eventfd meldet Abschlüsse an die Ereignisschleife. Schlägt etwas fehl, z. B. weil der 
+ * Kernel kein io_uring kennt, bleibt der Transport bei sendmmsg/recvmmsg.
  *
  * Parameter:
- * - props: Ein Pointer auf eine Struktur `properties`, die den Socket 
- *          enthält, über den die Nachricht gesendet wird.
- * - com: Ein Pointer auf eine Struktur `communication`, die die Nachricht 
- *        (`ans`) und die Zieladresseninformationen (`partner`) enthält.
+ * - props: Pointer auf die Eigenschaften mit Socket und Transport.
  *
- * Rückgabewert:
- * - 0 bei erfolgreichem Senden der Unicast-Nachricht.
- * - -1 bei Fehlern, z. B. wenn das Senden fehlschlägt.
+ * Beschreibung:
+ * - Der Socket wird blockierend, damit ein Empfangsauftrag beim Kernel auf das nächste 
+ *   Datagramm wartet, statt auf älteren Kerneln sofort mit EAGAIN zurückzukommen. 
+ *   sendmmsg und recvmmsg verwenden ohnehin MSG_DONTWAIT.
  */
-int send_unicast(struct properties *props, struct communication* com) 
-{    
-    // Nachricht über den Socket an den angegebenen Partner senden
-    if(props->is_server)
+static void transport_uring_init(struct properties* props)
+{
+    struct transport* transport = props->transport;
+
+    if(uring_init(&transport->ring, URING_ENTRIES) == 0)
     {
-        if(sendto(props->sockfd, &com->req, sizeof(com->req), 0, (struct sockaddr *)&com->partner, sizeof(com->partner)) < 0) 
-        {   
+#ifdef __linux__
+        transport->event_fd = eventfd(0, EFD_NONBLOCK);
+        if(transport->event_fd >= 0
+            && uring_register(&transport->ring, IORING_REGISTER_FILES, &props->sockfd, 1) == 0
+            && uring_register(&transport->ring, IORING_REGISTER_EVENTFD, &transport->event_fd, 1) == 0)
+        {
+            fcntl(props->sockfd, F_SETFL, fcntl(props->sockfd, F_GETFL, 0) & ~O_NONBLOCK);
+
             print_timestamp();
-            printf(RED "Unicast konnte nicht gesendet werden" RESET); // Fehler beim Senden
-            print_timestamp();        
-            perror(RED "\t\t" RESET);
-    
-            return -1;
+            printf(GREEN "Datagramme werden über io_uring gesendet und empfangen\n" RESET);
+            return;
         }
-    }
-    else
-    {
-        //MSG_NOSIGNAL WICHTIG!
-        // Bei MAC Pro Socket PIPE error idk why?
-        if(sendto(props->sockfd, &com->ans, sizeof(com->ans), MSG_NOSIGNAL, (struct sockaddr *)&com->partner, sizeof(com->partner)) < 0) 
+
+        int error = errno;
+        uring_free(&transport->ring);
+        if(transport->event_fd >= 0)
         {
-            print_timestamp();
-            printf(RED "Unicast konnte nicht gesendet werden" RESET); // Fehler beim Senden
-            print_timestamp();
-            perror("\t\t");
-            
-            return -1;
+            close(transport->event_fd);
+            transport->event_fd = -1;
         }
+        errno = error;
+#endif
     }
 
-    // Erfolgreiches Senden der Nachricht
     print_timestamp();
-    printf(GREEN "Unicast gesendet\n" RESET);
-
-    return 0;
+    printf(RED "io_uring nicht verfügbar, es wird sendmmsg/recvmmsg verwendet\n" RESET);
+    perror("\t\t");
 }
 
 
 /**
- * Funktion: send_multicast
- * ------------------------
- * Diese Funktion sendet eine Multicast-Nachricht an eine bestimmte Adresse 
- * und Port unter Verwendung von IPv6. Sie überprüft die Gültigkeit der 
- * Multicast-Adresse und sendet die Nachricht über den angegebenen Socket.
+ * Funktion: uring_reap
+ * --------------------
+ * Wertet alle Abschlüsse im Ring des Transports aus, ohne Systemaufruf. Empfangene 
+ * Datagramme werden in `rx_order` eingereiht, Ergebnisse von Sendeaufträgen in `send_results`.
  *
  * Parameter:
- * - props: Ein Pointer auf eine Struktur `properties`, die die notwendigen 
- *          Eigenschaften wie den Socket und die Multicast-Adresse enthält.
- * - com: Ein Pointer auf eine Struktur `communication`, die die Nachricht 
- *        und die Zielportinformationen enthält.
+ * - transport: Die Sende- und Empfangspuffer mit dem Ring.
+ * - send_results: Ergebnis je Sendeplatz (Bytes bzw. negativer Fehlercode), NULL außerhalb 
+ *                 von `flush_cast`.
  *
  * Rückgabewert:
- * - 0 bei erfolgreichem Senden der Multicast-Nachricht.
- * - -1 bei Fehlern, z. B. bei ungültiger Multicast-Adresse oder Problemen 
- *   beim Senden.
+ * - Anzahl der beendeten Sendeaufträge.
+ *
+ * Beschreibung:
+ * - Ein abgebrochener Empfangsauftrag (ECANCELED) gibt nur seinen Platz frei, andere 
+ *   Fehler setzen `rx_failed`, den `receive_cast` meldet.
  */
-int send_multicast(struct properties* props, struct communication* com) 
-{       
-    // Zieladresse initialisieren und auf Null setzen
-    struct sockaddr_in6 dest_addr;
-    memset(&dest_addr, 0, sizeof(dest_addr));
-    
-    // Zieladresse als IPv6 und Zielport konfigurieren
-    dest_addr.sin6_family = AF_INET6; // Adresse ist IPv6
-    dest_addr.sin6_port = htons(props->port_client); // Port konvertieren zu Netzwerk-Byte-Reihenfolge
+static int uring_reap(struct transport* transport, int* send_results)
+{
+    int sends = 0;
 
-    // Multicast-Adresse in binäre Form konvertieren und überprüfen
-    if (inet_pton(AF_INET6, props->multi_address, &dest_addr.sin6_addr) <= 0) 
+#ifdef __linux__
+    struct io_uring_cqe* cqe;
+    while((cqe = uring_peek(&transport->ring)) != NULL)
     {
-        print_timestamp();
-        printf(RED "Ungültige Multicast-Adresse\n" RESET);
-    
-        return -1; // Fehler bei ungültiger Adresse
-    }
+        unsigned long long tag = cqe->user_data >> 32;
+        int slot = (int)(cqe->user_data & 0xFFFFFFFFULL);
+        int res = cqe->res;
+        uring_seen(&transport->ring);
 
-    // Nachricht über den Socket senden
-    if(sendto(props->sockfd, &com->req, sizeof(com->req), 0, (struct sockaddr *)&dest_addr, sizeof(dest_addr)) < 0) 
-    {
-        print_timestamp();
-        printf(RED "Multicast konnte nicht gesendet werden\n" RESET);
-        perror("\t\t");
-        
-        return -1; // Fehler beim Senden
+        if(tag == URING_SEND && send_results != NULL)
+        {
+            send_results[slot] = res;
+            sends += 1;
+        }
+        else if(tag == URING_RECEIVE)
+        {
+            transport->rx_armed[slot] = false;
+            if(res >= 0)
+            {
+                transport->rx_msgs[slot].msg_len = (unsigned int)res;
+                transport->rx_order[transport->rx_count] = slot;
+                transport->rx_count += 1;
+                transport->receive_packets += 1;
+            }
+            else if(res != -ECANCELED && res != -EINTR && res != -EAGAIN)
+            {
+                errno = -res;
+                transport->rx_failed = true;
+            }
+        }
     }
+#else
+    (void)transport;
+    (void)send_results;
+#endif
 
-    // Erfolgreiches Senden der Nachricht
-    print_timestamp();
-    printf(GREEN "Multicast gesendet\n" RESET);
-
-    return 0;
+    return sends;
 }
 
 
 /**
- * Funktion: receive_cast
- * ----------------------
- * Wartet auf ein UDP-Paket und verarbeitet die empfangenen Daten. 
- * Die Funktion unterstützt Timeout-Mechanismen, überprüft den Absender und Empfänger, 
- * und ignoriert ungültige oder nicht relevante Nachrichten.
+ * Funktion: uring_cancel_receives
+ * -------------------------------
+ * Bricht alle Empfangsaufträge des Transports beim Kernel ab und wartet, bis sie beendet 
+ * sind. Danach schreibt der Kernel in keinen Empfangspuffer mehr. Datagramme, die noch 
+ * vor dem Abbruch empfangen wurden, stehen wie die übrigen in `rx_order`.
  *
  * Parameter:
- * - props: Pointer auf eine Struktur `properties`, die Sockets und IDs speichert.
- * - com: Pointer auf eine Struktur `communication`, die die Kommunikationsdaten speichert.
- * - list: Pointer auf eine Struktur `memberlist`, die bekannte Mitglieder speichert (nur relevant für Server).
- *
- * Rückgabewert:
- * - 1: Paket erfolgreich empfangen und verarbeitet.
- * - 0: Timeout abgelaufen, ohne dass ein Paket empfangen wurde.
- * - -1: Fehler bei `select` oder `recvfrom`.
- *
- * Beschreibung:
- * - Wenn memberlist NULL ist wird keine Prüfung vorgenommen.
- * - Die Funktion verwendet `select`, um innerhalb eines definierten Zeitfensters (DEFAULT_SLOT_TIME) 
- *   auf eingehende UDP-Pakete zu warten.
- * - Prüft den Absender (Sender-ID) und Empfänger (Receiver-ID) auf Gültigkeit.
- * - Ignoriert eigene Nachrichten oder Pakete, die für andere Empfänger bestimmt sind.
- * - Kopiert die empfangenen Daten in die `communication`-Struktur für die weitere Verarbeitung.
+ * - transport: Die Sende- und Empfangspuffer mit dem Ring.
  */
-int receive_cast(struct properties* props, struct communication* com, struct memberlist* list) 
+static void uring_cancel_receives(struct transport* transport)
 {
-    char buffer[sizeof(struct request)]; // Puffer für die empfangenen Daten
-
-    struct timeval timeout;          // Timeout-Einstellung für `select`
-    fd_set read_fds;                 // Datei-Deskriptor-Set für `select`
-
-    // Timeout in Sekunden und Mikrosekunden berechnen
-    timeout.tv_sec = DEFAULT_SLOT_TIME / 1000;
-    timeout.tv_usec = (DEFAULT_SLOT_TIME % 1000) * 1000;
-
-    // Startzeit erfassen
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    long long timer_start = (long long)(tv.tv_sec) * 1000 + (tv.tv_usec / 1000);
-
-    while(1) 
+#ifdef __linux__
+    if(transport->ring.fd < 0)
     {
-        FD_ZERO(&read_fds);                 // Datei-Deskriptor-Set zurücksetzen
-        FD_SET(props->sockfd, &read_fds);   // Socket hinzufügen
-
-        print_timestamp();
-        printf("Warte auf Paket\n");        // Nachricht vor `select`
-        print_timestamp();
-        printf(BLUE "Warte... %dms\n" RESET, DEFAULT_SLOT_TIME);
-        
-        // Warten auf eingehende Daten
-        int result = select(props->sockfd + 1, &read_fds, NULL, NULL, &timeout);
-
-        // Verbleibende Zeit berechnen
-        gettimeofday(&tv, NULL);
-        long long timer_left = DEFAULT_SLOT_TIME - (((long long)(tv.tv_sec) * 1000 + (tv.tv_usec / 1000)) - timer_start);
+        return;
+    }
 
-        if(result <= 0) 
+    bool armed = false;
+    for(int i = 0; i < MAX_BATCH_SIZE; i++)
+    {
+        if(!transport->rx_armed[i])
         {
-            if(result == 0) 
-            {
-                print_timestamp();
-                printf(RED "Kein Paket empfangen\n" RESET); // Timeout ohne Empfang
-                return 0; // Keine Nachricht empfangen
-            } 
-            else 
-            {
-                print_timestamp();
-                printf(RED "Fehler bei select()\n" RESET); // Fehler bei `select`
-                perror("\t\t");
-                return -1; // Fehler
-            }
+            continue;
         }
 
-        // Empfangene Daten lesen
-        socklen_t partner_len = sizeof(com->partner); // Größe der Partneradresse
-        ssize_t bytes_received = recvfrom(props->sockfd, buffer, sizeof(buffer), 0, (struct sockaddr *)&com->partner, &partner_len);
-        if(bytes_received < 0) 
+        struct io_uring_sqe* sqe = uring_get_sqe(&transport->ring);
+        if(sqe != NULL)
         {
-            print_timestamp();
-            printf(RED "Fehler bei recvfrom\n" RESET); // Fehler beim Empfang
-            perror("\t\t");
-            return -1;
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->addr = (URING_RECEIVE << 32) | (unsigned long long)i;
+            sqe->user_data = URING_CANCEL << 32;
         }
+        armed = true;
+    }
 
-        // ID des Senders extrahieren
-        int sender_id = *(int *)(buffer);
-        if(sender_id == props->id) 
+    while(armed)
+    {
+        if(uring_submit(&transport->ring, 1) < 0)
         {
-            print_timestamp();
-            printf("Nachricht von eigener ID ignoriert\n"); // Eigene Nachricht ignorieren
-            continue;
-        }
-
-        // Für Server: Prüfen, ob Sender bekannt ist
-        if(props->is_server && list != NULL)
-        {   
-            bool knows_sender = false;
-
-            for(int i = 0; i < list->number_members; i++)
-            {
-                if(list->member[i].member_id == sender_id &&
-                   IN6_ARE_ADDR_EQUAL(&list->member[i].member.sin6_addr, &com->partner.sin6_addr))
-                {
-                    knows_sender = true;
-                    break;
-                }
-            }
-
-            if(!knows_sender)
-            {
-                print_timestamp();
-                printf("Paket von unbekanntem Sender ignoriert\n"); 
-                continue;
-            }
+            break; // Der Ring bricht die Aufträge spätestens beim Freigeben ab
         }
+        uring_reap(transport, NULL);
 
-        // ID des Empfängers extrahieren
-        int receiver_id = *(int *)(buffer + sizeof(int));
-        if(receiver_id != props->id && receiver_id != -1) 
+        armed = false;
+        for(int i = 0; i < MAX_BATCH_SIZE; i++)
         {
-            print_timestamp();
-            printf("Paket für anderen Empfänger ignoriert\n");
-            continue;
+            armed = armed || transport->rx_armed[i];
         }
+    }
+#else
+    (void)transport;
+#endif
+}
 
+
+/**
+ * Funktion: transport_init
+ * ------------------------
+ * Legt die Puffer für gebündeltes Senden und Empfangen an und verknüpft die 
+ * Nachrichtenköpfe einmalig mit ihren Puffern und Adressen.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf eine Struktur `properties`, in der die Puffer 
+ *          (`transport`) abgelegt werden.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 wenn kein Speicher reserviert werden konnte.
+ */
+int transport_init(struct properties* props)
+{
+    struct transport* transport = calloc(1, sizeof(struct transport));
+    if(transport == NULL)
+    {
         print_timestamp();
-        printf(GREEN "Paket empfangen\n" RESET);
-        print_timestamp();
-        printf("Sender ID: %d\n", sender_id);
+        printf(RED "Speicher für Sende- und Empfangspuffer konnte nicht reserviert werden\n" RESET);
+        return -1;
+    }
 
-        // Nachricht verarbeiten
-        if(props->is_server) 
-        {
-            memcpy(&com->ans, buffer, sizeof(struct answer)); // Für Server
-        } 
-        else 
-        {
-            memcpy(&com->req, buffer, sizeof(struct request)); // Für Client
-        }
+    transport->batch_size = props->batch_size;
+    transport->ring.fd = -1;
+    transport->event_fd = -1;
 
-        print_timestamp();
-        printf(BLUE "Warte... %lldms\n" RESET, timer_left);
+    for(int i = 0; i < MAX_BATCH_SIZE; i++)
+    {
+        transport->tx_iov[i][0].iov_base = transport->tx_buffer[i];
+        transport->tx_msgs[i].msg_hdr.msg_iov = transport->tx_iov[i];
+        transport->tx_msgs[i].msg_hdr.msg_iovlen = 1;
+        transport->tx_packet[i] = PACKET_NONE;
+        transport->tx_msgs[i].msg_hdr.msg_name = &transport->tx_addr[i];
+        transport->tx_msgs[i].msg_hdr.msg_namelen = sizeof(transport->tx_addr[i]);
 
-        if(timer_left > 0)
-        {
-            usleep(timer_left * 1000); // Verzögerung einfügen
-        }
-        
-        return 1; // Erfolgreich empfangen
+        transport->rx_iov[i].iov_base = transport->rx_buffer[i];
+        transport->rx_iov[i].iov_len = MAX_DATAGRAM_SIZE;
+        transport->rx_msgs[i].msg_hdr.msg_iov = &transport->rx_iov[i];
+        transport->rx_msgs[i].msg_hdr.msg_iovlen = 1;
+        transport->rx_msgs[i].msg_hdr.msg_name = &transport->rx_addr[i];
+        transport->rx_msgs[i].msg_hdr.msg_namelen = sizeof(transport->rx_addr[i]);
+        transport->rx_packet[i] = PACKET_NONE;
+        transport->rx_order[i] = i;
     }
-}
 
+    props->transport = transport;
+
+    if(props->uring)
+    {
+        transport_uring_init(props);
+    }
+
+    print_timestamp();
+    printf(GREEN "Bis zu %d Datagramme pro Systemaufruf\n" RESET, transport->batch_size);
+
+    return 0;
+}
 
 
 /**
- * Funktion: add_timer_linked_list_timer
- * --------------------------------
- * Fügt ein neues Element (`new_link`) zur bestehenden verketteten Liste hinzu. Die
- * Funktion passt dabei die `ticksToGo`-Werte an, sodass jedes Element die relative
- * Zeit bis zum nächsten Element repräsentiert.
+ * Funktion: transport_free
+ * ------------------------
+ * Bricht die Empfangsaufträge von --uring ab, gibt den Ring frei und danach die Sende- und 
+ * Empfangspuffer. Vorher werden die Zähler der Systemaufrufe ausgegeben.
  *
  * Parameter:
- * - head: Ein Pointer auf das erste Element der verketteten Liste.
- * - new_link: Ein Pointer auf das neue Element, das hinzugefügt werden soll.
+ * - props: Pointer auf die Eigenschaften mit den Sende- und Empfangspuffern.
  *
- * Rückgabewert:
- * - Keiner (void).
+ * Beschreibung:
+ * - Wartende Datagramme werden nicht mehr gesendet, dafür vorher `flush_cast` aufrufen.
  */
-void add_timer_linked_list_timer(struct linked_list_timer** head, int package_id, int ticks)
+void transport_free(struct properties* props)
 {
-    struct linked_list_timer* new_timer = (struct linked_list_timer*)malloc(sizeof(struct linked_list_timer));
-    new_timer->packageId = package_id;
-    new_timer->ticksToGo = ticks;
-    
-    // DIESE SCHEISS ZEILE HAT MICH 5 STUNDEN MEINES LEBENS GEKOSTET !!! 
-    // Auf einem Mac erkennt er das der Wert keine gültige Speicheraddresse ist und bricht ab, ein ThinkPad erkennt das nicht
-    // Die Sau versucht auf unbekannten Speicher zuzugreifen was zu einem Absturz bei hinzufügen oder lesen eines Paketes. 
-    new_timer->next = NULL;
-
-    
-    if(*head == NULL)
+    struct transport* transport = props->transport;
+    if(transport == NULL)
     {
-        *head = new_timer;
         return;
     }
 
-    // Solange wir nicht am Ende der Liste sind, reduzieren wir die `ticksToGo` des neuen Elements
-    // um die `ticksToGo` des aktuellen Elements.
-    while((*head)->next != NULL)
+    print_transport_statistics(props);
+
+    // Der Kernel darf nicht mehr in die Puffer schreiben, wenn sie freigegeben werden
+    uring_cancel_receives(transport);
+    uring_free(&transport->ring);
+    if(transport->event_fd >= 0)
     {
-        new_timer->ticksToGo -= (*head)->ticksToGo;
-        head = &((*head)->next); // Weiter zum nächsten Element in der Liste.
+        close(transport->event_fd);
     }
 
-    new_timer->ticksToGo -= (*head)->ticksToGo;
-
-
-    // Wenn wir das Ende der Liste erreicht haben, verknüpfen wir das neue Element.
-    (*head)->next = new_timer;
+    free(transport);
+    props->transport = NULL;
 }
 
 
 /**
- * Funktion: del_timer_linked_list_timer
- * --------------------------------
- * Entfernt das erste Element aus der verketteten Liste. Wenn die Liste nur ein Element enthält,
- * wird der Kopf der Liste auf NULL gesetzt.
+ * Funktion: transport_fd
+ * ----------------------
+ * Liefert den Dateideskriptor, der lesbar wird, wenn `receive_cast` etwas liefern kann: 
+ * mit --uring den eventfd des Rings, sonst den Socket.
  *
  * Parameter:
- * - head: Ein Pointer auf das erste Element der verketteten Liste.
+ * - props: Pointer auf die Eigenschaften mit Socket und Transport.
  *
  * Rückgabewert:
- * - Keiner (void).
+ * - Der Dateideskriptor.
  */
-void del_timer_linked_list_timer(struct linked_list_timer** head, int package_id) 
+int transport_fd(struct properties* props)
 {
-    if(*head == NULL) 
+    struct transport* transport = props->transport;
+    if(transport != NULL && transport->event_fd >= 0)
     {
-        // Liste ist leer
-        return;
+        return transport->event_fd;
     }
 
-    // Prüfen, ob der Kopfknoten gelöscht werden soll
-    struct linked_list_timer* current = *head;
-    if(current->packageId == package_id) 
+    return props->sockfd;
+}
+
+
+/**
+ * Funktion: transport_attach_pool
+ * -------------------------------
+ * Bindet einen Paketpool an den Transport an bzw. löst ihn mit `pool` = NULL wieder.
+ *
+ * Parameter:
+ * - props: Pointer auf die Eigenschaften mit den Sende- und Empfangspuffern.
+ * - pool: Der Paketpool, NULL zum Lösen.
+ *
+ * Beschreibung:
+ * - Vorher wird die Sendewarteschlange geleert und alle Referenzen auf den bisherigen 
+ *   Pool werden freigegeben. Der Pool muss dafür noch gültig sein.
+ * - Der Client empfängt ab dem nächsten `recvmmsg` direkt in Puffer des Pools, bereits 
+ *   empfangene Datagramme werden vorher noch aus den alten Puffern abgeholt.
+ * - Mit --uring werden die Empfangsaufträge vorher abgebrochen, da sie noch in die alten 
+ *   Puffer schreiben würden.
+ */
+void transport_attach_pool(struct properties* props, struct packet_pool* pool)
+{
+    struct transport* transport = props->transport;
+    if(transport == NULL)
     {
-        if(current->next != NULL)
-        {
-            current->next->ticksToGo += current->ticksToGo; // Nächster Knoten erhält die verbleibenden Ticks
-        }
-        
-        *head = current->next; // Kopf auf das nächste Element setzen
-        free(current);
         return;
     }
 
-    // Iterieren und nach dem zu löschenden Element suchen
-    struct linked_list_timer* previous = NULL;
+    flush_cast(props);
+    uring_cancel_receives(transport);
 
-    while(current != NULL)
+    if(transport->pool != NULL)
     {
-        if(current->packageId == package_id) 
+        for(int i = 0; i < MAX_BATCH_SIZE; i++)
         {
-            // Knoten gefunden, entfernen
-            if(current->next != NULL) // Wenn es der letzte Knoten ist
+            if(transport->rx_packet[i] != PACKET_NONE)
             {
-                current->next->ticksToGo += current->ticksToGo; // Nächster Knoten erhält die verbleibenden Ticks
+                packet_unref(transport->pool, transport->rx_packet[i]);
+                transport->rx_packet[i] = PACKET_NONE;
             }
-            previous->next = current->next;
-            free(current);
-            return;
+
+            transport->rx_iov[i].iov_base = transport->rx_buffer[i];
+            transport->rx_iov[i].iov_len = MAX_DATAGRAM_SIZE;
         }
 
-        // Pointer aktualisieren
-        previous = current;
-        current = current->next;
+        // Noch nicht abgeholte Datagramme lagen in Puffern des Pools
+        transport->rx_count = 0;
+        transport->rx_next = 0;
     }
-}
-
 
+    transport->pool = pool;
+}
 
 
 /**
- * Funktion: tick_timer_linked_list_timer
- * ---------------------------------
- * Reduziert den `ticksToGo`-Wert des ersten Elements in der verketteten Liste um 1.
- * Wenn `ticksToGo` 0 erreicht, wird das erste Element entfernt und dessen `packageId`
- * zurückgegeben.
+ * Funktion: refill_receive_buffer
+ * -------------------------------
+ * Legt fest, in welchen Puffer der Empfangsplatz `slot` als Nächstes empfängt. Mit 
+ * Paketpool bekommt ein Platz, dessen Puffer noch von einem Fenster gehalten wird, einen 
+ * neuen Puffer.
  *
  * Parameter:
- * - head: Ein Pointer auf das erste Element der verketteten Liste.
+ * - transport: Die Sende- und Empfangspuffer.
+ * - slot: Der Empfangsplatz.
  *
  * Rückgabewert:
- * - -1: Die Liste ist leer.
- * - 0: Die Liste wurde aktualisiert, aber kein Timeout ist aufgetreten.
- * - timeout_package_id: Die `packageId` des Elements, das entfernt wurde.
+ * - 0 bei Erfolg.
+ * - -1 wenn der Pool keinen freien Puffer mehr hat.
  */
-int tick_timer_linked_list_timer(struct linked_list_timer** head)
+static int refill_receive_buffer(struct transport* transport, int slot)
 {
-    // Wenn die Liste leer ist, geben wir -1 zurück.
-    if(*head == NULL)
+    transport->rx_msgs[slot].msg_hdr.msg_namelen = sizeof(transport->rx_addr[slot]);
+
+    if(transport->pool == NULL)
     {
-        return -1;
+        return 0;
     }
 
-    // Reduziere den `ticksToGo`-Wert des ersten Elements um 1.
-    (*head)->ticksToGo -= 1;
+    int packet = transport->rx_packet[slot];
+    if(packet != PACKET_NONE && transport->pool->refcount[packet] > 1)
+    {
+        // Puffer wurde übernommen, Referenz abgeben und neuen Puffer holen
+        packet_unref(transport->pool, packet);
+        packet = PACKET_NONE;
+    }
 
-    // Wenn der `ticksToGo`-Wert des ersten Elements 0 erreicht:
-    if((*head)->ticksToGo <=0)
+    if(packet == PACKET_NONE)
     {
-        // Speichere die `packageId` des Elements, das entfernt wird.
-        int timeout_package_id = (*head)->packageId;
+        packet = packet_alloc(transport->pool);
+        if(packet == PACKET_NONE)
+        {
+            transport->rx_packet[slot] = PACKET_NONE;
+            return -1;
+        }
+    }
+
+    transport->rx_packet[slot] = packet;
+    transport->rx_iov[slot].iov_base = packet_data(transport->pool, packet);
+    transport->rx_iov[slot].iov_len = transport->pool->buffer_size;
 
-        // Entferne das erste Element aus der Liste.
-        del_timer_linked_list_timer(head, (*head)->packageId);
+    return 0;
+}
 
-        // Gib die `packageId` des entfernten Elements zurück.
-        return timeout_package_id;
+
+/**
+ * Funktion: refill_receive_buffers
+ * --------------------------------
+ * Legt vor einem `recvmmsg` mit `refill_receive_buffer` fest, in welche Puffer empfangen wird.
+ *
+ * Parameter:
+ * - transport: Die Sende- und Empfangspuffer.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 wenn der Pool keinen freien Puffer mehr hat.
+ */
+static int refill_receive_buffers(struct transport* transport)
+{
+    for(int i = 0; i < transport->batch_size; i++)
+    {
+        if(refill_receive_buffer(transport, i) < 0)
+        {
+            return -1;
+        }
     }
 
-    // Kein Timeout, Rückgabewert 0.
     return 0;
 }
 
 
-
+#ifdef __linux__
 /**
- * Funktion: print_timer_linked_list_timer
- * ---------------------------------------
- * Gibt die Inhalte einer verketteten Liste von Timern auf der Konsole aus.
- * Jedes Element der Liste enthält eine ID (`packageId`) und eine verbleibende Zeit (`ticksToGo`).
- * 
+ * Funktion: uring_receive
+ * -----------------------
+ * Holt mit --uring die nächsten empfangenen Datagramme ab. Jeder freie Empfangsplatz 
+ * bekommt einen neuen Empfangsauftrag, danach werden die Abschlüsse ohne Systemaufruf 
+ * aus dem Ring gelesen.
+ *
  * Parameter:
- * - head: Ein Pointer auf einen Pointer zum Kopf der verketteten Liste (Struktur `linked_list_timer`).
+ * - transport: Die Sende- und Empfangspuffer mit dem Ring.
  *
  * Rückgabewert:
- * - Keiner (void).
+ * - Anzahl der Datagramme in `rx_order`.
+ * - 0 wenn keines vorliegt, alle Plätze warten dann beim Kernel.
+ * - -1 bei einem Fehler.
  *
  * Beschreibung:
- * - Diese Funktion iteriert über die verkettete Liste, beginnt beim Kopf und gibt die Informationen
- *   jedes Elements in der Liste in der Reihenfolge aus.
- * - Wenn die Liste leer ist (der Kopf zeigt auf `NULL`), wird dies entsprechend gemeldet.
+ * - Die neuen Aufträge gehen zusammen mit einem `io_uring_enter` an den Kernel, liegen 
+ *   schon Datagramme im Socket, sind sie danach meist sofort abgeschlossen.
+ * - Liegt nichts vor, wird der eventfd zurückgesetzt und der Ring noch einmal geprüft, ein 
+ *   Abschluss danach macht den eventfd wieder lesbar.
  */
-void print_timer_linked_list_timer(struct linked_list_timer** head)
+static int uring_receive(struct transport* transport)
 {
-    // Überprüfen, ob die Liste leer ist
-    if(*head == NULL)
+    transport->rx_next = 0;
+    transport->rx_count = 0;
+
+    for(int i = 0; i < transport->batch_size; i++)
     {
-        printf(BLUE "Timer Liste leer\n" RESET);
-        return;
+        if(transport->rx_armed[i])
+        {
+            continue;
+        }
+
+        if(refill_receive_buffer(transport, i) < 0)
+        {
+            print_timestamp();
+            printf(RED "Kein freier Puffer im Paketpool\n" RESET);
+            return -1;
+        }
+
+        struct io_uring_sqe* sqe = uring_get_sqe(&transport->ring);
+        if(sqe == NULL)
+        {
+            break;
+        }
+
+        sqe->opcode = IORING_OP_RECVMSG;
+        sqe->fd = 0; // Feste Datei 0, der Socket
+        sqe->flags = IOSQE_FIXED_FILE;
+        sqe->addr = (unsigned long long)(uintptr_t)&transport->rx_msgs[i].msg_hdr;
+        sqe->len = 1;
+        sqe->user_data = (URING_RECEIVE << 32) | (unsigned long long)i;
+        transport->rx_armed[i] = true;
+    }
+
+    if(transport->ring.pending > 0)
+    {
+        transport->receive_calls += 1;
+        if(uring_submit(&transport->ring, 0) < 0)
+        {
+            print_timestamp();
+            printf(RED "Fehler bei io_uring_enter\n" RESET);
+            perror("\t\t");
+            return -1;
+        }
     }
 
-    // Iterieren durch die verkettete Liste
-    while((*head)->next != NULL)
+    uring_reap(transport, NULL);
+    if(transport->rx_count == 0)
     {
-        // Aktuelles Element ausgeben
-        printf(BLUE "[ID %d ToGo %d] -> ", (*head)->packageId, (*head)->ticksToGo);
-        // Zum nächsten Element wechseln
-        head = &((*head)->next);
+        uint64_t buffer[8];
+        while(read(transport->event_fd, buffer, sizeof(buffer)) > 0);
+        uring_reap(transport, NULL);
     }
-    
-    // Letztes Element ausgeben (ohne "->")
-    printf(BLUE "[ID %d ToGo %d]\n" RESET, (*head)->packageId, (*head)->ticksToGo);
+
+    if(transport->rx_failed)
+    {
+        transport->rx_failed = false;
+        print_timestamp();
+        printf(RED "Fehler bei recvmsg über io_uring\n" RESET);
+        perror("\t\t");
+        return -1;
+    }
+
+    return transport->rx_count;
 }
 
+
+/**
+ * Funktion: uring_send
+ * --------------------
+ * Sendet mit --uring die Sendewarteschlange: Je Datagramm ein Sendeauftrag, alle werden mit 
+ * einem `io_uring_enter` übergeben, das auch auf ihre Abschlüsse wartet.
+ *
+ * Parameter:
+ * - props: Pointer auf die Eigenschaften mit Socket und Sendepuffern.
+ *
+ * Rückgabewert:
+ * - 0 wenn alle Datagramme gesendet wurden.
+ * - -1 wenn mindestens ein Datagramm nicht gesendet werden konnte.
+ *
+ * Beschreibung:
+ * - Während des Wartens weckt der Ring den eventfd nicht, die Ereignisschleife soll nicht 
+ *   wegen der eigenen Sendeaufträge aufwachen. Dabei beendete Empfangsaufträge stehen danach 
+ *   in `rx_order`.
+ * - Datagramme, die mangels Puffer (ENOBUFS) abgelehnt werden, werden nach kurzem Warten 
+ *   erneut gesendet, andere Fehler verwerfen das Datagramm.
+ */
+static int uring_send(struct properties* props)
+{
+    struct transport* transport = props->transport;
+    int results[MAX_BATCH_SIZE];
+    int queue[MAX_BATCH_SIZE];
+    int queued = transport->tx_count;
+    int result = 0;
+
+    for(int i = 0; i < queued; i++)
+    {
+        queue[i] = i;
+    }
+
+    uring_notify(&transport->ring, false);
+
+    while(queued > 0)
+    {
+        int done = 0;
+        for(int i = 0; i < queued; i++)
+        {
+            int slot = queue[i];
+            struct io_uring_sqe* sqe = uring_get_sqe(&transport->ring);
+            if(sqe == NULL)
+            {
+                results[slot] = -EBUSY;
+                done += 1;
+                continue;
+            }
+
+            sqe->opcode = IORING_OP_SENDMSG;
+            sqe->fd = 0; // Feste Datei 0, der Socket
+            sqe->flags = IOSQE_FIXED_FILE;
+            sqe->addr = (unsigned long long)(uintptr_t)&transport->tx_msgs[slot].msg_hdr;
+            sqe->len = 1;
+            sqe->msg_flags = MSG_NOSIGNAL;
+            sqe->user_data = (URING_SEND << 32) | (unsigned long long)slot;
+        }
+
+        while(done < queued)
+        {
+            transport->send_calls += 1;
+            if(uring_submit(&transport->ring, 1) < 0)
+            {
+                print_timestamp();
+                printf(RED "Fehler bei io_uring_enter\n" RESET);
+                perror("\t\t");
+                uring_notify(&transport->ring, true);
+                return -1;
+            }
+
+            done += uring_reap(transport, results);
+        }
+
+        // Ergebnisse auswerten, Datagramme ohne Puffer im Kernel erneut senden
+        int retry = 0;
+        for(int i = 0; i < queued; i++)
+        {
+            int slot = queue[i];
+            if(results[slot] >= 0)
+            {
+                transport->send_packets += 1;
+            }
+            else if(results[slot] == -ENOBUFS || results[slot] == -EAGAIN || results[slot] == -EINTR || results[slot] == -EBUSY)
+            {
+                queue[retry] = slot;
+                retry += 1;
+            }
+            else
+            {
+                errno = -results[slot];
+                print_timestamp();
+                printf(RED "Datagramm konnte nicht gesendet werden\n" RESET);
+                perror("\t\t");
+                result = -1;
+            }
+        }
+
+        queued = retry;
+        if(queued > 0)
+        {
+            // Warten, bis im Sendepuffer wieder Platz ist
+            struct pollfd pfd;
+            pfd.fd = props->sockfd;
+            pfd.events = POLLOUT;
+            pfd.revents = 0;
+            poll(&pfd, 1, DEFAULT_SLOT_TIME);
+        }
+    }
+
+    uring_notify(&transport->ring, true);
+    return result;
+}
+#endif
+
+
+/**
+ * Funktion: enqueue_cast
+ * ----------------------
+ * Kodiert die Nachricht (Server: `req`, Client: `ans`) direkt in den nächsten freien 
+ * Sendepuffer und hängt sie an die Sendewarteschlange an. Ist die Warteschlange voll 
+ * (`batch_size` erreicht), wird sie sofort mit `flush_cast` gesendet.
+ * Liegen die Nutzdaten des Servers außerhalb von `req.data` (`com->payload`, Paketpool oder 
+ * eingeblendete Datei), wird nur der Kopf kodiert und die Nutzdaten werden als zweiter 
+ * iovec direkt gesendet. Ein Puffer des Pools wird bis zum Senden referenziert.
+ *
+ * Parameter:
+ * - props: Pointer auf die Eigenschaften mit den Sendepuffern.
+ * - com: Pointer auf die Kommunikationsstruktur mit der zu sendenden Nachricht.
+ * - dest: Zieladresse.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 wenn die Nachricht nicht kodiert oder die Warteschlange nicht gesendet werden konnte.
+ */
+static int enqueue_cast(struct properties* props, struct communication* com, const struct sockaddr_in6* dest)
+{
+    struct transport* transport = props->transport;
+    int slot = transport->tx_count;
+
+    // Server: Sendezeitpunkt und RTO mitsenden, Client: letzten Zeitstempel des Servers zurückspiegeln 
+    // und die eigene Verlustrate melden
+    if(props->is_server)
+    {
+        com->req.timestamp = (uint32_t)get_time_us();
+        com->req.rto = props->rto;
+    }
+    else
+    {
+        com->ans.echo = props->echo;
+        com->ans.echoDelay = props->echo != 0 ? (uint32_t)(get_time_us() - props->echo_received) : 0;
+        com->ans.lossRate = props->loss_rate;
+    }
+
+    int len;
+    int iov_count = 1;
+    if(props->is_server && com->payload != NULL)
+    {
+        // Kopf in den Sendepuffer, Nutzdaten direkt aus dem Pool bzw. der Datei
+        len = encode_request_header(&com->req, transport->tx_buffer[slot], MAX_DATAGRAM_SIZE);
+        if(len > WIRE_REQUEST_HEADER_SIZE)
+        {
+            transport->tx_iov[slot][1].iov_base = com->payload;
+            transport->tx_iov[slot][1].iov_len = len - WIRE_REQUEST_HEADER_SIZE;
+            if(com->packet != PACKET_NONE && transport->pool != NULL)
+            {
+                packet_ref(transport->pool, com->packet);
+                transport->tx_packet[slot] = com->packet;
+            }
+            iov_count = 2;
+            len = WIRE_REQUEST_HEADER_SIZE;
+        }
+    }
+    else if(props->is_server)
+    {
+        len = encode_request(&com->req, transport->tx_buffer[slot], MAX_DATAGRAM_SIZE);
+    }
+    else
+    {
+        len = encode_answer(&com->ans, transport->tx_buffer[slot], MAX_DATAGRAM_SIZE);
+    }
+
+    if(len < 0)
+    {
+        print_timestamp();
+        printf(RED "Paket konnte nicht kodiert werden\n" RESET);
+        return -1;
+    }
+
+    transport->tx_iov[slot][0].iov_len = len;
+    transport->tx_msgs[slot].msg_hdr.msg_iovlen = iov_count;
+    transport->tx_addr[slot] = *dest;
+    transport->tx_count += 1;
+
+    if(transport->tx_count >= transport->batch_size)
+    {
+        return flush_cast(props);
+    }
+
+    return 0;
+}
+
+
+
+/**
+ * Funktion: send_unicast
+ * ----------------------
+ * Diese Funktion sendet eine Unicast-Nachricht an einen spezifischen Partner
+ * unter Verwendung eines definierten Sockets. Die Nachricht wird an die
+ * in der `communication`-Struktur angegebene Zieladresse adressiert und in die
+ * Sendewarteschlange gestellt. Gesendet wird gebündelt mit `flush_cast`, spätestens
+ * vor dem nächsten Warten in `event_loop_wait`.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf eine Struktur `properties`, die den Socket 
+ *          enthält, über den die Nachricht gesendet wird.
+ * - com: Ein Pointer auf eine Struktur `communication`, die die Nachricht 
+ *        (`ans`) und die Zieladresseninformationen (`partner`) enthält.
+ *
+ * Rückgabewert:
+ * - 0 bei erfolgreichem Senden der Unicast-Nachricht.
+ * - -1 bei Fehlern, z. B. wenn das Senden einer vollen Warteschlange fehlschlägt.
+ */
+int send_unicast(struct properties *props, struct communication* com) 
+{    
+    // Nachricht für den angegebenen Partner in die Sendewarteschlange stellen
+    if(enqueue_cast(props, com, &com->partner) < 0) 
+    {
+        print_timestamp();
+        printf(RED "Unicast konnte nicht gesendet werden\n" RESET); // Fehler beim Senden
+        return -1;
+    }
+
+    // Erfolgreiches Einreihen der Nachricht
+    print_timestamp();
+    printf(GREEN "Unicast gesendet\n" RESET);
+
+    return 0;
+}
+
+
+/**
+ * Funktion: send_multicast
+ * ------------------------
+ * Diese Funktion sendet eine Multicast-Nachricht an die in `start_socket` 
+ * umgewandelte Multicast-Adresse (`multi_addr`) unter Verwendung von IPv6. 
+ * Die Nachricht wird wie bei `send_unicast` in die Sendewarteschlange gestellt.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf eine Struktur `properties`, die die notwendigen 
+ *          Eigenschaften wie den Socket und die Multicast-Adresse enthält.
+ * - com: Ein Pointer auf eine Struktur `communication`, die die Nachricht 
+ *        und die Zielportinformationen enthält.
+ *
+ * Rückgabewert:
+ * - 0 bei erfolgreichem Senden der Multicast-Nachricht.
+ * - -1 bei Problemen beim Senden.
+ */
+int send_multicast(struct properties* props, struct communication* com) 
+{       
+    // Nachricht an die Multicast-Adresse in die Sendewarteschlange stellen
+    if(enqueue_cast(props, com, &props->multi_addr) < 0) 
+    {
+        print_timestamp();
+        printf(RED "Multicast konnte nicht gesendet werden\n" RESET);
+        
+        return -1; // Fehler beim Senden
+    }
+
+    // Erfolgreiches Senden der Nachricht
+    print_timestamp();
+    printf(GREEN "Multicast gesendet\n" RESET);
+
+    return 0;
+}
+
+
+/**
+ * Funktion: flush_cast
+ * --------------------
+ * Sendet alle Datagramme der Sendewarteschlange mit möglichst wenigen Systemaufrufen.
+ *
+ * Parameter:
+ * - props: Pointer auf die Eigenschaften mit Socket und Sendepuffern.
+ *
+ * Rückgabewert:
+ * - 0 wenn alle Datagramme gesendet wurden.
+ * - -1 wenn mindestens ein Datagramm nicht gesendet werden konnte.
+ *
+ * Beschreibung:
+ * - Unter Linux wird `sendmmsg` verwendet, sonst ein `sendmsg` pro Datagramm. Mit --uring 
+ *   sendet `uring_send` über den Ring.
+ * - Ist der Sendepuffer des Sockets voll (EAGAIN), wird mit poll kurz gewartet.
+ * - Ein Datagramm, das mit einem anderen Fehler abgelehnt wird, wird verworfen,
+ *   damit die übrigen Datagramme trotzdem gesendet werden.
+ * - Die Warteschlange ist danach immer leer, Puffer des Pools sind wieder freigegeben.
+ */
+int flush_cast(struct properties* props)
+{
+    struct transport* transport = props->transport;
+    if(transport == NULL || transport->tx_count == 0)
+    {
+        return 0;
+    }
+
+    int result = 0;
+    int sent = 0;
+
+#ifdef __linux__
+    if(transport->ring.fd >= 0)
+    {
+        result = uring_send(props);
+        sent = transport->tx_count;
+    }
+#endif
+
+    while(sent < transport->tx_count)
+    {
+#ifdef __linux__
+        int count = sendmmsg(props->sockfd, &transport->tx_msgs[sent], transport->tx_count - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+#else
+        int count = sendmsg(props->sockfd, &transport->tx_msgs[sent].msg_hdr, 0) < 0 ? -1 : 1;
+#endif
+        transport->send_calls += 1;
+
+        if(count < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+
+            if(errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS)
+            {
+                // Warten, bis im Sendepuffer wieder Platz ist
+                struct pollfd pfd;
+                pfd.fd = props->sockfd;
+                pfd.events = POLLOUT;
+                pfd.revents = 0;
+                poll(&pfd, 1, DEFAULT_SLOT_TIME);
+                continue;
+            }
+
+            print_timestamp();
+            printf(RED "Datagramm konnte nicht gesendet werden\n" RESET);
+            perror("\t\t");
+
+            sent += 1; // Datagramm verwerfen
+            result = -1;
+            continue;
+        }
+
+        sent += count;
+        transport->send_packets += count;
+    }
+
+    // Referenzen auf Puffer des Pools freigeben
+    for(int i = 0; i < transport->tx_count; i++)
+    {
+        if(transport->tx_packet[i] != PACKET_NONE)
+        {
+            packet_unref(transport->pool, transport->tx_packet[i]);
+            transport->tx_packet[i] = PACKET_NONE;
+        }
+    }
+
+    transport->tx_count = 0;
+
+    return result;
+}
+
+
+/**
+ * Funktion: receive_cast
+ * ----------------------
+ * Liest das nächste gültige UDP-Paket aus dem Socket, ohne zu blockieren, und 
+ * verarbeitet die empfangenen Daten. Die Funktion überprüft den Absender und Empfänger 
+ * und ignoriert ungültige oder nicht relevante Nachrichten.
+ *
+ * Parameter:
+ * - props: Pointer auf eine Struktur `properties`, die Sockets und IDs speichert.
+ * - com: Pointer auf eine Struktur `communication`, die die Kommunikationsdaten speichert.
+ * - list: Pointer auf eine Struktur `memberlist`, die bekannte Mitglieder speichert (nur relevant für Server).
+ *
+ * Rückgabewert:
+ * - 1: Paket erfolgreich empfangen und verarbeitet.
+ * - 0: Es wartet kein (gültiges) Paket mehr im Socket.
+ * - -1: Fehler bei `recvmmsg` bzw. `recvfrom`.
+ *
+ * Beschreibung:
+ * - Wenn memberlist NULL ist wird keine Prüfung vorgenommen. Sonst steht der Index des 
+ *   Absenders in der Mitgliederliste in `com->member`. Ein HELLO eines unbekannten Absenders 
+ *   wird mit `com->member` -1 angenommen (später Beitritt).
+ * - Gewartet wird nicht hier, sondern in `event_loop_wait`. Der Aufrufer ruft die Funktion
+ *   so lange auf, bis 0 zurückgegeben wird, und leert damit den Socket vollständig.
+ * - Unter Linux werden mit einem `recvmmsg` bis zu `batch_size` Datagramme auf einmal gelesen
+ *   und bei den folgenden Aufrufen ohne weiteren Systemaufruf zurückgegeben. Mit --uring 
+ *   kommen sie aus den Abschlüssen der Empfangsaufträge (`uring_receive`).
+ * - Prüft Version und Art des Pakets (Server erwartet Antworten, Client Anfragen). 
+ *   Clients nehmen zusätzlich NACKs anderer Clients an (--suppress), `com->kind` 
+ *   unterscheidet sie von Anfragen des Servers.
+ * - Prüft den Absender (Sender-ID) und Empfänger (Receiver-ID) auf Gültigkeit.
+ * - Ignoriert eigene Nachrichten oder Pakete, die für andere Empfänger bestimmt sind.
+ * - Dekodiert die empfangenen Daten in die `communication`-Struktur für die weitere Verarbeitung.
+ * - Mit Paketpool werden die Nutzdaten nicht nach `req.data` kopiert, sondern `com->packet` 
+ *   verweist auf den Puffer. Er bleibt nur gültig, wenn er vor dem nächsten Aufruf mit 
+ *   `packet_ref` (z. B. durch `window_store`) übernommen wird.
+ */
+int receive_cast(struct properties* props, struct communication* com, struct memberlist* list) 
+{
+    struct transport* transport = props->transport;
+
+    while(1) 
+    {
+#ifdef __linux__
+        // Mit --uring liegen die Empfangsaufträge beim Kernel, fertige Plätze stehen im Ring
+        if(transport->ring.fd >= 0 && transport->rx_next >= transport->rx_count)
+        {
+            int count = uring_receive(transport);
+            if(count <= 0)
+            {
+                return count;
+            }
+        }
+#endif
+
+        // Neue Datagramme lesen, wenn alle bisher gelesenen verarbeitet sind
+        if(transport->rx_next >= transport->rx_count)
+        {
+            transport->rx_next = 0;
+            transport->rx_count = 0;
+
+            if(refill_receive_buffers(transport) < 0)
+            {
+                print_timestamp();
+                printf(RED "Kein freier Puffer im Paketpool\n" RESET);
+                return -1;
+            }
+
+#ifdef __linux__
+            int count = recvmmsg(props->sockfd, transport->rx_msgs, transport->batch_size, MSG_DONTWAIT, NULL);
+#else
+            socklen_t partner_len = sizeof(transport->rx_addr[0]);
+            ssize_t bytes_received = recvfrom(props->sockfd, transport->rx_iov[0].iov_base, transport->rx_iov[0].iov_len, MSG_DONTWAIT, (struct sockaddr *)&transport->rx_addr[0], &partner_len);
+            transport->rx_msgs[0].msg_len = bytes_received < 0 ? 0 : (unsigned int)bytes_received;
+            int count = bytes_received < 0 ? -1 : 1;
+#endif
+            transport->receive_calls += 1;
+
+            if(count < 0) 
+            {
+                if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                {
+                    return 0; // Socket ist leer
+                }
+
+                print_timestamp();
+                printf(RED "Fehler bei recvmmsg\n" RESET); // Fehler beim Empfang
+                perror("\t\t");
+                return -1;
+            }
+
+            transport->rx_count = count;
+            transport->receive_packets += count;
+        }
+
+        // Nächstes Datagramm aus dem Puffer nehmen
+        int slot = transport->rx_order[transport->rx_next];
+        transport->rx_next += 1;
+
+        unsigned char* buffer = transport->rx_iov[slot].iov_base;
+        size_t len = transport->rx_msgs[slot].msg_len;
+        com->partner = transport->rx_addr[slot];
+
+        // Kopf dekodieren und Version prüfen
+        struct wire_header header;
+        if(decode_header(buffer, len, &header) < 0)
+        {
+            print_timestamp();
+            printf("Paket mit ungültigem Kopf oder unbekannter Version ignoriert\n");
+            continue;
+        }
+
+        // Server erwartet Antworten, Client erwartet Anfragen und hört NACKs anderer Clients mit
+        bool peer_nack = !props->is_server && header.kind == WIRE_KIND_ANSWER && header.type == ANS_NACK;
+        if(header.kind != (props->is_server ? WIRE_KIND_ANSWER : WIRE_KIND_REQUEST) && !peer_nack)
+        {
+            print_timestamp();
+            printf("Paket falscher Art ignoriert\n");
+            continue;
+        }
+
+        // ID des Senders prüfen
+        int sender_id = header.senderId;
+        if(sender_id == props->id) 
+        {
+            print_timestamp();
+            printf("Nachricht von eigener ID ignoriert\n"); // Eigene Nachricht ignorieren
+            continue;
+        }
+
+        // Für Server: Prüfen, ob Sender bekannt ist, ein HELLO eines Unbekannten bittet um späten Beitritt
+        com->member = -1;
+        if(props->is_server && list != NULL)
+        {   
+            com->member = member_find(list, sender_id, &com->partner.sin6_addr);
+            if(com->member < 0 && header.type != ANS_HELLO)
+            {
+                print_timestamp();
+                printf("Paket von unbekanntem Sender ignoriert\n"); 
+                continue;
+            }
+        }
+
+        // ID des Empfängers prüfen
+        int receiver_id = header.reciverId;
+        if(receiver_id != props->id && receiver_id != -1 && !peer_nack) 
+        {
+            print_timestamp();
+            printf("Paket für anderen Empfänger ignoriert\n");
+            continue;
+        }
+
+        // Nachricht dekodieren
+        int result;
+        com->packet = PACKET_NONE;
+        com->payload = NULL;
+        com->kind = header.kind;
+        if(props->is_server || peer_nack) 
+        {
+            result = decode_answer(buffer, len, &com->ans); // Für Server und mitgehörte NACKs
+        } 
+        else if(transport->pool != NULL)
+        {
+            // Nutzdaten bleiben im Puffer des Pools, übernommen wird nur das Handle
+            result = decode_request_header(buffer, len, &com->req);
+            com->req.data[0] = '\0';
+            com->packet = transport->rx_packet[slot];
+            com->payload = (char*)buffer + WIRE_REQUEST_HEADER_SIZE;
+        }
+        else 
+        {
+            result = decode_request(buffer, len, &com->req); // Für Client
+        }
+
+        if(result < 0)
+        {
+            print_timestamp();
+            printf("Ungültiges Paket ignoriert\n");
+            continue;
+        }
+
+        // Client: Zeitstempel für das Echo in der nächsten Antwort merken und das RTO übernehmen
+        if(!props->is_server && !peer_nack)
+        {
+            props->echo = com->req.timestamp;
+            props->echo_received = get_time_us();
+            if(com->req.rto >= MIN_RTO && com->req.rto <= MAX_RTO)
+            {
+                props->rto = com->req.rto;
+            }
+        }
+
+        print_timestamp();
+        printf(GREEN "Paket empfangen\n" RESET);
+        print_timestamp();
+        printf("Sender ID: %d\n", sender_id);
+        
+        return 1; // Erfolgreich empfangen
+    }
+}
+
+
+/**
+ * Funktion: put_u16 / put_u32 / get_u16 / get_u32
+ * ------------------------------------------------
+ * Schreiben bzw. lesen vorzeichenlose Ganzzahlen in Netzwerk-Byte-Reihenfolge (Big Endian),
+ * unabhängig von Ausrichtung und Byte-Reihenfolge der Plattform.
+ */
+static void put_u16(unsigned char* buffer, uint16_t value)
+{
+    buffer[0] = (unsigned char)(value >> 8);
+    buffer[1] = (unsigned char)(value);
+}
+
+static void put_u32(unsigned char* buffer, uint32_t value)
+{
+    buffer[0] = (unsigned char)(value >> 24);
+    buffer[1] = (unsigned char)(value >> 16);
+    buffer[2] = (unsigned char)(value >> 8);
+    buffer[3] = (unsigned char)(value);
+}
+
+static uint16_t get_u16(const unsigned char* buffer)
+{
+    return (uint16_t)((buffer[0] << 8) | buffer[1]);
+}
+
+static uint32_t get_u32(const unsigned char* buffer)
+{
+    return ((uint32_t)buffer[0] << 24) | ((uint32_t)buffer[1] << 16) | ((uint32_t)buffer[2] << 8) | (uint32_t)buffer[3];
+}
+
+
+/**
+ * Funktion: encode_header
+ * -----------------------
+ * Schreibt den gemeinsamen Kopf eines Pakets in den Puffer.
+ *
+ * Parameter:
+ * - buffer: Zielpuffer, mindestens WIRE_HEADER_SIZE Bytes.
+ * - kind: WIRE_KIND_REQUEST oder WIRE_KIND_ANSWER.
+ * - type: Typ der Anfrage bzw. Antwort.
+ * - sender_id, receiver_id, package_id: Die Felder des Kopfes.
+ */
+static void encode_header(unsigned char* buffer, unsigned char kind, char type, int sender_id, int receiver_id, int package_id)
+{
+    buffer[0] = WIRE_VERSION;
+    buffer[1] = kind;
+    buffer[2] = (unsigned char)type;
+    buffer[3] = 0;
+    put_u32(buffer + 4, (uint32_t)sender_id);
+    put_u32(buffer + 8, (uint32_t)receiver_id);
+    put_u32(buffer + 12, (uint32_t)package_id);
+}
+
+
+/**
+ * Funktion: get_request_payload_size
+ * ----------------------------------
+ * Berechnet, wie viele Bytes Nutzdaten eine Anfrage auf der Leitung trägt.
+ *
+ * Parameter:
+ * - req: Die Anfrage.
+ *
+ * Rückgabewert:
+ * - `packageLen` bei Daten- und Paritätspaketen, 28 bei HELLO, sonst 0.
+ */
+int get_request_payload_size(const struct request* req)
+{
+    if(req->type == REQ_DATA || req->type == REQ_SEGMENT || req->type == REQ_PARITY)
+    {
+        return (int)req->packageLen;
+    }
+
+    if(req->type == REQ_HELLO)
+    {
+        return 28;
+    }
+
+    return 0;
+}
+
+
+/**
+ * Funktion: get_request_wire_size
+ * -------------------------------
+ * Berechnet, wie viele Bytes eine Anfrage kodiert auf der Leitung belegt.
+ *
+ * Parameter:
+ * - req: Die Anfrage.
+ *
+ * Rückgabewert:
+ * - Größe des kodierten Pakets in Bytes.
+ */
+int get_request_wire_size(const struct request* req)
+{
+    int payload_len = get_request_payload_size(req);
+    if(payload_len > 0 && payload_len <= MAX_PAYLOAD_SIZE)
+    {
+        return WIRE_REQUEST_HEADER_SIZE + payload_len;
+    }
+
+    return WIRE_REQUEST_HEADER_SIZE;
+}
+
+
+/**
+ * Funktion: encode_request
+ * ------------------------
+ * Kodiert eine Anfrage in das Paketformat (siehe connection.h). Nur die tatsächlich 
+ * genutzten Bytes von `data` werden übertragen.
+ *
+ * Parameter:
+ * - req: Die zu kodierende Anfrage.
+ * - buffer: Zielpuffer.
+ * - size: Größe des Zielpuffers in Bytes.
+ *
+ * Rückgabewert:
+ * - Anzahl der geschriebenen Bytes.
+ * - -1 wenn die Nutzdaten zu lang sind oder der Puffer zu klein ist.
+ *
+ * Beschreibung:
+ * - Bei Datenpaketen (`REQ_DATA`, `REQ_SEGMENT`) werden `packageLen` Bytes Nutzdaten 
+ *   übertragen, bei Paritätspaketen `packageLen` Bytes Parität, bei HELLO Datei- und 
+ *   Gruppengröße, die FEC-Parameter, die Prüfsumme und den Streifen, bei allen anderen 
+ *   Anfragen keine.
+ */
+int encode_request(const struct request* req, unsigned char* buffer, size_t size)
+{
+    int len = encode_request_header(req, buffer, size);
+    if(len < 0 || size < (size_t)len)
+    {
+        return -1;
+    }
+
+    if(req->type == REQ_HELLO)
+    {
+        put_u32(buffer + WIRE_REQUEST_HEADER_SIZE, (uint32_t)((unsigned long long)req->fileSize >> 32));
+        put_u32(buffer + WIRE_REQUEST_HEADER_SIZE + 4, (uint32_t)req->fileSize);
+        put_u32(buffer + WIRE_REQUEST_HEADER_SIZE + 8, (uint32_t)req->groupSize);
+        put_u16(buffer + WIRE_REQUEST_HEADER_SIZE + 12, (uint16_t)req->fecSource);
+        put_u16(buffer + WIRE_REQUEST_HEADER_SIZE + 14, (uint16_t)req->fecParity);
+        put_u32(buffer + WIRE_REQUEST_HEADER_SIZE + 16, (uint32_t)(req->fileHash >> 32));
+        put_u32(buffer + WIRE_REQUEST_HEADER_SIZE + 20, (uint32_t)req->fileHash);
+        put_u16(buffer + WIRE_REQUEST_HEADER_SIZE + 24, (uint16_t)req->stripe);
+        put_u16(buffer + WIRE_REQUEST_HEADER_SIZE + 26, (uint16_t)req->stripes);
+        return len;
+    }
+
+    memcpy(buffer + WIRE_REQUEST_HEADER_SIZE, req->data, len - WIRE_REQUEST_HEADER_SIZE);
+
+    return len;
+}
+
+
+/**
+ * Funktion: encode_request_header
+ * -------------------------------
+ * Kodiert nur den Kopf einer Anfrage. Die Nutzdaten werden nicht geschrieben, sie werden 
+ * beim Senden aus einem Puffer des Paketpools direkt hinter den Kopf gehängt.
+ *
+ * Parameter:
+ * - req: Die zu kodierende Anfrage, `data` wird nicht gelesen.
+ * - buffer: Zielpuffer.
+ * - size: Größe des Zielpuffers in Bytes, mindestens WIRE_REQUEST_HEADER_SIZE.
+ *
+ * Rückgabewert:
+ * - Größe des ganzen Datagramms (Kopf und Nutzdaten) in Bytes.
+ * - -1 wenn die Nutzdaten zu lang sind oder der Puffer zu klein ist.
+ */
+int encode_request_header(const struct request* req, unsigned char* buffer, size_t size)
+{
+    long payload_len = get_request_payload_size(req);
+    if(payload_len < 0 || payload_len > MAX_PAYLOAD_SIZE || size < WIRE_REQUEST_HEADER_SIZE)
+    {
+        return -1;
+    }
+
+    encode_header(buffer, WIRE_KIND_REQUEST, req->type, req->senderId, req->reciverId, req->packageId);
+    put_u32(buffer + 16, (uint32_t)req->packageLen);
+    put_u16(buffer + 20, (uint16_t)payload_len);
+    put_u32(buffer + 22, (uint32_t)((unsigned long long)req->offset >> 32));
+    put_u32(buffer + 26, (uint32_t)req->offset);
+    put_u32(buffer + 30, req->timestamp);
+    put_u32(buffer + 34, (uint32_t)req->rto);
+
+    return WIRE_REQUEST_HEADER_SIZE + payload_len;
+}
+
+
+/**
+ * Funktion: encode_answer
+ * -----------------------
+ * Kodiert eine Antwort in das Paketformat (siehe connection.h). Ein NACK oder CATCHUP mit 
+ * Verlust-Bitmap (`lossLen` > 0) wird um die Bitmap verlängert.
+ *
+ * Parameter:
+ * - ans: Die zu kodierende Antwort.
+ * - buffer: Zielpuffer.
+ * - size: Größe des Zielpuffers in Bytes.
+ *
+ * Rückgabewert:
+ * - Anzahl der geschriebenen Bytes.
+ * - -1 wenn der Puffer zu klein ist.
+ */
+int encode_answer(const struct answer* ans, unsigned char* buffer, size_t size)
+{
+    bool has_map = (ans->type == ANS_NACK || ans->type == ANS_CATCHUP) && ans->lossLen > 0;
+    int len = has_map ? WIRE_NACK_HEADER_SIZE + ans->lossLen : WIRE_ANSWER_HEADER_SIZE;
+    if(size < (size_t)len || (has_map && ans->lossLen > NACK_BITMAP_SIZE))
+    {
+        return -1;
+    }
+
+    encode_header(buffer, WIRE_KIND_ANSWER, ans->type, ans->senderId, ans->reciverId, ans->packageId);
+    put_u32(buffer + WIRE_HEADER_SIZE, ans->echo);
+    put_u32(buffer + WIRE_HEADER_SIZE + 4, ans->echoDelay);
+    put_u32(buffer + WIRE_HEADER_SIZE + 8, (uint32_t)(ans->lossRate * LOSS_RATE_SCALE + 0.5));
+
+    if(has_map)
+    {
+        put_u16(buffer + WIRE_ANSWER_HEADER_SIZE, (uint16_t)ans->lossLen);
+        memcpy(buffer + WIRE_NACK_HEADER_SIZE, ans->lossMap, ans->lossLen);
+    }
+
+    return len;
+}
+
+
+/**
+ * Funktion: decode_header
+ * -----------------------
+ * Dekodiert den gemeinsamen Kopf eines empfangenen Pakets.
+ *
+ * Parameter:
+ * - buffer: Empfangene Daten.
+ * - len: Anzahl der empfangenen Bytes.
+ * - header: Ausgabe des dekodierten Kopfes.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 wenn das Paket zu kurz ist oder eine andere Version hat.
+ */
+int decode_header(const unsigned char* buffer, size_t len, struct wire_header* header)
+{
+    if(len < WIRE_HEADER_SIZE || buffer[0] != WIRE_VERSION)
+    {
+        return -1;
+    }
+
+    header->version = buffer[0];
+    header->kind = buffer[1];
+    header->type = (char)buffer[2];
+    header->senderId = (int)get_u32(buffer + 4);
+    header->reciverId = (int)get_u32(buffer + 8);
+    header->packageId = (int)get_u32(buffer + 12);
+
+    return 0;
+}
+
+
+/**
+ * Funktion: decode_request
+ * ------------------------
+ * Dekodiert eine empfangene Anfrage. Hinter den Nutzdaten wird eine 0 geschrieben, 
+ * sodass Textdaten immer nullterminiert sind.
+ *
+ * Parameter:
+ * - buffer: Empfangene Daten.
+ * - len: Anzahl der empfangenen Bytes.
+ * - req: Ausgabe der dekodierten Anfrage.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 wenn das Paket keine gültige Anfrage ist.
+ */
+int decode_request(const unsigned char* buffer, size_t len, struct request* req)
+{
+    int payload_len = decode_request_header(buffer, len, req);
+    if(payload_len < 0)
+    {
+        return -1;
+    }
+
+    memcpy(req->data, buffer + WIRE_REQUEST_HEADER_SIZE, payload_len);
+    req->data[payload_len] = '\0';
+
+    return 0;
+}
+
+
+/**
+ * Funktion: decode_request_header
+ * -------------------------------
+ * Prüft eine empfangene Anfrage wie `decode_request`, dekodiert aber nur den Kopf. Die 
+ * Nutzdaten bleiben ab WIRE_REQUEST_HEADER_SIZE im Empfangspuffer liegen.
+ *
+ * Parameter:
+ * - buffer: Empfangene Daten.
+ * - len: Anzahl der empfangenen Bytes.
+ * - req: Ausgabe der dekodierten Anfrage ohne `data`.
+ *
+ * Rückgabewert:
+ * - Länge der Nutzdaten in Bytes.
+ * - -1 wenn das Paket keine gültige Anfrage ist.
+ */
+int decode_request_header(const unsigned char* buffer, size_t len, struct request* req)
+{
+    struct wire_header header;
+    if(decode_header(buffer, len, &header) < 0 || header.kind != WIRE_KIND_REQUEST || len < WIRE_REQUEST_HEADER_SIZE)
+    {
+        return -1;
+    }
+
+    uint16_t payload_len = get_u16(buffer + 20);
+    if(payload_len > MAX_PAYLOAD_SIZE || len != WIRE_REQUEST_HEADER_SIZE + (size_t)payload_len)
+    {
+        return -1;
+    }
+
+    req->senderId = header.senderId;
+    req->reciverId = header.reciverId;
+    req->type = header.type;
+    req->packageId = header.packageId;
+    req->packageLen = (long)(int32_t)get_u32(buffer + 16);
+    req->offset = (long long)(((unsigned long long)get_u32(buffer + 22) << 32) | get_u32(buffer + 26));
+    req->timestamp = get_u32(buffer + 30);
+    req->rto = (int)get_u32(buffer + 34);
+    req->fileSize = -1;
+    req->fileHash = 0;
+    req->groupSize = 0;
+    req->fecSource = 0;
+    req->fecParity = 0;
+    req->stripe = 0;
+    req->stripes = 1;
+
+    const unsigned char* payload = buffer + WIRE_REQUEST_HEADER_SIZE;
+    if(req->type == REQ_HELLO && payload_len >= 8)
+    {
+        req->fileSize = (long long)(((unsigned long long)get_u32(payload) << 32) | get_u32(payload + 4));
+    }
+
+    if(req->type == REQ_HELLO && payload_len >= 12)
+    {
+        req->groupSize = (int)get_u32(payload + 8);
+    }
+
+    if(req->type == REQ_HELLO && payload_len >= 16)
+    {
+        req->fecSource = get_u16(payload + 12);
+        req->fecParity = get_u16(payload + 14);
+    }
+
+    if(req->type == REQ_HELLO && payload_len >= 24)
+    {
+        req->fileHash = ((unsigned long long)get_u32(payload + 16) << 32) | get_u32(payload + 20);
+    }
+
+    if(req->type == REQ_HELLO && payload_len >= 28)
+    {
+        req->stripe = get_u16(payload + 24);
+        req->stripes = get_u16(payload + 26);
+    }
+
+    return payload_len;
+}
+
+
+/**
+ * Funktion: decode_answer
+ * -----------------------
+ * Dekodiert eine empfangene Antwort.
+ *
+ * Parameter:
+ * - buffer: Empfangene Daten.
+ * - len: Anzahl der empfangenen Bytes.
+ * - ans: Ausgabe der dekodierten Antwort.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 wenn das Paket keine gültige Antwort ist.
+ */
+int decode_answer(const unsigned char* buffer, size_t len, struct answer* ans)
+{
+    struct wire_header header;
+    if(decode_header(buffer, len, &header) < 0 || header.kind != WIRE_KIND_ANSWER || len < WIRE_ANSWER_HEADER_SIZE)
+    {
+        return -1;
+    }
+
+    ans->echo = get_u32(buffer + WIRE_HEADER_SIZE);
+    ans->echoDelay = get_u32(buffer + WIRE_HEADER_SIZE + 4);
+    ans->lossRate = get_u32(buffer + WIRE_HEADER_SIZE + 8) / LOSS_RATE_SCALE;
+
+    ans->lossLen = 0;
+    if(len != WIRE_ANSWER_HEADER_SIZE)
+    {
+        // Nur ein NACK oder CATCHUP darf eine Verlust-Bitmap tragen
+        if((header.type != ANS_NACK && header.type != ANS_CATCHUP) || len < WIRE_NACK_HEADER_SIZE)
+        {
+            return -1;
+        }
+
+        uint16_t map_len = get_u16(buffer + WIRE_ANSWER_HEADER_SIZE);
+        if(map_len > NACK_BITMAP_SIZE || len != WIRE_NACK_HEADER_SIZE + (size_t)map_len)
+        {
+            return -1;
+        }
+
+        memcpy(ans->lossMap, buffer + WIRE_NACK_HEADER_SIZE, map_len);
+        ans->lossLen = map_len;
+    }
+
+    ans->senderId = header.senderId;
+    ans->reciverId = header.reciverId;
+    ans->type = header.type;
+    ans->packageId = header.packageId;
+
+    return 0;
+}
+
+
+/**
+ * Funktion: nack_mark_loss
+ * ------------------------
+ * Trägt ein weiteres fehlendes Paket in die Verlust-Bitmap eines NACKs ein. `packageId` 
+ * des NACKs muss bereits gesetzt sein, eingetragen werden nur die Pakete dahinter.
+ *
+ * Parameter:
+ * - ans: Das NACK.
+ * - package_id: Die ID des fehlenden Pakets.
+ *
+ * Rückgabewert:
+ * - true wenn das Paket im NACK angefordert wird.
+ * - false wenn es nicht mehr in die Bitmap passt.
+ */
+bool nack_mark_loss(struct answer* ans, int package_id)
+{
+    if(package_id == ans->packageId)
+    {
+        return true;
+    }
+
+    int bit = package_id - ans->packageId - 1;
+    if(bit < 0 || bit >= NACK_BITMAP_SIZE * 8)
+    {
+        return false;
+    }
+
+    // Neu belegte Bytes der Bitmap löschen
+    while(ans->lossLen <= bit / 8)
+    {
+        ans->lossMap[ans->lossLen] = 0;
+        ans->lossLen += 1;
+    }
+
+    ans->lossMap[bit / 8] |= (unsigned char)(1 << (bit % 8));
+    return true;
+}
+
+
+/**
+ * Funktion: nack_next_loss
+ * ------------------------
+ * Liefert das nächste fehlende Paket eines NACKs hinter `package_id`. Zusammen mit 
+ * `packageId` als Startwert werden so alle angeforderten Pakete aufgezählt.
+ *
+ * Parameter:
+ * - ans: Das NACK.
+ * - package_id: Die zuletzt gelieferte Paket-ID.
+ *
+ * Rückgabewert:
+ * - Die nächste fehlende Paket-ID.
+ * - -1 wenn keine weiteren Pakete fehlen.
+ */
+int nack_next_loss(const struct answer* ans, int package_id)
+{
+    int bit = package_id < ans->packageId ? 0 : package_id - ans->packageId;
+    for(; bit < ans->lossLen * 8; bit++)
+    {
+        if(ans->lossMap[bit / 8] & (1 << (bit % 8)))
+        {
+            return ans->packageId + 1 + bit;
+        }
+    }
+
+    return -1;
+}
+
+
+/**
+ * Funktion: nack_backoff_max_ms / nack_backoff_ms
+ * -----------------------------------------------
+ * Berechnen die längste bzw. eine zufällige Wartezeit, bevor ein Client ein geplantes NACK 
+ * sendet (--suppress). Die längste Wartezeit wächst mit dem Logarithmus der Gruppengröße, 
+ * sodass bei einem Verlust vor allen Empfängern meist nur das früheste NACK gesendet wird 
+ * und die übrigen Clients ihres beim Mithören verwerfen.
+ *
+ * Parameter:
+ * - group_size: Erwartete Anzahl an Empfängern.
+ *
+ * Rückgabewert:
+ * - Wartezeit in Millisekunden.
+ */
+int nack_backoff_max_ms(int group_size)
+{
+    int levels = 1;
+    while(group_size > 1)
+    {
+        group_size >>= 1;
+        levels += 1;
+    }
+
+    return DEFAULT_NACK_BACKOFF * levels;
+}
+
+int nack_backoff_ms(int group_size)
+{
+    return rand() % (nack_backoff_max_ms(group_size) + 1);
+}
+
+
+/**
+ * Funktion: rtt_init
+ * ------------------
+ * Setzt eine RTT-Schätzung auf den Startwert DEFAULT_RTO ohne Messung zurück.
+ *
+ * Parameter:
+ * - rtt: Die Schätzung.
+ */
+void rtt_init(struct rtt_estimator* rtt)
+{
+    rtt->srtt = 0;
+    rtt->rttvar = 0;
+    rtt->rto = DEFAULT_RTO * 1000LL;
+}
+
+
+/**
+ * Funktion: rtt_sample
+ * --------------------
+ * Nimmt eine gemessene RTT nach Jacobson/Karels (RFC 6298) in die Schätzung auf: 
+ * srtt = 7/8 srtt + 1/8 R, rttvar = 3/4 rttvar + 1/4 |srtt - R|, RTO = srtt + 4 rttvar. 
+ * Die erste Messung setzt srtt = R und rttvar = R/2.
+ *
+ * Parameter:
+ * - rtt: Die Schätzung.
+ * - sample_us: Die gemessene RTT in µs.
+ */
+void rtt_sample(struct rtt_estimator* rtt, long long sample_us)
+{
+    if(rtt->srtt == 0)
+    {
+        rtt->srtt = sample_us > 0 ? sample_us : 1;
+        rtt->rttvar = sample_us / 2;
+    }
+    else
+    {
+        long long error = sample_us - rtt->srtt;
+        rtt->rttvar += ((error < 0 ? -error : error) - rtt->rttvar) / 4;
+        rtt->srtt += error / 8;
+    }
+
+    // Mindestens ein Tick des Timer-Rads als Abweichung, wie die Uhrengranularität in RFC 6298
+    long long variance = 4 * rtt->rttvar;
+    if(variance < TIMER_WHEEL_TICK_MS * 1000LL)
+    {
+        variance = TIMER_WHEEL_TICK_MS * 1000LL;
+    }
+
+    rtt->rto = rtt->srtt + variance;
+    if(rtt->rto < MIN_RTO * 1000LL)
+    {
+        rtt->rto = MIN_RTO * 1000LL;
+    }
+    if(rtt->rto > MAX_RTO * 1000LL)
+    {
+        rtt->rto = MAX_RTO * 1000LL;
+    }
+}
+
+
+/**
+ * Funktion: rtt_echo_sample
+ * -------------------------
+ * Berechnet die RTT aus dem zurückgespiegelten Zeitstempel einer Antwort: die seit dem 
+ * Zeitstempel vergangene Zeit abzüglich der Verweildauer beim Client. Gerechnet wird in den 
+ * niederwertigen 32 Bit der monotonen Uhr des Servers, ein Überlauf ist damit unschädlich.
+ *
+ * Parameter:
+ * - ans: Die empfangene Antwort.
+ *
+ * Rückgabewert:
+ * - Die RTT in µs.
+ * - -1 wenn die Antwort keinen Zeitstempel trägt oder die Messung unplausibel ist.
+ */
+long long rtt_echo_sample(const struct answer* ans)
+{
+    if(ans->echo == 0)
+    {
+        return -1;
+    }
+
+    int32_t sample = (int32_t)((uint32_t)get_time_us() - ans->echo - ans->echoDelay);
+    if(sample < 0)
+    {
+        return -1;
+    }
+
+    return sample;
+}
+
+
+/**
+ * Funktion: member_hash
+ * ---------------------
+ * Hashwert eines Mitglieds aus ID und IPv6-Adresse (FNV-1a).
+ */
+static unsigned int member_hash(int member_id, const struct in6_addr* addr)
+{
+    uint32_t hash = 2166136261u;
+    uint32_t id = (uint32_t)member_id;
+
+    for(int i = 0; i < 4; i++)
+    {
+        hash = (hash ^ ((id >> (8 * i)) & 0xFF)) * 16777619u;
+    }
+
+    for(int i = 0; i < 16; i++)
+    {
+        hash = (hash ^ addr->s6_addr[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+
+/**
+ * Funktion: member_slot_of
+ * ------------------------
+ * Sucht den Platz der Hashtabelle, der auf das Mitglied mit dem Index `index` verweist.
+ */
+static unsigned int member_slot_of(const struct memberlist* list, int index)
+{
+    const struct member* member = &list->member[index];
+    unsigned int slot = member_hash(member->member_id, &member->member.sin6_addr) & list->slot_mask;
+
+    while(list->slots[slot] != index)
+    {
+        slot = (slot + 1) & list->slot_mask;
+    }
+
+    return slot;
+}
+
+
+/**
+ * Funktion: member_slot_insert
+ * ----------------------------
+ * Trägt das Mitglied mit dem Index `index` in den ersten freien Platz ab seinem Hashwert ein.
+ */
+static void member_slot_insert(struct memberlist* list, int index)
+{
+    const struct member* member = &list->member[index];
+    unsigned int slot = member_hash(member->member_id, &member->member.sin6_addr) & list->slot_mask;
+
+    while(list->slots[slot] != MEMBER_SLOT_FREE)
+    {
+        slot = (slot + 1) & list->slot_mask;
+    }
+
+    list->slots[slot] = index;
+}
+
+
+/**
+ * Funktion: member_count_acked
+ * ----------------------------
+ * Zählt ein Mitglied mit der Bestätigung `acked` im Ring der Mitgliederliste (`delta` 1) 
+ * oder nimmt es heraus (`delta` -1). Nur Bestätigungen oberhalb von `ack_base` werden gezählt.
+ */
+static void member_count_acked(struct memberlist* list, int acked, int delta)
+{
+    if(acked > list->ack_base)
+    {
+        list->ack_counts[acked & list->ack_mask] += delta;
+        list->ack_ahead += delta;
+    }
+}
+
+
+/**
+ * Funktion: memberlist_init
+ * -------------------------
+ * Legt eine leere Mitgliederliste an.
+ *
+ * Parameter:
+ * - list: Die Mitgliederliste.
+ * - window_size: Fenstergröße des Servers. Bestätigungen reichen höchstens bis zur ID nach 
+ *   dem CLOSE, also bis zu `window_size` + 1 über `ack_base`, so groß ist mindestens der Ring.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg, -1 wenn kein Speicher reserviert werden konnte.
+ */
+int memberlist_init(struct memberlist* list, int window_size)
+{
+    int ring = 1;
+    while(ring < window_size + 2)
+    {
+        ring *= 2;
+    }
+
+    list->number_members = 0;
+    list->capacity = DEFAULT_MEMBER_CAPACITY;
+    list->member = malloc(list->capacity * sizeof(struct member));
+    list->slot_mask = 2 * list->capacity - 1;
+    list->slots = malloc((list->slot_mask + 1) * sizeof(int));
+    list->ack_mask = ring - 1;
+    list->ack_counts = calloc(ring, sizeof(int));
+    list->ack_base = 1;
+    list->ack_ahead = 0;
+
+    if(list->member == NULL || list->slots == NULL || list->ack_counts == NULL)
+    {
+        memberlist_free(list);
+        print_timestamp();
+        printf(RED "Speicher für die Mitgliederliste konnte nicht reserviert werden\n" RESET);
+        return -1;
+    }
+
+    for(int i = 0; i <= list->slot_mask; i++)
+    {
+        list->slots[i] = MEMBER_SLOT_FREE;
+    }
+
+    return 0;
+}
+
+
+/**
+ * Funktion: memberlist_free
+ * -------------------------
+ * Gibt den Speicher der Mitgliederliste frei. Auch für eine mit 0 initialisierte Liste erlaubt.
+ */
+void memberlist_free(struct memberlist* list)
+{
+    free(list->member);
+    free(list->slots);
+    free(list->ack_counts);
+    list->member = NULL;
+    list->slots = NULL;
+    list->ack_counts = NULL;
+    list->number_members = 0;
+    list->capacity = 0;
+}
+
+
+/**
+ * Funktion: memberlist_grow
+ * -------------------------
+ * Verdoppelt die Mitgliederliste und baut die Hashtabelle neu auf. Die Hashtabelle ist dabei 
+ * höchstens zur Hälfte belegt, die Suche bleibt also kurz und endet immer an einem freien Platz.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg, -1 wenn kein Speicher reserviert werden konnte (die Liste bleibt unverändert).
+ */
+static int memberlist_grow(struct memberlist* list)
+{
+    int capacity = list->capacity * 2;
+    struct member* member = realloc(list->member, capacity * sizeof(struct member));
+    if(member == NULL)
+    {
+        return -1;
+    }
+    list->member = member;
+
+    int* slots = malloc(2 * capacity * sizeof(int));
+    if(slots == NULL)
+    {
+        return -1;
+    }
+
+    free(list->slots);
+    list->slots = slots;
+    list->slot_mask = 2 * capacity - 1;
+    list->capacity = capacity;
+
+    for(int i = 0; i <= list->slot_mask; i++)
+    {
+        list->slots[i] = MEMBER_SLOT_FREE;
+    }
+
+    for(int i = 0; i < list->number_members; i++)
+    {
+        member_slot_insert(list, i);
+    }
+
+    return 0;
+}
+
+
+/**
+ * Funktion: member_find
+ * ---------------------
+ * Sucht ein Mitglied über ID und Adresse. Nur der Schlüssel aus beiden ist eindeutig, 
+ * da die ID aus der Startzeit entsteht und mehrere Clients dieselbe haben können.
+ *
+ * Parameter:
+ * - list: Die Mitgliederliste.
+ * - member_id: ID des Absenders.
+ * - addr: IPv6-Adresse des Absenders.
+ *
+ * Rückgabewert:
+ * - Index des Mitglieds in `list->member`, -1 wenn es unbekannt ist.
+ */
+int member_find(const struct memberlist* list, int member_id, const struct in6_addr* addr)
+{
+    if(list->slots == NULL)
+    {
+        return -1;
+    }
+
+    unsigned int slot = member_hash(member_id, addr) & list->slot_mask;
+    while(list->slots[slot] != MEMBER_SLOT_FREE)
+    {
+        const struct member* member = &list->member[list->slots[slot]];
+        if(member->member_id == member_id && IN6_ARE_ADDR_EQUAL(&member->member.sin6_addr, addr))
+        {
+            return list->slots[slot];
+        }
+
+        slot = (slot + 1) & list->slot_mask;
+    }
+
+    return -1;
+}
+
+
+/**
+ * Funktion: member_add
+ * --------------------
+ * Registriert ein Mitglied. Ein bereits bekanntes Mitglied (z. B. durch ein wiederholtes HELLO) 
+ * wird nicht doppelt eingetragen.
+ *
+ * Parameter:
+ * - list: Die Mitgliederliste.
+ * - member_id: ID des Mitglieds.
+ * - addr: Adresse des Mitglieds, an sie gehen Wiederholungen per Unicast.
+ *
+ * Rückgabewert:
+ * - Index des Mitglieds in `list->member`, -1 wenn kein Speicher reserviert werden konnte.
+ */
+int member_add(struct memberlist* list, int member_id, const struct sockaddr_in6* addr)
+{
+    int index = member_find(list, member_id, &addr->sin6_addr);
+    if(index >= 0)
+    {
+        return index;
+    }
+
+    if(list->number_members == list->capacity && memberlist_grow(list) < 0)
+    {
+        print_timestamp();
+        printf(RED "Speicher für Mitglied mit ID %d konnte nicht reserviert werden\n" RESET, member_id);
+        return -1;
+    }
+
+    index = list->number_members;
+    list->number_members += 1;
+
+    struct member* member = &list->member[index];
+    member->member_id = member_id;
+    member->member = *addr;
+    rtt_init(&member->rtt);
+    member->loss_rate = 0;
+    member->acked = 1;
+    member->join = 1;
+    member->heard = get_time_us();
+
+    member_slot_insert(list, index);
+    member_count_acked(list, member->acked, 1);
+
+    return index;
+}
+
+
+/**
+ * Funktion: member_remove
+ * -----------------------
+ * Entfernt ein Mitglied. Der Platz in der Hashtabelle wird durch Rückwärtsverschieben der 
+ * folgenden Einträge geschlossen (ohne Grabsteine), das letzte Mitglied rückt auf den freien 
+ * Index nach. Wer Indizes aufbewahrt (z. B. `window_slot.repair_member`), muss Verweise auf 
+ * `index` vorher entfernen und Verweise auf das bisher letzte Mitglied auf `index` umstellen, 
+ * der Server macht das in `session_remove_member`.
+ *
+ * Parameter:
+ * - list: Die Mitgliederliste.
+ * - index: Index des Mitglieds in `list->member`.
+ */
+void member_remove(struct memberlist* list, int index)
+{
+    if(index < 0 || index >= list->number_members)
+    {
+        return;
+    }
+
+    member_count_acked(list, list->member[index].acked, -1);
+
+    // Platz freigeben und nachfolgende Einträge zurückschieben, falls ihr Hashwert es erlaubt
+    unsigned int hole = member_slot_of(list, index);
+    list->slots[hole] = MEMBER_SLOT_FREE;
+
+    unsigned int slot = (hole + 1) & list->slot_mask;
+    while(list->slots[slot] != MEMBER_SLOT_FREE)
+    {
+        const struct member* member = &list->member[list->slots[slot]];
+        unsigned int home = member_hash(member->member_id, &member->member.sin6_addr) & list->slot_mask;
+
+        // Der Eintrag darf nur zurück, wenn sein Hashwert nicht zwischen Lücke und Platz liegt
+        if(((slot - home) & list->slot_mask) >= ((slot - hole) & list->slot_mask))
+        {
+            list->slots[hole] = list->slots[slot];
+            list->slots[slot] = MEMBER_SLOT_FREE;
+            hole = slot;
+        }
+
+        slot = (slot + 1) & list->slot_mask;
+    }
+
+    // Letztes Mitglied auf den freien Index verschieben
+    int last = list->number_members - 1;
+    if(index != last)
+    {
+        list->slots[member_slot_of(list, last)] = index;
+        list->member[index] = list->member[last];
+    }
+
+    list->number_members -= 1;
+}
+
+
+/**
+ * Funktion: member_set_acked
+ * --------------------------
+ * Übernimmt eine kumulative Bestätigung in das Mitglied. Ältere Bestätigungen werden ignoriert.
+ *
+ * Parameter:
+ * - list: Die Mitgliederliste.
+ * - index: Index des Mitglieds.
+ * - acked: Alle Pakete vor dieser ID sind bestätigt, höchstens `window_size` + 1 über `ack_base`.
+ */
+void member_set_acked(struct memberlist* list, int index, int acked)
+{
+    struct member* member = &list->member[index];
+    if(acked <= member->acked)
+    {
+        return;
+    }
+
+    member_count_acked(list, member->acked, -1);
+    member->acked = acked;
+    member_count_acked(list, member->acked, 1);
+}
+
+
+/**
+ * Funktion: member_all_acked
+ * --------------------------
+ * Prüft, ob alle Mitglieder das Paket `ack_base` bestätigt haben.
+ *
+ * Rückgabewert:
+ * - true, wenn es Mitglieder gibt und alle `ack_base` bestätigt haben.
+ */
+bool member_all_acked(const struct memberlist* list)
+{
+    return list->number_members > 0 && list->ack_ahead == list->number_members;
+}
+
+
+/**
+ * Funktion: member_ack_advance
+ * ----------------------------
+ * Wird aufgerufen, wenn das Paket `ack_base` aus dem Fenster entfernt wurde. Mitglieder, die 
+ * genau bis zur neuen `ack_base` bestätigt haben, zählen nicht mehr als voraus.
+ */
+void member_ack_advance(struct memberlist* list)
+{
+    list->ack_base += 1;
+
+    int* count = &list->ack_counts[list->ack_base & list->ack_mask];
+    list->ack_ahead -= *count;
+    *count = 0;
+}
+
+
+/**
+ * Funktion: group_rto_ms
+ * ----------------------
+ * Rechnet das RTO eines Mitglieds in das RTO der Timer des Servers um.
+ *
+ * Parameter:
+ * - props: Eigenschaften des Servers mit Paketgröße und Rate.
+ * - rto: RTO des Mitglieds in µs.
+ *
+ * Rückgabewert:
+ * - Das RTO in Millisekunden zuzüglich der Sendezeit eines Pakets voller Größe.
+ */
+int group_rto_ms(struct properties* props, long long rto)
+{
+    // Ein Paket voller Größe braucht bei der eingestellten Senderate zusätzlich bis zu `pacing` ms
+    int payload = props->binary ? props->segment_size : DEFAULT_DATA_BUFFER_SIZE;
+    int pacing = ((payload + WIRE_REQUEST_HEADER_SIZE + IPV6_UDP_HEADER_SIZE) * 8 + props->rate - 1) / props->rate;
+
+    return (int)((rto + 999) / 1000) + pacing;
+}
+
+
+/**
+ * Funktion: member_update_feedback
+ * --------------------------------
+ * Übernimmt die Rückmeldung einer Antwort in das Mitglied, von dem sie stammt: Die RTT-Schätzung 
+ * wird aktualisiert, die gemeldete Verlustrate und der Zeitpunkt der Antwort gespeichert. Da 
+ * Daten per Multicast gehen, muss jeder Timer auch auf den entferntesten Empfänger warten. Ein 
+ * größeres RTO wird deshalb sofort übernommen, gesenkt wird es erst beim regelmäßigen Durchlauf 
+ * über alle Mitglieder (`update_congestion`), damit jede Antwort nur ihr eigenes Mitglied kostet.
+ *
+ * Parameter:
+ * - props: Eigenschaften des Servers, `rto` wird aktualisiert.
+ * - list: Die Mitgliederliste.
+ * - index: Index des Absenders (`com->member`), -1 wenn unbekannt.
+ * - ans: Die empfangene Antwort.
+ */
+void member_update_feedback(struct properties* props, struct memberlist* list, int index, const struct answer* ans)
+{
+    if(index < 0 || index >= list->number_members)
+    {
+        return;
+    }
+
+    struct member* member = &list->member[index];
+    member->loss_rate = ans->lossRate;
+    member->heard = get_time_us();
+
+    long long sample = rtt_echo_sample(ans);
+    if(sample >= 0)
+    {
+        rtt_sample(&member->rtt, sample);
+
+        print_timestamp();
+        printf(BLUE "RTT zu Id %d: %.3f ms, geglättet %.3f ms, RTO %.3f ms\n" RESET, 
+            member->member_id, sample / 1000.0, member->rtt.srtt / 1000.0, member->rtt.rto / 1000.0);
+    }
+
+    int rto = group_rto_ms(props, member->rtt.rto);
+    if(rto > props->rto)
+    {
+        props->rto = rto;
+    }
+}
+
+
+/**
+ * Funktion: loss_history_init
+ * ---------------------------
+ * Leert die Verlustintervalle eines Clients.
+ *
+ * Parameter:
+ * - history: Die Verlustintervalle.
+ */
+void loss_history_init(struct loss_history* history)
+{
+    history->count = 0;
+    history->event_start = 0;
+    history->event_time = 0;
+    history->highest = 0;
+}
+
+
+/**
+ * Funktion: loss_history_add
+ * --------------------------
+ * Nimmt ein empfangenes Paket in die Verlustintervalle auf. Überspringt es Paket-IDs, gilt 
+ * die erste übersprungene als Verlust. Liegt sie mehr als eine RTT nach dem Beginn des 
+ * laufenden Verlustereignisses, beginnt ein neues Ereignis und das laufende Intervall wird 
+ * abgeschlossen. Die Pakete vor dem ersten Verlust bilden das erste Intervall. Wiederholungen 
+ * und umsortierte Pakete unterhalb der höchsten ID werden nicht gezählt.
+ *
+ * Parameter:
+ * - history: Die Verlustintervalle.
+ * - package_id: Die ID des empfangenen Pakets.
+ * - rtt_ms: Die RTT in Millisekunden, die ein Verlustereignis zusammenfasst.
+ *
+ * Rückgabewert:
+ * - true wenn ein neues Verlustereignis begonnen hat.
+ */
+bool loss_history_add(struct loss_history* history, int package_id, int rtt_ms)
+{
+    int lost = history->highest + 1;
+    if(package_id <= history->highest)
+    {
+        return false;
+    }
+    history->highest = package_id;
+
+    long long now = get_time_us();
+    if(package_id == lost || (history->event_start > 0 && now - history->event_time <= rtt_ms * 1000LL))
+    {
+        return false;
+    }
+
+    int interval = history->event_start > 0 ? lost - history->event_start : lost - 1;
+    if(interval > 0)
+    {
+        memmove(history->intervals + 1, history->intervals, (LOSS_HISTORY_SIZE - 1) * sizeof(int));
+        history->intervals[0] = interval;
+        if(history->count < LOSS_HISTORY_SIZE)
+        {
+            history->count += 1;
+        }
+    }
+
+    history->event_start = lost;
+    history->event_time = now;
+    return true;
+}
+
+
+/**
+ * Funktion: loss_event_rate
+ * -------------------------
+ * Berechnet die Verlustereignisrate p = 1 / I_mean nach RFC 5348, Abschnitt 5.4. I_mean ist 
+ * das gewichtete Mittel der letzten Intervalle (Gewichte 1, 1, 1, 1, 0.8, 0.6, 0.4, 0.2), 
+ * wobei das laufende Intervall nur mitzählt, wenn es das Mittel erhöht.
+ *
+ * Parameter:
+ * - history: Die Verlustintervalle.
+ *
+ * Rückgabewert:
+ * - Die Verlustereignisrate, 0 ohne Verlust.
+ */
+double loss_event_rate(const struct loss_history* history)
+{
+    static const double weights[LOSS_HISTORY_SIZE] = {1.0, 1.0, 1.0, 1.0, 0.8, 0.6, 0.4, 0.2};
+
+    if(history->event_start == 0)
+    {
+        return 0;
+    }
+
+    // I_tot0 mit dem laufenden Intervall, I_tot1 nur mit den abgeschlossenen
+    double open = history->highest - history->event_start + 1;
+    double total0 = open * weights[0];
+    double total1 = 0;
+    double weight0 = weights[0];
+    double weight1 = 0;
+    for(int i = 0; i < history->count; i++)
+    {
+        if(i + 1 < LOSS_HISTORY_SIZE)
+        {
+            total0 += history->intervals[i] * weights[i + 1];
+            weight0 += weights[i + 1];
+        }
+        total1 += history->intervals[i] * weights[i];
+        weight1 += weights[i];
+    }
+
+    double mean = total0 / weight0;
+    if(weight1 > 0 && total1 / weight1 > mean)
+    {
+        mean = total1 / weight1;
+    }
+
+    return mean > 1 ? 1.0 / mean : 1.0;
+}
+
+
+/**
+ * Funktion: square_root
+ * ---------------------
+ * Quadratwurzel nach dem Newton-Verfahren, damit ohne libm gelinkt werden kann.
+ */
+static double square_root(double x)
+{
+    if(x <= 0)
+    {
+        return 0;
+    }
+
+    double root = x > 1 ? x : 1;
+    for(int i = 0; i < 64; i++)
+    {
+        double next = (root + x / root) / 2;
+        if(next >= root)
+        {
+            break;
+        }
+        root = next;
+    }
+
+    return root;
+}
+
+
+/**
+ * Funktion: tcp_friendly_rate
+ * ---------------------------
+ * Berechnet die Rate, mit der eine TCP-Verbindung unter denselben Bedingungen senden würde 
+ * (RFC 5348, Abschnitt 3.1, mit b = 1 und t_RTO = 4 R):
+ *   X = s / (R sqrt(2p/3) + t_RTO (3 sqrt(3p/8)) p (1 + 32 p^2))
+ *
+ * Parameter:
+ * - size: Paketgröße s in Bytes.
+ * - rtt: RTT R in Sekunden.
+ * - loss_rate: Verlustereignisrate p.
+ *
+ * Rückgabewert:
+ * - Die Rate in Bytes pro Sekunde, 0 wenn p oder R nicht positiv ist.
+ */
+double tcp_friendly_rate(int size, double rtt, double loss_rate)
+{
+    if(loss_rate <= 0 || rtt <= 0)
+    {
+        return 0;
+    }
+
+    double p = loss_rate;
+    double denominator = rtt * square_root(2 * p / 3) 
+        + 4 * rtt * (3 * square_root(3 * p / 8)) * p * (1 + 32 * p * p);
+
+    return size / denominator;
+}
+
+
+/**
+ * Funktion: nack_timeout_ms / release_timeout_ms
+ * ----------------------------------------------
+ * Leiten die Timer beider Seiten aus dem RTO ab. Der Client wartet auf ein fehlendes Paket 
+ * bzw. dessen Wiederholung zwei RTO plus die Sammelzeit des Servers und die längste 
+ * Wartezeit vor einem NACK (--suppress): ein RTO für NACK und Wiederholung, eines für 
+ * Pakete, die der Server wegen eines vollen Fensters erst nach einer Freigabe sendet. 
+ * Der Server gibt ein Paket erst frei, wenn auch ein NACK nach Ablauf des Client-Timers 
+ * noch ein RTO lang hätte ankommen können.
+ *
+ * Parameter:
+ * - props: Eigenschaften mit dem RTO (Server: gemessen, Client: vom Server gemeldet).
+ *
+ * Rückgabewert:
+ * - Timer in Millisekunden.
+ */
+int nack_timeout_ms(struct properties* props)
+{
+    int timeout = 2 * props->rto + DEFAULT_REPAIR_HOLDOFF;
+    if(props->group_size > 0)
+    {
+        timeout += nack_backoff_max_ms(props->group_size);
+    }
+
+    return timeout;
+}
+
+int release_timeout_ms(struct properties* props)
+{
+    return nack_timeout_ms(props) + props->rto;
+}
+
+
+/**
+ * Funktion: print_transport_statistics
+ * ------------------------------------
+ * Gibt aus, wie viele Datagramme mit wie vielen Systemaufrufen gesendet und empfangen wurden.
+ *
+ * Parameter:
+ * - props: Pointer auf die Eigenschaften mit den Sende- und Empfangspuffern.
+ */
+void print_transport_statistics(struct properties* props)
+{
+    struct transport* transport = props->transport;
+    if(transport == NULL)
+    {
+        return;
+    }
+
+    print_timestamp();
+    printf(BLUE "Gesendet: %lld Datagramme mit %lld Systemaufrufen (%.2f pro Aufruf)\n" RESET,
+           transport->send_packets, transport->send_calls,
+           transport->send_calls > 0 ? (double)transport->send_packets / transport->send_calls : 0.0);
+
+    print_timestamp();
+    printf(BLUE "Empfangen: %lld Datagramme mit %lld Systemaufrufen (%.2f pro Aufruf)\n" RESET,
+           transport->receive_packets, transport->receive_calls,
+           transport->receive_calls > 0 ? (double)transport->receive_packets / transport->receive_calls : 0.0);
+}
+
+
+/**
+ * Funktion: event_loop_init
+ * -------------------------
+ * Initialisiert die Ereignisschleife für einen Socket und startet den periodischen Takt.
+ *
+ * Parameter:
+ * - loop: Pointer auf die zu initialisierende Ereignisschleife.
+ * - props: Eigenschaften mit dem Socket, auf dessen Pakete gewartet werden soll.
+ * - tick_ms: Länge eines Ticks in Millisekunden (z. B. DEFAULT_SLOT_TIME).
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 bei Fehlern.
+ *
+ * Beschreibung:
+ * - Unter Linux wird eine epoll-Instanz mit dem Socket und einem timerfd (CLOCK_MONOTONIC) angelegt.
+ * - Auf anderen Systemen wird in `event_loop_wait` mit poll gewartet und der Takt 
+ *   über `get_time_us` berechnet.
+ */
+int event_loop_init(struct event_loop* loop, struct properties* props, int tick_ms)
+{
+    int sockfd = transport_fd(props);
+
+    loop->props = props;
+    loop->sockfd = sockfd;
+    loop->tick_ms = tick_ms;
+    loop->epoll_fd = -1;
+    loop->timer_fd = -1;
+
+#ifdef __linux__
+    loop->epoll_fd = epoll_create1(0);
+    if(loop->epoll_fd < 0)
+    {
+        print_timestamp();
+        printf(RED "epoll konnte nicht erstellt werden\n" RESET);
+        perror("\t\t");
+        return -1;
+    }
+
+    loop->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+    if(loop->timer_fd < 0)
+    {
+        print_timestamp();
+        printf(RED "timerfd konnte nicht erstellt werden\n" RESET);
+        perror("\t\t");
+        event_loop_close(loop);
+        return -1;
+    }
+
+    // Socket und Timer bei epoll registrieren
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+
+    event.data.fd = sockfd;
+    if(epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, sockfd, &event) < 0)
+    {
+        print_timestamp();
+        printf(RED "Socket konnte nicht bei epoll registriert werden\n" RESET);
+        perror("\t\t");
+        event_loop_close(loop);
+        return -1;
+    }
+
+    event.data.fd = loop->timer_fd;
+    if(epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, loop->timer_fd, &event) < 0)
+    {
+        print_timestamp();
+        printf(RED "Timer konnte nicht bei epoll registriert werden\n" RESET);
+        perror("\t\t");
+        event_loop_close(loop);
+        return -1;
+    }
+#endif
+
+    return event_loop_reset(loop);
+}
+
+
+/**
+ * Funktion: event_loop_reset
+ * --------------------------
+ * Startet den Takt der Ereignisschleife neu, sodass der nächste Tick genau `tick_ms` 
+ * Millisekunden nach dem Aufruf erfolgt. Noch nicht abgeholte Ticks werden verworfen.
+ *
+ * Parameter:
+ * - loop: Pointer auf die Ereignisschleife.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 wenn der Timer nicht gesetzt werden konnte.
+ */
+int event_loop_reset(struct event_loop* loop)
+{
+    loop->next_tick = get_time_us() + loop->tick_ms * 1000LL;
+
+#ifdef __linux__
+    struct itimerspec spec;
+    spec.it_interval.tv_sec = loop->tick_ms / 1000;
+    spec.it_interval.tv_nsec = (loop->tick_ms % 1000) * 1000000L;
+    spec.it_value = spec.it_interval;
+
+    if(timerfd_settime(loop->timer_fd, 0, &spec, NULL) < 0)
+    {
+        print_timestamp();
+        printf(RED "Timer konnte nicht gesetzt werden\n" RESET);
+        perror("\t\t");
+        return -1;
+    }
+#endif
+
+    return 0;
+}
+
+
+/**
+ * Funktion: drain_fd
+ * ------------------
+ * Liest einen nicht-blockierenden Dateideskriptor (eventfd bzw. Pipe) leer.
+ *
+ * Parameter:
+ * - fd: Der Dateideskriptor.
+ */
+static void drain_fd(int fd)
+{
+    uint64_t buffer[8];
+    while(read(fd, buffer, sizeof(buffer)) > 0);
+}
+
+
+/**
+ * Funktion: transport_pending
+ * ---------------------------
+ * Prüft, ob `receive_cast` ohne Warten etwas liefern könnte: gelesene, aber nicht abgeholte 
+ * Datagramme oder mit --uring noch nicht ausgewertete Abschlüsse im Ring.
+ *
+ * Parameter:
+ * - transport: Die Sende- und Empfangspuffer, NULL ohne.
+ *
+ * Rückgabewert:
+ * - true wenn nicht gewartet werden soll.
+ */
+static bool transport_pending(struct transport* transport)
+{
+    if(transport == NULL)
+    {
+        return false;
+    }
+
+    if(transport->rx_next < transport->rx_count)
+    {
+        return true;
+    }
+
+#ifdef __linux__
+    return transport->ring.fd >= 0 && uring_peek(&transport->ring) != NULL;
+#else
+    return false;
+#endif
+}
+
+
+/**
+ * Funktion: event_loop_wait
+ * -------------------------
+ * Wartet, bis Pakete im Socket liegen, ein Tick abgelaufen ist oder `timeout_ms` vergangen ist.
+ *
+ * Parameter:
+ * - loop: Pointer auf die Ereignisschleife.
+ * - timeout_ms: Maximale Wartezeit in Millisekunden, -1 wartet bis zum nächsten Ereignis.
+ * - ticks: Ausgabe, Anzahl der seit dem letzten Aufruf abgelaufenen Ticks.
+ *
+ * Rückgabewert:
+ * - 1: Im Socket liegen Pakete, die mit `receive_cast` gelesen werden können.
+ * - 0: Keine Pakete (nur Ticks oder Timeout).
+ * - -1: Fehler beim Warten.
+ *
+ * Beschreibung:
+ * - Sind mehrere Ticks vergangen (z. B. durch eine lange Verarbeitung), werden alle gemeldet,
+ *   damit keine Timer verloren gehen.
+ * - Vor dem Warten wird die Sendewarteschlange mit `flush_cast` gesendet.
+ * - Liegen noch gelesene, aber nicht abgeholte Datagramme im Empfangspuffer oder Abschlüsse 
+ *   im Ring von --uring, wird nicht gewartet.
+ */
+int event_loop_wait(struct event_loop* loop, int timeout_ms, int* ticks)
+{
+    bool readable = false;
+    *ticks = 0;
+
+    flush_cast(loop->props);
+
+    if(transport_pending(loop->props->transport))
+    {
+        readable = true;
+        timeout_ms = 0;
+    }
+
+#ifdef __linux__
+    struct epoll_event events[2];
+    int count = epoll_wait(loop->epoll_fd, events, 2, timeout_ms);
+    if(count < 0)
+    {
+        if(errno == EINTR)
+        {
+            return 0;
+        }
+
+        print_timestamp();
+        printf(RED "Fehler bei epoll_wait()\n" RESET);
+        perror("\t\t");
+        return -1;
+    }
+
+    for(int i = 0; i < count; i++)
+    {
+        if(events[i].data.fd == loop->timer_fd)
+        {
+            // Anzahl der abgelaufenen Ticks auslesen
+            uint64_t expirations = 0;
+            if(read(loop->timer_fd, &expirations, sizeof(expirations)) == sizeof(expirations))
+            {
+                *ticks += (int)expirations;
+            }
+        }
+        else
+        {
+            // Ein Weckmechanismus statt des Sockets (`event_loop_watch`) wird zurückgesetzt, 
+            // den eventfd von --uring setzt `receive_cast` zurück, sobald nichts mehr vorliegt
+            if(events[i].data.fd != transport_fd(loop->props))
+            {
+                drain_fd(events[i].data.fd);
+            }
+            readable = true;
+        }
+    }
+#else
+    // Wartezeit auf den nächsten Tick begrenzen
+    int tick_wait = (int)((loop->next_tick - get_time_us() + 999) / 1000);
+    if(tick_wait < 0)
+    {
+        tick_wait = 0;
+    }
+
+    if(timeout_ms < 0 || tick_wait < timeout_ms)
+    {
+        timeout_ms = tick_wait;
+    }
+
+    struct pollfd pfd;
+    pfd.fd = loop->sockfd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    int count = poll(&pfd, 1, timeout_ms);
+    if(count < 0 && errno != EINTR)
+    {
+        print_timestamp();
+        printf(RED "Fehler bei poll()\n" RESET);
+        perror("\t\t");
+        return -1;
+    }
+
+    if(count > 0 && (pfd.revents & POLLIN))
+    {
+        if(loop->sockfd != transport_fd(loop->props))
+        {
+            drain_fd(loop->sockfd);
+        }
+        readable = true;
+    }
+
+    long long now = get_time_us();
+    while(now >= loop->next_tick)
+    {
+        *ticks += 1;
+        loop->next_tick += loop->tick_ms * 1000LL;
+    }
+#endif
+
+    return readable ? 1 : 0;
+}
+
+
+/**
+ * Funktion: event_loop_fd
+ * -----------------------
+ * Liefert einen Dateideskriptor, der lesbar wird, sobald `event_loop_wait` nicht mehr warten 
+ * müsste. Damit kann ein Thread mit poll auf die Ereignisschleifen mehrerer Sitzungen warten.
+ *
+ * Parameter:
+ * - loop: Pointer auf die Ereignisschleife.
+ *
+ * Rückgabewert:
+ * - Unter Linux die epoll-Instanz (Socket und Takt), sonst der Socket.
+ */
+int event_loop_fd(struct event_loop* loop)
+{
+#ifdef __linux__
+    return loop->epoll_fd;
+#else
+    return loop->sockfd;
+#endif
+}
+
+
+/**
+ * Funktion: event_loop_watch
+ * --------------------------
+ * Überwacht statt des Sockets einen anderen Dateideskriptor, z. B. den Weckmechanismus eines 
+ * Threads, der den Socket selbst liest (--pipeline). Er wird beim Aufwachen leer gelesen.
+ *
+ * Parameter:
+ * - loop: Pointer auf die Ereignisschleife.
+ * - fd: Der zu überwachende, nicht-blockierende Dateideskriptor.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 wenn der Dateideskriptor nicht bei epoll registriert werden konnte.
+ */
+int event_loop_watch(struct event_loop* loop, int fd)
+{
+#ifdef __linux__
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+
+    epoll_ctl(loop->epoll_fd, EPOLL_CTL_DEL, loop->sockfd, NULL);
+    if(epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0)
+    {
+        print_timestamp();
+        printf(RED "Dateideskriptor konnte nicht bei epoll registriert werden\n" RESET);
+        perror("\t\t");
+        return -1;
+    }
+#endif
+
+    loop->sockfd = fd;
+    return 0;
+}
+
+
+/**
+ * Funktion: event_loop_wait_ms
+ * ----------------------------
+ * Begrenzt eine Wartezeit, die außerhalb von `event_loop_wait` mit `event_loop_fd` gewartet 
+ * wird, auf den nächsten Tick, wenn ihn kein timerfd meldet. Liegen noch gelesene, aber 
+ * nicht abgeholte Datagramme im Empfangspuffer, wird nicht gewartet.
+ *
+ * Parameter:
+ * - loop: Pointer auf die Ereignisschleife.
+ * - timeout_ms: Gewünschte Wartezeit in Millisekunden, -1 für unbegrenzt.
+ *
+ * Rückgabewert:
+ * - Die Wartezeit in Millisekunden, -1 für unbegrenzt.
+ */
+int event_loop_wait_ms(struct event_loop* loop, int timeout_ms)
+{
+    if(transport_pending(loop->props->transport))
+    {
+        return 0;
+    }
+
+#ifndef __linux__
+    int tick_wait = (int)((loop->next_tick - get_time_us() + 999) / 1000);
+    if(tick_wait < 0)
+    {
+        tick_wait = 0;
+    }
+
+    if(timeout_ms < 0 || tick_wait < timeout_ms)
+    {
+        timeout_ms = tick_wait;
+    }
+#endif
+
+    return timeout_ms;
+}
+
+
+/**
+ * Funktion: event_loop_close
+ * --------------------------
+ * Gibt die Ressourcen der Ereignisschleife frei. Der Socket selbst wird nicht geschlossen.
+ *
+ * Parameter:
+ * - loop: Pointer auf die Ereignisschleife.
+ */
+void event_loop_close(struct event_loop* loop)
+{
+    if(loop->timer_fd >= 0)
+    {
+        close(loop->timer_fd);
+        loop->timer_fd = -1;
+    }
+
+    if(loop->epoll_fd >= 0)
+    {
+        close(loop->epoll_fd);
+        loop->epoll_fd = -1;
+    }
+}
+
+
+
+/**
+ * Funktion: timer_wheel_init
+ * --------------------------
+ * Legt ein hierarchisches Timer-Rad an. Die Knoten aller Timer liegen in einem vorab 
+ * reservierten Feld, der Knoten einer Paket-ID ist `packageId & mask`. Damit sind Einfügen, 
+ * Löschen und Ablaufen ohne Suche und ohne malloc möglich.
+ *
+ * Parameter:
+ * - wheel: Das anzulegende Timer-Rad.
+ * - capacity: Anzahl gleichzeitig laufender Timer, wird auf eine Zweierpotenz aufgerundet 
+ *             (üblicherweise die Kapazität des Fensters).
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 wenn kein Speicher reserviert werden konnte.
+ *
+ * Beschreibung:
+ * - Ebene 0 hat TIMER_WHEEL_LEVEL0_SLOTS Fächer zu je TIMER_WHEEL_TICK_MS Millisekunden, 
+ *   jede weitere Ebene TIMER_WHEEL_LEVEL_SLOTS Fächer, die jeweils eine ganze Umdrehung 
+ *   der Ebene darunter abdecken. Läuft eine Ebene über, werden die Timer des nächsten 
+ *   Fachs der Ebene darüber neu einsortiert.
+ * - Die Zeit kommt aus `get_time_us` (monotone Uhr), nicht aus der Anzahl der Schleifendurchläufe.
+ */
+int timer_wheel_init(struct timer_wheel* wheel, int capacity)
+{
+    int size = 1;
+    while(size < capacity)
+    {
+        size <<= 1;
+    }
+
+    wheel->capacity = size;
+    wheel->mask = size - 1;
+    wheel->count = 0;
+    wheel->current = get_time_us() / (TIMER_WHEEL_TICK_MS * 1000LL);
+    wheel->nodes = malloc(sizeof(struct timer_node) * size);
+
+    if(wheel->nodes == NULL)
+    {
+        print_timestamp();
+        printf(RED "Speicher für die Timer konnte nicht reserviert werden\n" RESET);
+        return -1;
+    }
+
+    for(int i = 0; i < size; i++)
+    {
+        wheel->nodes[i].bucket = -1;
+    }
+
+    for(int i = 0; i < TIMER_WHEEL_BUCKETS; i++)
+    {
+        wheel->heads[i] = -1;
+    }
+
+    return 0;
+}
+
+
+/**
+ * Funktion: timer_wheel_free
+ * --------------------------
+ * Gibt den Speicher eines Timer-Rads frei. Ein mehrfacher Aufruf ist unschädlich.
+ *
+ * Parameter:
+ * - wheel: Das freizugebende Timer-Rad.
+ */
+void timer_wheel_free(struct timer_wheel* wheel)
+{
+    free(wheel->nodes);
+    wheel->nodes = NULL;
+    wheel->count = 0;
+}
+
+
+/**
+ * Funktion: timer_wheel_link / timer_wheel_unlink
+ * -----------------------------------------------
+ * Hängt einen Knoten in ein Fach ein bzw. aus seinem Fach aus (doppelt verkettet über Indizes).
+ */
+static void timer_wheel_link(struct timer_wheel* wheel, int index, int bucket)
+{
+    struct timer_node* node = &wheel->nodes[index];
+    node->bucket = bucket;
+    node->prev = -1;
+    node->next = wheel->heads[bucket];
+
+    if(node->next >= 0)
+    {
+        wheel->nodes[node->next].prev = index;
+    }
+    wheel->heads[bucket] = index;
+}
+
+static void timer_wheel_unlink(struct timer_wheel* wheel, int index)
+{
+    struct timer_node* node = &wheel->nodes[index];
+
+    if(node->prev >= 0)
+    {
+        wheel->nodes[node->prev].next = node->next;
+    }
+    else
+    {
+        wheel->heads[node->bucket] = node->next;
+    }
+
+    if(node->next >= 0)
+    {
+        wheel->nodes[node->next].prev = node->prev;
+    }
+
+    node->bucket = -1;
+}
+
+
+/**
+ * Funktion: timer_wheel_place
+ * ---------------------------
+ * Sortiert einen Knoten anhand seines Ablaufzeitpunkts in das passende Fach ein.
+ * Bereits abgelaufene Timer kommen direkt in die Liste der abgelaufenen Timer.
+ */
+static void timer_wheel_place(struct timer_wheel* wheel, int index)
+{
+    long long expires = wheel->nodes[index].expires;
+    long long delta = expires - wheel->current;
+    int bucket;
+
+    if(delta < 0)
+    {
+        bucket = TIMER_WHEEL_EXPIRED;
+    }
+    else if(delta < TIMER_WHEEL_LEVEL0_SLOTS)
+    {
+        bucket = (int)(expires & (TIMER_WHEEL_LEVEL0_SLOTS - 1));
+    }
+    else
+    {
+        // Ebene suchen, deren Umdrehung den Abstand abdeckt
+        int level = 1;
+        int shift = TIMER_WHEEL_LEVEL0_BITS;
+        while(level < TIMER_WHEEL_LEVELS - 1 && delta >= (1LL << (shift + TIMER_WHEEL_LEVEL_BITS)))
+        {
+            level += 1;
+            shift += TIMER_WHEEL_LEVEL_BITS;
+        }
+
+        // Sehr lange Timer werden auf die größte darstellbare Zeit begrenzt
+        if(delta >= (1LL << (shift + TIMER_WHEEL_LEVEL_BITS)))
+        {
+            expires = wheel->current + (1LL << (shift + TIMER_WHEEL_LEVEL_BITS)) - 1;
+            wheel->nodes[index].expires = expires;
+        }
+
+        bucket = TIMER_WHEEL_LEVEL0_SLOTS + (level - 1) * TIMER_WHEEL_LEVEL_SLOTS 
+               + (int)((expires >> shift) & (TIMER_WHEEL_LEVEL_SLOTS - 1));
+    }
+
+    timer_wheel_link(wheel, index, bucket);
+}
+
+
+/**
+ * Funktion: timer_wheel_add
+ * -------------------------
+ * Startet den Timer einer Paket-ID. Läuft für den Knoten bereits ein Timer (dieselbe 
+ * Paket-ID oder eine ID, die `capacity` Pakete zurückliegt), wird er ersetzt.
+ *
+ * Parameter:
+ * - wheel: Das Timer-Rad.
+ * - package_id: Die Paket-ID.
+ * - timeout_ms: Zeit bis zum Ablauf in Millisekunden.
+ */
+void timer_wheel_add(struct timer_wheel* wheel, int package_id, int timeout_ms)
+{
+    int index = package_id & wheel->mask;
+    struct timer_node* node = &wheel->nodes[index];
+
+    if(node->bucket >= 0)
+    {
+        timer_wheel_unlink(wheel, index);
+        wheel->count -= 1;
+    }
+
+    long long now = get_time_us() / (TIMER_WHEEL_TICK_MS * 1000LL);
+    node->package_id = package_id;
+    node->expires = now + (timeout_ms + TIMER_WHEEL_TICK_MS - 1) / TIMER_WHEEL_TICK_MS;
+
+    timer_wheel_place(wheel, index);
+    wheel->count += 1;
+}
+
+
+/**
+ * Funktion: timer_wheel_del
+ * -------------------------
+ * Stoppt den Timer einer Paket-ID. Läuft kein Timer für die ID, passiert nichts.
+ *
+ * Parameter:
+ * - wheel: Das Timer-Rad.
+ * - package_id: Die Paket-ID.
+ */
+void timer_wheel_del(struct timer_wheel* wheel, int package_id)
+{
+    int index = package_id & wheel->mask;
+    struct timer_node* node = &wheel->nodes[index];
+
+    if(node->bucket >= 0 && node->package_id == package_id)
+    {
+        timer_wheel_unlink(wheel, index);
+        wheel->count -= 1;
+    }
+}
+
+
+/**
+ * Funktion: timer_wheel_cascade
+ * -----------------------------
+ * Sortiert alle Timer eines Fachs einer höheren Ebene neu ein, wenn die Ebene darunter 
+ * eine Umdrehung vollendet hat.
+ */
+static void timer_wheel_cascade(struct timer_wheel* wheel, int bucket)
+{
+    int index = wheel->heads[bucket];
+    wheel->heads[bucket] = -1;
+
+    while(index >= 0)
+    {
+        int next = wheel->nodes[index].next;
+        timer_wheel_place(wheel, index);
+        index = next;
+    }
+}
+
+
+/**
+ * Funktion: timer_wheel_advance
+ * -----------------------------
+ * Dreht das Timer-Rad bis zur aktuellen Zeit weiter und sammelt alle abgelaufenen Timer.
+ *
+ * Parameter:
+ * - wheel: Das Timer-Rad.
+ *
+ * Beschreibung:
+ * - Danach werden die abgelaufenen Timer mit `timer_wheel_expire` einzeln abgeholt.
+ * - Ohne laufende Timer wird direkt auf die aktuelle Zeit gesprungen.
+ */
+void timer_wheel_advance(struct timer_wheel* wheel)
+{
+    long long now = get_time_us() / (TIMER_WHEEL_TICK_MS * 1000LL);
+
+    if(wheel->count == 0)
+    {
+        wheel->current = now + 1;
+        return;
+    }
+
+    while(wheel->current <= now)
+    {
+        int slot = (int)(wheel->current & (TIMER_WHEEL_LEVEL0_SLOTS - 1));
+
+        // Nach einer Umdrehung die Fächer der höheren Ebenen einsortieren
+        if(slot == 0)
+        {
+            int shift = TIMER_WHEEL_LEVEL0_BITS;
+            for(int level = 1; level < TIMER_WHEEL_LEVELS; level++)
+            {
+                int index = (int)((wheel->current >> shift) & (TIMER_WHEEL_LEVEL_SLOTS - 1));
+                timer_wheel_cascade(wheel, TIMER_WHEEL_LEVEL0_SLOTS + (level - 1) * TIMER_WHEEL_LEVEL_SLOTS + index);
+
+                if(index != 0)
+                {
+                    break;
+                }
+                shift += TIMER_WHEEL_LEVEL_BITS;
+            }
+        }
+
+        // Alle Timer des aktuellen Fachs sind abgelaufen
+        int index = wheel->heads[slot];
+        wheel->heads[slot] = -1;
+        while(index >= 0)
+        {
+            int next = wheel->nodes[index].next;
+            timer_wheel_link(wheel, index, TIMER_WHEEL_EXPIRED);
+            index = next;
+        }
+
+        wheel->current += 1;
+    }
+}
+
+
+/**
+ * Funktion: timer_wheel_expire
+ * ----------------------------
+ * Entfernt einen abgelaufenen Timer und gibt seine Paket-ID zurück.
+ *
+ * Parameter:
+ * - wheel: Das Timer-Rad.
+ *
+ * Rückgabewert:
+ * - Die Paket-ID des abgelaufenen Timers.
+ * - 0 wenn kein Timer mehr abgelaufen ist.
+ *
+ * Beschreibung:
+ * - Wird nach `timer_wheel_advance` so lange aufgerufen, bis 0 zurückgegeben wird.
+ */
+int timer_wheel_expire(struct timer_wheel* wheel)
+{
+    int index = wheel->heads[TIMER_WHEEL_EXPIRED];
+    if(index < 0)
+    {
+        return 0;
+    }
+
+    timer_wheel_unlink(wheel, index);
+    wheel->count -= 1;
+
+    return wheel->nodes[index].package_id;
+}
+
+
+/**
+ * Funktion: timer_wheel_next_ms
+ * -----------------------------
+ * Berechnet, wie lange höchstens gewartet werden darf, bis der nächste Timer abläuft.
+ *
+ * Parameter:
+ * - wheel: Das Timer-Rad.
+ *
+ * Rückgabewert:
+ * - Wartezeit in Millisekunden, 0 wenn bereits Timer abgelaufen sind.
+ * - -1 wenn kein Timer läuft.
+ *
+ * Beschreibung:
+ * - Für Timer in höheren Ebenen wird der Beginn ihres Fachs verwendet. Es wird dann 
+ *   höchstens zu früh aufgewacht und neu einsortiert, aber nie zu spät.
+ */
+int timer_wheel_next_ms(struct timer_wheel* wheel)
+{
+    if(wheel->count == 0)
+    {
+        return -1;
+    }
+
+    if(wheel->heads[TIMER_WHEEL_EXPIRED] >= 0)
+    {
+        return 0;
+    }
+
+    long long now = get_time_us() / (TIMER_WHEEL_TICK_MS * 1000LL);
+    long long next = -1;
+
+    // Ebene 0 ab dem aktuellen Fach durchsuchen
+    for(int i = 0; i < TIMER_WHEEL_LEVEL0_SLOTS; i++)
+    {
+        long long tick = wheel->current + i;
+        if(wheel->heads[tick & (TIMER_WHEEL_LEVEL0_SLOTS - 1)] >= 0)
+        {
+            next = tick;
+            break;
+        }
+    }
+
+    // Sonst das erste belegte Fach einer höheren Ebene
+    int shift = TIMER_WHEEL_LEVEL0_BITS;
+    for(int level = 1; next < 0 && level < TIMER_WHEEL_LEVELS; level++)
+    {
+        // Das Fach des laufenden Abschnitts wurde bereits einsortiert, daher ab dem nächsten suchen
+        for(int i = 1; i <= TIMER_WHEEL_LEVEL_SLOTS; i++)
+        {
+            long long start = ((wheel->current >> shift) + i) << shift;
+            int index = (int)((start >> shift) & (TIMER_WHEEL_LEVEL_SLOTS - 1));
+            if(wheel->heads[TIMER_WHEEL_LEVEL0_SLOTS + (level - 1) * TIMER_WHEEL_LEVEL_SLOTS + index] >= 0)
+            {
+                next = start;
+                break;
+            }
+        }
+        shift += TIMER_WHEEL_LEVEL_BITS;
+    }
+
+    if(next <= now)
+    {
+        return 0;
+    }
+
+    return (int)((next - now) * TIMER_WHEEL_TICK_MS);
+}
+
+
+/**
+ * Funktion: timer_wheel_wait_ms
+ * -----------------------------
+ * Begrenzt eine Wartezeit auf den Ablauf des nächsten Timers.
+ *
+ * Parameter:
+ * - wheel: Das Timer-Rad.
+ * - wait_ms: Gewünschte Wartezeit in Millisekunden, -1 für unbegrenzt.
+ *
+ * Rückgabewert:
+ * - Die kleinere der beiden Wartezeiten, -1 wenn beide unbegrenzt sind.
+ */
+int timer_wheel_wait_ms(struct timer_wheel* wheel, int wait_ms)
+{
+    int timer_ms = timer_wheel_next_ms(wheel);
+
+    if(timer_ms >= 0 && (wait_ms < 0 || timer_ms < wait_ms))
+    {
+        return timer_ms;
+    }
+
+    return wait_ms;
+}
+
+
+/**
+ * Funktion: print_timer_wheel
+ * ---------------------------
+ * Gibt alle laufenden Timer mit ihrer Restzeit in Millisekunden aus.
+ *
+ * Parameter:
+ * - wheel: Das Timer-Rad.
+ */
+void print_timer_wheel(struct timer_wheel* wheel)
+{
+    if(wheel->nodes == NULL || wheel->count == 0)
+    {
+        printf(BLUE "Timer Liste leer\n" RESET);
+        return;
+    }
+
+    long long now = get_time_us() / (TIMER_WHEEL_TICK_MS * 1000LL);
+    int printed = 0;
+
+    printf(BLUE);
+    for(int bucket = 0; bucket < TIMER_WHEEL_BUCKETS; bucket++)
+    {
+        for(int index = wheel->heads[bucket]; index >= 0; index = wheel->nodes[index].next)
+        {
+            if(printed >= 10)
+            {
+                printf(" ... (%d Timer)\n" RESET, wheel->count);
+                return;
+            }
+
+            printf("%s[ID %d in %lld ms]", printed > 0 ? " -> " : "", wheel->nodes[index].package_id, 
+                   (wheel->nodes[index].expires - now) * TIMER_WHEEL_TICK_MS);
+            printed += 1;
+        }
+    }
+
+    printf("\n" RESET);
+}
+
+
+
+/**
+ * Funktion: pacer_init
+ * --------------------
+ * Initialisiert einen Token-Bucket mit einer Auffüllrate und einer maximalen Burstgröße.
+ * Der Bucket startet voll, damit das erste Fenster sofort gesendet werden kann.
+ *
+ * Parameter:
+ * - pacer: Ein Pointer auf den zu initialisierenden Token-Bucket.
+ * - rate: Auffüllrate in Bytes pro Sekunde.
+ * - burst: Maximale Anzahl an Bytes, die ohne Pause gesendet werden dürfen.
+ *
+ * Rückgabewert:
+ * - Keiner (void).
+ */
+void pacer_init(struct pacer* pacer, double rate, double burst)
+{
+    pacer->rate = rate;
+    pacer->burst = burst;
+    pacer->tokens = burst;
+    pacer->last_refill = get_time_us();
+}
+
+
+/**
+ * Funktion: pacer_refill
+ * ----------------------
+ * Füllt den Token-Bucket entsprechend der seit der letzten Auffüllung vergangenen Zeit auf.
+ *
+ * Parameter:
+ * - pacer: Ein Pointer auf den Token-Bucket.
+ *
+ * Rückgabewert:
+ * - Keiner (void).
+ */
+void pacer_refill(struct pacer* pacer)
+{
+    long long now = get_time_us();
+
+    pacer->tokens += pacer->rate * (double)(now - pacer->last_refill) / 1000000.0;
+    if(pacer->tokens > pacer->burst)
+    {
+        pacer->tokens = pacer->burst; // Nicht mehr als einen Burst ansparen
+    }
+
+    pacer->last_refill = now;
+}
+
+
+/**
+ * Funktion: pacer_consume
+ * -----------------------
+ * Entnimmt dem Token-Bucket Tokens für ein Paket, wenn genug vorhanden sind.
+ *
+ * Parameter:
+ * - pacer: Ein Pointer auf den Token-Bucket.
+ * - bytes: Größe des zu sendenden Pakets in Bytes.
+ *
+ * Rückgabewert:
+ * - true: Das Paket darf sofort gesendet werden.
+ * - false: Es sind noch nicht genug Tokens vorhanden.
+ */
+bool pacer_consume(struct pacer* pacer, int bytes)
+{
+    pacer_refill(pacer);
+
+    if(pacer->tokens < bytes)
+    {
+        return false;
+    }
+
+    pacer->tokens -= bytes;
+    return true;
+}
+
+
+/**
+ * Funktion: pacer_charge
+ * ----------------------
+ * Entnimmt dem Token-Bucket Tokens für ein Paket, das in jedem Fall gesendet wird 
+ * (z. B. eine Wiederholung nach einem NACK). Der Bucket darf dabei negativ werden,
+ * sodass nachfolgende Datenpakete entsprechend später gesendet werden.
+ *
+ * Parameter:
+ * - pacer: Ein Pointer auf den Token-Bucket.
+ * - bytes: Größe des gesendeten Pakets in Bytes.
+ *
+ * Rückgabewert:
+ * - Keiner (void).
+ */
+void pacer_charge(struct pacer* pacer, int bytes)
+{
+    pacer_refill(pacer);
+    pacer->tokens -= bytes;
+}
+
+
+/**
+ * Funktion: pacer_set_rate
+ * ------------------------
+ * Ändert die Auffüllrate des Token-Buckets. Die bis jetzt angesparten Tokens werden 
+ * vorher noch mit der alten Rate gutgeschrieben.
+ *
+ * Parameter:
+ * - pacer: Ein Pointer auf den Token-Bucket.
+ * - rate: Neue Auffüllrate in Bytes pro Sekunde.
+ */
+void pacer_set_rate(struct pacer* pacer, double rate)
+{
+    pacer_refill(pacer);
+    pacer->rate = rate;
+}
+
+
+/**
+ * Funktion: pacer_wait_ms
+ * -----------------------
+ * Berechnet, wie lange gewartet werden muss, bis genug Tokens für ein Paket vorhanden sind.
+ *
+ * Parameter:
+ * - pacer: Ein Pointer auf den Token-Bucket.
+ * - bytes: Größe des zu sendenden Pakets in Bytes.
+ *
+ * Rückgabewert:
+ * - Wartezeit in Millisekunden (aufgerundet), 0 wenn sofort gesendet werden darf.
+ */
+int pacer_wait_ms(struct pacer* pacer, int bytes)
+{
+    pacer_refill(pacer);
+
+    if(pacer->tokens >= bytes)
+    {
+        return 0;
+    }
+
+    return (int)((bytes - pacer->tokens) * 1000.0 / pacer->rate) + 1;
+}
+
+
+/**
+ * Funktion: packet_pool_init
+ * --------------------------
+ * Legt einen Paketpool mit `count` Puffern zu je `buffer_size` Bytes an. Alle Puffer 
+ * liegen in einem Speicherblock und werden über eine Freiliste ohne malloc vergeben.
+ *
+ * Parameter:
+ * - pool: Der anzulegende Pool.
+ * - count: Anzahl der Puffer.
+ * - buffer_size: Größe eines Puffers in Bytes (Kopf und Nutzdaten eines Datagramms).
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 wenn kein Speicher reserviert werden konnte.
+ */
+int packet_pool_init(struct packet_pool* pool, int count, int buffer_size)
+{
+    pool->count = count;
+    pool->buffer_size = buffer_size;
+    pool->refcount = calloc(count, sizeof(int));
+    pool->next_free = malloc(sizeof(int) * count);
+    pool->memory = malloc((size_t)count * buffer_size);
+
+    if(pool->refcount == NULL || pool->next_free == NULL || pool->memory == NULL)
+    {
+        print_timestamp();
+        printf(RED "Speicher für den Paketpool konnte nicht reserviert werden\n" RESET);
+        packet_pool_free(pool);
+        return -1;
+    }
+
+    for(int i = 0; i < count; i++)
+    {
+        pool->next_free[i] = (i + 1 < count) ? i + 1 : PACKET_NONE;
+    }
+    pool->free_head = 0;
+
+    return 0;
+}
+
+
+/**
+ * Funktion: packet_pool_free
+ * --------------------------
+ * Gibt den Speicher eines Paketpools frei. Ein mehrfacher Aufruf ist unschädlich.
+ *
+ * Parameter:
+ * - pool: Der freizugebende Pool.
+ */
+void packet_pool_free(struct packet_pool* pool)
+{
+    free(pool->refcount);
+    free(pool->next_free);
+    free(pool->memory);
+
+    pool->refcount = NULL;
+    pool->next_free = NULL;
+    pool->memory = NULL;
+    pool->count = 0;
+    pool->free_head = PACKET_NONE;
+}
+
+
+/**
+ * Funktion: packet_alloc
+ * ----------------------
+ * Nimmt einen freien Puffer aus dem Pool. Der Aufrufer hält danach die einzige Referenz.
+ *
+ * Parameter:
+ * - pool: Der Paketpool.
+ *
+ * Rückgabewert:
+ * - Handle des Puffers.
+ * - PACKET_NONE wenn alle Puffer belegt sind.
+ */
+int packet_alloc(struct packet_pool* pool)
+{
+    int packet = pool->free_head;
+    if(packet == PACKET_NONE)
+    {
+        return PACKET_NONE;
+    }
+
+    pool->free_head = pool->next_free[packet];
+    pool->refcount[packet] = 1;
+
+    return packet;
+}
+
+
+/**
+ * Funktion: packet_ref / packet_unref
+ * -----------------------------------
+ * Erhöht bzw. verringert die Referenzen eines Puffers. Fällt die Anzahl auf 0, 
+ * kommt der Puffer zurück in die Freiliste.
+ *
+ * Parameter:
+ * - pool: Der Paketpool.
+ * - packet: Handle des Puffers.
+ */
+void packet_ref(struct packet_pool* pool, int packet)
+{
+    pool->refcount[packet] += 1;
+}
+
+void packet_unref(struct packet_pool* pool, int packet)
+{
+    pool->refcount[packet] -= 1;
+    if(pool->refcount[packet] <= 0)
+    {
+        pool->refcount[packet] = 0;
+        pool->next_free[packet] = pool->free_head;
+        pool->free_head = packet;
+    }
+}
+
+
+/**
+ * Funktion: packet_data / packet_payload
+ * --------------------------------------
+ * Liefern den Anfang eines Puffers (Kopf des Datagramms) bzw. seine Nutzdaten 
+ * ab WIRE_REQUEST_HEADER_SIZE.
+ *
+ * Parameter:
+ * - pool: Der Paketpool.
+ * - packet: Handle des Puffers.
+ */
+unsigned char* packet_data(struct packet_pool* pool, int packet)
+{
+    return pool->memory + (size_t)packet * pool->buffer_size;
+}
+
+char* packet_payload(struct packet_pool* pool, int packet)
+{
+    return (char*)packet_data(pool, packet) + WIRE_REQUEST_HEADER_SIZE;
+}
+
+
+/**
+ * Funktion: window_init
+ * ---------------------
+ * Legt ein Fenster als Ringpuffer an. Die Anzahl der Plätze wird auf die nächste 
+ * Zweierpotenz aufgerundet, damit der Platz einer Paket-ID mit einer Maske berechnet werden kann.
+ * Der Paketpool des Fensters hat zusätzlich zu einem Puffer je Platz Reserven für 
+ * Puffer, die noch in der Sende- oder Empfangswarteschlange des Transports liegen.
+ *
+ * Parameter:
+ * - window: Das anzulegende Fenster.
+ * - window_size: Anzahl der Pakete, die gleichzeitig im Fenster liegen können.
+ * - payload_size: Maximale Nutzdaten pro Paket in Bytes.
+ * - keep_payload: false wenn die Nutzdaten nie im Fenster gehalten werden (Client im 
+ *                 Binärmodus schreibt sie sofort), dann hat der Pool nur die Reserven.
+ * - extra: Zusätzliche Puffer für Pakete außerhalb des Fensters: beim Server schon gelesene 
+ *          (--pipeline), beim Client noch nicht geschriebene (--writequeue), sonst 0.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 wenn kein Speicher reserviert werden konnte.
+ */
+int window_init(struct window* window, int window_size, int payload_size, bool keep_payload, int extra)
+{
+    int capacity = 1;
+    while(capacity < window_size)
+    {
+        capacity <<= 1;
+    }
+
+    window->capacity = capacity;
+    window->mask = capacity - 1;
+    window->payload_size = payload_size;
+    window->flags = calloc(capacity, sizeof(unsigned char));
+    window->slots = calloc(capacity, sizeof(struct window_slot));
+
+    if(window->flags == NULL || window->slots == NULL)
+    {
+        print_timestamp();
+        printf(RED "Speicher für das Fenster konnte nicht reserviert werden\n" RESET);
+        window_free(window);
+        return -1;
+    }
+
+    for(int i = 0; i < capacity; i++)
+    {
+        window->slots[i].packet = PACKET_NONE;
+        window->slots[i].data = NULL;
+    }
+
+    if(packet_pool_init(&window->pool, (keep_payload ? capacity : 0) + extra + 2 * MAX_BATCH_SIZE, WIRE_REQUEST_HEADER_SIZE + payload_size) < 0)
+    {
+        window_free(window);
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/**
+ * Funktion: window_free
+ * ---------------------
+ * Gibt den Speicher eines Fensters frei. Ein mehrfacher Aufruf ist unschädlich.
+ *
+ * Parameter:
+ * - window: Das freizugebende Fenster.
+ */
+void window_free(struct window* window)
+{
+    free(window->flags);
+    free(window->slots);
+    packet_pool_free(&window->pool);
+
+    window->flags = NULL;
+    window->slots = NULL;
+}
+
+
+/**
+ * Funktion: window_has / window_set / window_unset
+ * ------------------------------------------------
+ * Prüft, setzt bzw. löscht Zustandsbits (WINDOW_*) des Platzes einer Paket-ID.
+ *
+ * Parameter:
+ * - window: Das Fenster.
+ * - package_id: Die Paket-ID.
+ * - flag: Die Zustandsbits.
+ */
+bool window_has(struct window* window, int package_id, unsigned char flag)
+{
+    return (window->flags[package_id & window->mask] & flag) != 0;
+}
+
+void window_set(struct window* window, int package_id, unsigned char flag)
+{
+    window->flags[package_id & window->mask] |= flag;
+}
+
+void window_unset(struct window* window, int package_id, unsigned char flag)
+{
+    window->flags[package_id & window->mask] &= (unsigned char)~flag;
+}
+
+
+/**
+ * Funktion: window_clear
+ * ----------------------
+ * Gibt den Platz einer Paket-ID frei, sodass er für die Paket-ID + `capacity` genutzt werden kann.
+ * Die Referenz auf den Puffer der Nutzdaten wird abgegeben.
+ *
+ * Parameter:
+ * - window: Das Fenster.
+ * - package_id: Die Paket-ID.
+ */
+void window_clear(struct window* window, int package_id)
+{
+    struct window_slot* slot = window_get_slot(window, package_id);
+    if(slot->packet != PACKET_NONE)
+    {
+        packet_unref(&window->pool, slot->packet);
+        slot->packet = PACKET_NONE;
+    }
+    slot->data = NULL;
+
+    window->flags[package_id & window->mask] = 0;
+}
+
+
+/**
+ * Funktion: window_get_slot / window_get_payload
+ * ----------------------------------------------
+ * Liefern die Kopfdaten bzw. die Nutzdaten des Platzes einer Paket-ID.
+ * Liegen die Nutzdaten außerhalb des Pools (`window_set_data`), wird dieser Zeiger geliefert, 
+ * hat der Platz gar keine Nutzdaten, liefert `window_get_payload` NULL.
+ *
+ * Parameter:
+ * - window: Das Fenster.
+ * - package_id: Die Paket-ID.
+ */
+struct window_slot* window_get_slot(struct window* window, int package_id)
+{
+    return &window->slots[package_id & window->mask];
+}
+
+char* window_get_payload(struct window* window, int package_id)
+{
+    struct window_slot* slot = window_get_slot(window, package_id);
+    if(slot->packet == PACKET_NONE)
+    {
+        return slot->data;
+    }
+
+    return packet_payload(&window->pool, slot->packet);
+}
+
+
+/**
+ * Funktion: window_reserve
+ * ------------------------
+ * Gibt dem Platz einer Paket-ID einen eigenen Puffer, in den die Nutzdaten direkt 
+ * geschrieben werden (z. B. von `fread`). Wird der bisherige Puffer noch vom Transport 
+ * referenziert, wird ein neuer Puffer genommen statt ihn zu überschreiben.
+ *
+ * Parameter:
+ * - window: Das Fenster.
+ * - package_id: Die Paket-ID.
+ *
+ * Rückgabewert:
+ * - Zeiger auf die Nutzdaten mit Platz für `payload_size` Bytes.
+ * - NULL wenn der Paketpool keinen freien Puffer mehr hat.
+ */
+char* window_reserve(struct window* window, int package_id)
+{
+    struct window_slot* slot = window_get_slot(window, package_id);
+    slot->data = NULL;
+
+    if(slot->packet != PACKET_NONE && window->pool.refcount[slot->packet] > 1)
+    {
+        packet_unref(&window->pool, slot->packet);
+        slot->packet = PACKET_NONE;
+    }
+
+    if(slot->packet == PACKET_NONE)
+    {
+        slot->packet = packet_alloc(&window->pool);
+        if(slot->packet == PACKET_NONE)
+        {
+            print_timestamp();
+            printf(RED "Kein freier Puffer im Paketpool\n" RESET);
+            return NULL;
+        }
+    }
+
+    return packet_payload(&window->pool, slot->packet);
+}
+
+
+/**
+ * Funktion: window_get_wire_size
+ * ------------------------------
+ * Berechnet wie `get_request_wire_size`, wie viele Bytes das Paket einer Paket-ID 
+ * kodiert auf der Leitung belegt, ohne es aus dem Fenster zu laden.
+ *
+ * Parameter:
+ * - window: Das Fenster.
+ * - package_id: Die Paket-ID.
+ *
+ * Rückgabewert:
+ * - Größe des kodierten Pakets in Bytes.
+ */
+int window_get_wire_size(struct window* window, int package_id)
+{
+    struct window_slot* slot = window_get_slot(window, package_id);
+    if((slot->type == REQ_DATA || slot->type == REQ_SEGMENT) && slot->packageLen > 0)
+    {
+        return WIRE_REQUEST_HEADER_SIZE + (int)slot->packageLen;
+    }
+
+    return WIRE_REQUEST_HEADER_SIZE;
+}
+
+
+/**
+ * Funktion: window_set_data
+ * -------------------------
+ * Verknüpft den Platz einer Paket-ID mit Nutzdaten außerhalb des Pools, z. B. direkt in der 
+ * eingeblendeten Datei. Ein Puffer des Pools wird dabei abgegeben.
+ *
+ * Parameter:
+ * - window: Das Fenster.
+ * - package_id: Die Paket-ID.
+ * - data: Die Nutzdaten, müssen gültig bleiben, bis der Platz freigegeben und gesendet ist.
+ */
+void window_set_data(struct window* window, int package_id, char* data)
+{
+    struct window_slot* slot = window_get_slot(window, package_id);
+    if(slot->packet != PACKET_NONE)
+    {
+        packet_unref(&window->pool, slot->packet);
+        slot->packet = PACKET_NONE;
+    }
+
+    slot->data = data;
+}
+
+
+/**
+ * Funktion: window_store
+ * ----------------------
+ * Legt die Kopfdaten eines Pakets im Platz seiner Paket-ID ab und markiert den Platz 
+ * als belegt. Nutzdaten werden nicht kopiert: Sie stehen entweder bereits im Puffer des 
+ * Platzes (`window_reserve`) oder liegen in einem empfangenen Puffer des Pools (`packet`), 
+ * der referenziert wird.
+ *
+ * Parameter:
+ * - window: Das Fenster.
+ * - req: Die Kopfdaten des Pakets, `data` wird nicht gelesen.
+ * - packet: Puffer des Pools mit dem ganzen Datagramm, PACKET_NONE für den eigenen Puffer.
+ */
+void window_store(struct window* window, const struct request* req, int packet)
+{
+    struct window_slot* slot = window_get_slot(window, req->packageId);
+    slot->senderId = req->senderId;
+    slot->reciverId = req->reciverId;
+    slot->type = req->type;
+    slot->packageLen = req->packageLen;
+    slot->packageId = req->packageId;
+    slot->offset = req->offset;
+    slot->repaired = 0;
+    slot->repair_count = 0;
+
+    if(packet != PACKET_NONE)
+    {
+        packet_ref(&window->pool, packet);
+        if(slot->packet != PACKET_NONE)
+        {
+            packet_unref(&window->pool, slot->packet);
+        }
+        slot->packet = packet;
+    }
+
+    if(req->type == REQ_DATA || req->type == REQ_SEGMENT)
+    {
+        if(slot->packageLen > window->payload_size)
+        {
+            slot->packageLen = window->payload_size;
+        }
+
+        if(slot->packet == PACKET_NONE && slot->data == NULL)
+        {
+            slot->packageLen = 0;
+        }
+    }
+
+    window->flags[req->packageId & window->mask] = WINDOW_USED;
+}
+
+
+/**
+ * Funktion: window_load
+ * ---------------------
+ * Stellt die Kopfdaten des Pakets einer Paket-ID wieder als `request` her. Die Nutzdaten 
+ * werden nicht kopiert, sondern über das zurückgegebene Handle an den Transport weitergereicht.
+ *
+ * Parameter:
+ * - window: Das Fenster.
+ * - package_id: Die Paket-ID.
+ * - req: Ausgabe der Kopfdaten, `data` bleibt leer.
+ *
+ * Rückgabewert:
+ * - Puffer des Pools mit den Nutzdaten, PACKET_NONE wenn das Paket keine hat.
+ */
+int window_load(struct window* window, int package_id, struct request* req)
+{
+    struct window_slot* slot = window_get_slot(window, package_id);
+    req->senderId = slot->senderId;
+    req->reciverId = slot->reciverId;
+    req->type = slot->type;
+    req->packageLen = slot->packageLen;
+    req->packageId = slot->packageId;
+    req->offset = slot->offset;
+
+    req->data[0] = '\0';
+
+    return slot->packet;
+}
+
+
+/**
+ * Funktion: fec_init
+ * ------------------
+ * Legt die Streifen der Vorwärtsfehlerkorrektur für `blocks` gleichzeitig offene Blöcke an.
+ *
+ * Parameter:
+ * - fec: Die anzulegende Struktur.
+ * - source: Quellpakete je Block (n), höchstens MAX_FEC_SOURCE.
+ * - parity: Paritätspakete je Block (k), höchstens `source`.
+ * - payload_size: Maximale Nutzdaten eines Quellpakets in Bytes.
+ * - blocks: Anzahl der Blöcke im Ring, 1 beim Server.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 wenn kein Speicher reserviert werden konnte.
+ */
+int fec_init(struct fec* fec, int source, int parity, int payload_size, int blocks)
+{
+    int stripes = blocks * parity;
+
+    fec->source = source;
+    fec->parity = parity;
+    fec->payload_size = payload_size;
+    fec->blocks = blocks;
+    fec->block_ids = malloc(blocks * sizeof(int));
+    fec->received = calloc(blocks, sizeof(unsigned long long));
+    fec->data = calloc((size_t)stripes, payload_size);
+    fec->xor_len = calloc(stripes, sizeof(long));
+    fec->max_len = calloc(stripes, sizeof(int));
+    fec->has_parity = calloc(stripes, sizeof(bool));
+
+    if(fec->block_ids == NULL || fec->received == NULL || fec->data == NULL 
+        || fec->xor_len == NULL || fec->max_len == NULL || fec->has_parity == NULL)
+    {
+        print_timestamp();
+        printf(RED "Speicher für die FEC konnte nicht reserviert werden\n" RESET);
+        fec_free(fec);
+        return -1;
+    }
+
+    for(int i = 0; i < blocks; i++)
+    {
+        fec->block_ids[i] = -1;
+    }
+
+    return 0;
+}
+
+
+/**
+ * Funktion: fec_free
+ * ------------------
+ * Gibt den Speicher der Vorwärtsfehlerkorrektur frei. Ein mehrfacher Aufruf ist unschädlich.
+ *
+ * Parameter:
+ * - fec: Die freizugebende Struktur.
+ */
+void fec_free(struct fec* fec)
+{
+    free(fec->block_ids);
+    free(fec->received);
+    free(fec->data);
+    free(fec->xor_len);
+    free(fec->max_len);
+    free(fec->has_parity);
+
+    fec->block_ids = NULL;
+    fec->received = NULL;
+    fec->data = NULL;
+    fec->xor_len = NULL;
+    fec->max_len = NULL;
+    fec->has_parity = NULL;
+    fec->source = 0;
+}
+
+
+/**
+ * Funktion: fec_block_start
+ * -------------------------
+ * Liefert die ID des ersten Quellpakets im Block einer Paket-ID.
+ *
+ * Parameter:
+ * - fec: Die FEC-Parameter.
+ * - package_id: Die Paket-ID, Paket-IDs beginnen bei 1.
+ */
+int fec_block_start(struct fec* fec, int package_id)
+{
+    return ((package_id - 1) / fec->source) * fec->source + 1;
+}
+
+
+/**
+ * Funktion: fec_stripe
+ * --------------------
+ * Liefert den Index des Streifens einer Paket-ID. Belegt ein anderer Block den Ringplatz, 
+ * wird der Platz für den neuen Block geleert.
+ *
+ * Parameter:
+ * - fec: Die FEC-Struktur.
+ * - package_id: Die ID eines Quellpakets bzw. die Paket-ID eines Paritätspakets.
+ * - position: Ausgabe der Position des Pakets im Block.
+ *
+ * Rückgabewert:
+ * - Index des Streifens in `data`, `xor_len`, `max_len` und `has_parity`.
+ */
+static int fec_stripe(struct fec* fec, int package_id, int* position)
+{
+    int block = (package_id - 1) / fec->source;
+    int slot = block % fec->blocks;
+    *position = (package_id - 1) % fec->source;
+
+    if(fec->block_ids[slot] != block)
+    {
+        int first = slot * fec->parity;
+        memset(fec->data + (size_t)first * fec->payload_size, 0, (size_t)fec->parity * fec->payload_size);
+        memset(fec->xor_len + first, 0, fec->parity * sizeof(long));
+        memset(fec->max_len + first, 0, fec->parity * sizeof(int));
+        memset(fec->has_parity + first, 0, fec->parity * sizeof(bool));
+        fec->received[slot] = 0;
+        fec->block_ids[slot] = block;
+    }
+
+    return slot * fec->parity + *position % fec->parity;
+}
+
+
+/**
+ * Funktion: fec_add_source
+ * ------------------------
+ * Rechnet ein Quellpaket in die Parität seines Streifens ein. Jedes Paket darf nur einmal 
+ * eingerechnet werden, der Server rechnet nur die erste Übertragung ein.
+ *
+ * Parameter:
+ * - fec: Die FEC-Struktur.
+ * - req: Die Kopfdaten des Quellpakets.
+ * - payload: Die Nutzdaten des Quellpakets (`packageLen` Bytes).
+ *
+ * Rückgabewert:
+ * - true wenn das Paket das letzte seines Blocks war und die Parität gesendet werden kann.
+ */
+bool fec_add_source(struct fec* fec, const struct request* req, const char* payload)
+{
+    int position;
+    int stripe = fec_stripe(fec, req->packageId, &position);
+    int len = req->packageLen < 0 ? 0 : (req->packageLen > fec->payload_size ? fec->payload_size : (int)req->packageLen);
+
+    unsigned char* data = fec->data + (size_t)stripe * fec->payload_size;
+    for(int i = 0; i < len; i++)
+    {
+        data[i] ^= (unsigned char)payload[i];
+    }
+
+    fec->xor_len[stripe] ^= len;
+    if(len > fec->max_len[stripe])
+    {
+        fec->max_len[stripe] = len;
+    }
+    fec->received[stripe / fec->parity] |= 1ULL << position;
+
+    return position == fec->source - 1;
+}
+
+
+/**
+ * Funktion: fec_add_parity
+ * ------------------------
+ * Rechnet ein empfangenes Paritätspaket in seinen Streifen ein. Eine Wiederholung desselben 
+ * Paritätspakets wird ignoriert.
+ *
+ * Parameter:
+ * - fec: Die FEC-Struktur.
+ * - req: Die Kopfdaten des Paritätspakets.
+ * - payload: Die Parität (`packageLen` Bytes).
+ */
+void fec_add_parity(struct fec* fec, const struct request* req, const char* payload)
+{
+    int position;
+    int stripe = fec_stripe(fec, req->packageId, &position);
+    if(fec->has_parity[stripe] || position >= fec->parity || req->packageLen > fec->payload_size)
+    {
+        return;
+    }
+
+    unsigned char* data = fec->data + (size_t)stripe * fec->payload_size;
+    for(int i = 0; i < req->packageLen; i++)
+    {
+        data[i] ^= (unsigned char)payload[i];
+    }
+
+    fec->xor_len[stripe] ^= (long)req->offset;
+    fec->has_parity[stripe] = true;
+}
+
+
+/**
+ * Funktion: fec_get_parity
+ * ------------------------
+ * Stellt das Paritätspaket eines Streifens im aktuellen Block des Servers zusammen.
+ *
+ * Parameter:
+ * - fec: Die FEC-Struktur des Servers.
+ * - block_start: ID des ersten Quellpakets im Block.
+ * - stripe: Nummer des Streifens (0 bis `parity` - 1).
+ * - req: Ausgabe des Pakets, die Parität wird nach `data` kopiert.
+ */
+void fec_get_parity(struct fec* fec, int block_start, int stripe, struct request* req)
+{
+    int position;
+    int index = fec_stripe(fec, block_start + stripe, &position);
+
+    req->type = REQ_PARITY;
+    req->packageId = block_start + stripe;
+    req->packageLen = fec->max_len[index];
+    req->offset = fec->xor_len[index];
+    memcpy(req->data, fec->data + (size_t)index * fec->payload_size, fec->max_len[index]);
+}
+
+
+/**
+ * Funktion: fec_recover
+ * ---------------------
+ * Prüft, ob im Streifen einer Paket-ID genau ein Quellpaket fehlt und die Parität vorliegt. 
+ * Dann ist das XOR des Streifens genau dieses Paket.
+ *
+ * Parameter:
+ * - fec: Die FEC-Struktur des Clients.
+ * - package_id: Eine Paket-ID des Streifens (Quell- oder Paritätspaket).
+ * - req: Ausgabe von `packageId` und `packageLen` des wiederhergestellten Pakets.
+ * - payload: Ausgabe der Nutzdaten, gültig bis der Streifen wieder verändert wird.
+ *
+ * Rückgabewert:
+ * - Die ID des wiederhergestellten Pakets.
+ * - -1 wenn der Streifen nicht wiederhergestellt werden kann.
+ */
+int fec_recover(struct fec* fec, int package_id, struct request* req, char** payload)
+{
+    int position;
+    int stripe = fec_stripe(fec, package_id, &position);
+    if(!fec->has_parity[stripe])
+    {
+        return -1;
+    }
+
+    unsigned long long received = fec->received[stripe / fec->parity];
+    int missing = -1;
+    for(int i = position % fec->parity; i < fec->source; i += fec->parity)
+    {
+        if(!(received & (1ULL << i)))
+        {
+            if(missing >= 0)
+            {
+                return -1;
+            }
+            missing = i;
+        }
+    }
+
+    if(missing < 0 || fec->xor_len[stripe] < 0 || fec->xor_len[stripe] > fec->payload_size)
+    {
+        return -1;
+    }
+
+    req->packageId = fec_block_start(fec, package_id) + missing;
+    req->packageLen = fec->xor_len[stripe];
+    *payload = (char*)fec->data + (size_t)stripe * fec->payload_size;
+
+    return req->packageId;
+}
+
+
+/**
+ * Funktion: spsc_ring_init
+ * ------------------------
+ * Legt einen Ring zwischen einem schreibenden und einem lesenden Thread an. Die Anzahl der 
+ * Plätze wird auf die nächste Zweierpotenz aufgerundet.
+ *
+ * Parameter:
+ * - ring: Der anzulegende Ring.
+ * - capacity: Mindestanzahl an Einträgen, die gleichzeitig im Ring liegen können.
+ * - entry_size: Bytes je Eintrag.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 wenn kein Speicher reserviert werden konnte.
+ */
+int spsc_ring_init(struct spsc_ring* ring, int capacity, int entry_size)
+{
+    unsigned int size = 1;
+    while(size < (unsigned int)capacity)
+    {
+        size <<= 1;
+    }
+
+    ring->mask = size - 1;
+    ring->entry_size = entry_size;
+    ring->entries = malloc((size_t)size * entry_size);
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+
+    if(ring->entries == NULL)
+    {
+        print_timestamp();
+        printf(RED "Speicher für den Ring konnte nicht reserviert werden\n" RESET);
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/**
+ * Funktion: spsc_ring_free
+ * ------------------------
+ * Gibt den Speicher eines Rings frei. Ein mehrfacher Aufruf ist unschädlich.
+ *
+ * Parameter:
+ * - ring: Der freizugebende Ring.
+ */
+void spsc_ring_free(struct spsc_ring* ring)
+{
+    free(ring->entries);
+    ring->entries = NULL;
+}
+
+
+/**
+ * Funktion: spsc_ring_reset
+ * -------------------------
+ * Leert den Ring. Darf nur aufgerufen werden, während kein anderer Thread auf den Ring zugreift.
+ *
+ * Parameter:
+ * - ring: Der Ring.
+ */
+void spsc_ring_reset(struct spsc_ring* ring)
+{
+    atomic_store(&ring->head, 0);
+    atomic_store(&ring->tail, 0);
+}
+
+
+/**
+ * Funktion: spsc_ring_push
+ * ------------------------
+ * Hängt einen Eintrag an den Ring an (nur vom schreibenden Thread).
+ *
+ * Parameter:
+ * - ring: Der Ring.
+ * - entry: Der Eintrag mit `entry_size` Bytes.
+ *
+ * Rückgabewert:
+ * - true, wenn der Eintrag angehängt wurde.
+ * - false, wenn der Ring voll ist.
+ *
+ * Beschreibung:
+ * - Der Eintrag wird vor dem Weitersetzen von `head` kopiert (release), der Leser sieht ihn 
+ *   damit erst vollständig.
+ */
+bool spsc_ring_push(struct spsc_ring* ring, const void* entry)
+{
+    unsigned int head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if(head - tail > ring->mask)
+    {
+        return false; // Ring ist voll
+    }
+
+    memcpy(ring->entries + (size_t)(head & ring->mask) * ring->entry_size, entry, ring->entry_size);
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+
+    return true;
+}
+
+
+/**
+ * Funktion: spsc_ring_pop
+ * -----------------------
+ * Entnimmt den ältesten Eintrag aus dem Ring (nur vom lesenden Thread).
+ *
+ * Parameter:
+ * - ring: Der Ring.
+ * - entry: Ausgabe, Puffer für `entry_size` Bytes.
+ *
+ * Rückgabewert:
+ * - true, wenn ein Eintrag entnommen wurde.
+ * - false, wenn der Ring leer ist.
+ */
+bool spsc_ring_pop(struct spsc_ring* ring, void* entry)
+{
+    unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    unsigned int head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if(head == tail)
+    {
+        return false; // Ring ist leer
+    }
+
+    memcpy(entry, ring->entries + (size_t)(tail & ring->mask) * ring->entry_size, ring->entry_size);
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+
+    return true;
+}
+
+
+/**
+ * Funktion: spsc_ring_empty
+ * -------------------------
+ * Prüft (aus Sicht des lesenden Threads), ob der Ring leer ist.
+ *
+ * Parameter:
+ * - ring: Der Ring.
+ *
+ * Rückgabewert:
+ * - true, wenn kein Eintrag im Ring liegt.
+ */
+bool spsc_ring_empty(struct spsc_ring* ring)
+{
+    return atomic_load(&ring->head) == atomic_load_explicit(&ring->tail, memory_order_relaxed);
+}
+
+
+/**
+ * Funktion: wakeup_init
+ * ---------------------
+ * Legt einen Weckmechanismus an: unter Linux ein eventfd, sonst eine Pipe. Beide Seiten 
+ * sind nicht-blockierend.
+ *
+ * Parameter:
+ * - wakeup: Der anzulegende Weckmechanismus.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 wenn der Dateideskriptor nicht erstellt werden konnte.
+ */
+int wakeup_init(struct wakeup* wakeup)
+{
+    atomic_init(&wakeup->armed, false);
+
+#ifdef __linux__
+    wakeup->read_fd = eventfd(0, EFD_NONBLOCK);
+    wakeup->write_fd = wakeup->read_fd;
+    if(wakeup->read_fd < 0)
+#else
+    int fds[2];
+    wakeup->read_fd = -1;
+    wakeup->write_fd = -1;
+    if(pipe(fds) == 0)
+    {
+        wakeup->read_fd = fds[0];
+        wakeup->write_fd = fds[1];
+        fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL, 0) | O_NONBLOCK);
+        fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL, 0) | O_NONBLOCK);
+    }
+    if(wakeup->read_fd < 0)
+#endif
+    {
+        print_timestamp();
+        printf(RED "Weckmechanismus konnte nicht erstellt werden\n" RESET);
+        perror("\t\t");
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/**
+ * Funktion: wakeup_free
+ * ---------------------
+ * Schließt die Dateideskriptoren des Weckmechanismus.
+ *
+ * Parameter:
+ * - wakeup: Der Weckmechanismus.
+ */
+void wakeup_free(struct wakeup* wakeup)
+{
+    if(wakeup->write_fd >= 0 && wakeup->write_fd != wakeup->read_fd)
+    {
+        close(wakeup->write_fd);
+    }
+
+    if(wakeup->read_fd >= 0)
+    {
+        close(wakeup->read_fd);
+    }
+
+    wakeup->read_fd = -1;
+    wakeup->write_fd = -1;
+}
+
+
+/**
+ * Funktion: wakeup_arm
+ * --------------------
+ * Kündigt an, dass der aufrufende Thread gleich auf `read_fd` wartet. Danach muss er seine 
+ * Ringe noch einmal prüfen und darf nur warten, wenn sie weiterhin leer sind.
+ *
+ * Parameter:
+ * - wakeup: Der Weckmechanismus.
+ *
+ * Beschreibung:
+ * - Die Speicherbarriere verhindert, dass die erneute Prüfung vor das Setzen von `armed` 
+ *   gezogen wird. Gegenstück ist die Barriere in `wakeup_signal` nach dem Anhängen.
+ */
+void wakeup_arm(struct wakeup* wakeup)
+{
+    atomic_store(&wakeup->armed, true);
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+
+/**
+ * Funktion: wakeup_signal
+ * -----------------------
+ * Weckt den Thread, nachdem ein Eintrag in einen seiner Ringe gelegt wurde, aber nur, 
+ * wenn er warten will. Sonst kostet der Aufruf keinen Systemaufruf.
+ *
+ * Parameter:
+ * - wakeup: Der Weckmechanismus.
+ */
+void wakeup_signal(struct wakeup* wakeup)
+{
+    atomic_thread_fence(memory_order_seq_cst);
+    if(atomic_load_explicit(&wakeup->armed, memory_order_relaxed) && atomic_exchange(&wakeup->armed, false))
+    {
+        wakeup_notify(wakeup);
+    }
+}
+
+
+/**
+ * Funktion: wakeup_notify
+ * -----------------------
+ * Weckt den Thread ohne Rücksicht auf `armed`, z. B. zum Beenden.
+ *
+ * Parameter:
+ * - wakeup: Der Weckmechanismus.
+ */
+void wakeup_notify(struct wakeup* wakeup)
+{
+    uint64_t one = 1;
+    if(write(wakeup->write_fd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+    {
+        print_timestamp();
+        printf(RED "Thread konnte nicht geweckt werden\n" RESET);
+    }
+}
+
+
+/**
+ * Funktion: wakeup_drain
+ * ----------------------
+ * Setzt den Weckmechanismus nach dem Aufwachen zurück, damit `read_fd` nicht lesbar bleibt.
+ *
+ * Parameter:
+ * - wakeup: Der Weckmechanismus.
+ */
+void wakeup_drain(struct wakeup* wakeup)
+{
+    uint64_t buffer[8];
+    while(read(wakeup->read_fd, buffer, sizeof(buffer)) > 0);
+    atomic_store(&wakeup->armed, false);
+}
+
+
+/**
+ * Funktion: uring_init
+ * --------------------
+ * Legt einen io_uring an und blendet Übermittlungsring, Abschlussring und Aufträge ein. 
+ * Ohne io_uring im Kernel (ENOSYS) oder wenn es abgeschaltet ist (EPERM), schlägt die 
+ * Funktion fehl und der Aufrufer bleibt bei den bisherigen Systemaufrufen.
+ *
+ * Parameter:
+ * - ring: Der anzulegende Ring.
+ * - entries: Plätze im Übermittlungsring, der Abschlussring ist doppelt so groß.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 wenn der Ring nicht angelegt werden konnte, `errno` nennt den Grund.
+ */
+int uring_init(struct uring* ring, unsigned int entries)
+{
+    memset(ring, 0, sizeof(*ring));
+    ring->fd = -1;
+
+#ifdef __linux__
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    int fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if(fd < 0)
+    {
+        return -1;
+    }
+
+    ring->fd = fd;
+    ring->sq_entries = params.sq_entries;
+    ring->sq_map_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    ring->cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    // Seit Linux 5.4 liegen beide Ringe in einer Einblendung
+    bool single_map = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if(single_map && ring->cq_map_size > ring->sq_map_size)
+    {
+        ring->sq_map_size = ring->cq_map_size;
+    }
+
+    ring->sq_map = mmap(NULL, ring->sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if(ring->sq_map == MAP_FAILED)
+    {
+        ring->sq_map = NULL;
+        uring_free(ring);
+        return -1;
+    }
+
+    ring->cq_map = ring->sq_map;
+    if(!single_map)
+    {
+        ring->cq_map = mmap(NULL, ring->cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if(ring->cq_map == MAP_FAILED)
+        {
+            ring->cq_map = NULL;
+            uring_free(ring);
+            return -1;
+        }
+    }
+
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if(ring->sqes == MAP_FAILED)
+    {
+        ring->sqes = NULL;
+        uring_free(ring);
+        return -1;
+    }
+
+    char* sq = (char*)ring->sq_map;
+    ring->sq_head = (unsigned int*)(sq + params.sq_off.head);
+    ring->sq_tail_shared = (unsigned int*)(sq + params.sq_off.tail);
+    ring->sq_mask = (unsigned int*)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned int*)(sq + params.sq_off.array);
+    ring->sq_tail = *ring->sq_tail_shared;
+
+    char* cq = (char*)ring->cq_map;
+    ring->cq_head = (unsigned int*)(cq + params.cq_off.head);
+    ring->cq_tail = (unsigned int*)(cq + params.cq_off.tail);
+    ring->cq_mask = (unsigned int*)(cq + params.cq_off.ring_mask);
+    ring->cq_flags = params.cq_off.flags != 0 ? (unsigned int*)(cq + params.cq_off.flags) : NULL;
+    ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+
+    return 0;
+#else
+    (void)entries;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+
+/**
+ * Funktion: uring_free
+ * --------------------
+ * Gibt die Einblendungen frei und schließt den Ring. Laufende Aufträge bricht der Kernel 
+ * dabei ab, ihre Puffer müssen also nicht mehr gültig sein. Ein Aufruf ohne Ring ist unschädlich.
+ *
+ * Parameter:
+ * - ring: Der Ring.
+ */
+void uring_free(struct uring* ring)
+{
+#ifdef __linux__
+    if(ring->sqes != NULL)
+    {
+        munmap(ring->sqes, ring->sqes_size);
+    }
+
+    if(ring->cq_map != NULL && ring->cq_map != ring->sq_map)
+    {
+        munmap(ring->cq_map, ring->cq_map_size);
+    }
+
+    if(ring->sq_map != NULL)
+    {
+        munmap(ring->sq_map, ring->sq_map_size);
+    }
+#endif
+
+    if(ring->fd >= 0)
+    {
+        close(ring->fd);
+    }
+
+    memset(ring, 0, sizeof(*ring));
+    ring->fd = -1;
+}
+
+
+#ifdef __linux__
+/**
+ * Funktion: uring_get_sqe
+ * -----------------------
+ * Liefert den nächsten freien, genullten Auftrag im Übermittlungsring. Er wird mit dem 
+ * nächsten `uring_submit` an den Kernel übergeben.
+ *
+ * Parameter:
+ * - ring: Der Ring.
+ *
+ * Rückgabewert:
+ * - Der Auftrag.
+ * - NULL wenn der Übermittlungsring voll ist und auch nach dem Übergeben voll bleibt.
+ */
+struct io_uring_sqe* uring_get_sqe(struct uring* ring)
+{
+    unsigned int head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    if(ring->sq_tail - head >= ring->sq_entries)
+    {
+        uring_submit(ring, 0);
+        head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+        if(ring->sq_tail - head >= ring->sq_entries)
+        {
+            return NULL;
+        }
+    }
+
+    unsigned int index = ring->sq_tail & *ring->sq_mask;
+    struct io_uring_sqe* sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    ring->sq_array[index] = index;
+    ring->sq_tail += 1;
+    ring->pending += 1;
+    return sqe;
+}
+
+
+/**
+ * Funktion: uring_submit
+ * ----------------------
+ * Übergibt alle geschriebenen Aufträge mit einem Systemaufruf und wartet auf Wunsch auf 
+ * Abschlüsse.
+ *
+ * Parameter:
+ * - ring: Der Ring.
+ * - wait: Anzahl der Abschlüsse, auf die gewartet wird, 0 wartet nicht.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 bei einem Fehler von `io_uring_enter`.
+ *
+ * Beschreibung:
+ * - Ohne Aufträge und ohne `wait` wird kein Systemaufruf gemacht.
+ * - Eine Unterbrechung durch ein Signal (EINTR) gilt als Erfolg, der Aufrufer prüft den 
+ *   Abschlussring ohnehin erneut.
+ */
+int uring_submit(struct uring* ring, unsigned int wait)
+{
+    if(ring->pending == 0 && wait == 0)
+    {
+        return 0;
+    }
+
+    __atomic_store_n(ring->sq_tail_shared, ring->sq_tail, __ATOMIC_RELEASE);
+
+    unsigned int flags = wait > 0 ? IORING_ENTER_GETEVENTS : 0;
+    int result = (int)syscall(__NR_io_uring_enter, ring->fd, ring->pending, wait, flags, NULL, 0);
+    if(result < 0)
+    {
+        if(errno == EINTR)
+        {
+            return 0;
+        }
+
+        if(errno != EAGAIN && errno != EBUSY)
+        {
+            return -1;
+        }
+
+        result = 0; // Kernel nimmt gerade nichts an, beim nächsten Aufruf erneut übergeben
+    }
+
+    ring->pending -= (unsigned int)result < ring->pending ? (unsigned int)result : ring->pending;
+    return 0;
+}
+
+
+/**
+ * Funktion: uring_peek
+ * --------------------
+ * Liefert den ältesten noch nicht gelesenen Abschluss, ohne Systemaufruf.
+ *
+ * Parameter:
+ * - ring: Der Ring.
+ *
+ * Rückgabewert:
+ * - Der Abschluss, nach der Auswertung mit `uring_seen` freigeben.
+ * - NULL wenn keiner vorliegt.
+ */
+struct io_uring_cqe* uring_peek(struct uring* ring)
+{
+    unsigned int head = *ring->cq_head;
+    if(head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE))
+    {
+        return NULL;
+    }
+
+    return &ring->cqes[head & *ring->cq_mask];
+}
+
+
+/**
+ * Funktion: uring_seen
+ * --------------------
+ * Gibt den mit `uring_peek` gelesenen Abschluss an den Kernel zurück.
+ *
+ * Parameter:
+ * - ring: Der Ring.
+ */
+void uring_seen(struct uring* ring)
+{
+    __atomic_store_n(ring->cq_head, *ring->cq_head + 1, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * Funktion: uring_notify
+ * ----------------------
+ * Schaltet die Benachrichtigung über den registrierten eventfd ein oder aus, z. B. solange 
+ * ohnehin auf Abschlüsse gewartet wird. Ältere Kernel ohne diesen Schalter wecken immer.
+ *
+ * Parameter:
+ * - ring: Der Ring.
+ * - enabled: true weckt bei jedem Abschluss.
+ */
+void uring_notify(struct uring* ring, bool enabled)
+{
+    if(ring->cq_flags == NULL)
+    {
+        return;
+    }
+
+    unsigned int flags = *ring->cq_flags;
+    flags = enabled ? flags & ~IORING_CQ_EVENTFD_DISABLED : flags | IORING_CQ_EVENTFD_DISABLED;
+    __atomic_store_n(ring->cq_flags, flags, __ATOMIC_SEQ_CST);
+}
+
+
+/**
+ * Funktion: uring_register
+ * ------------------------
+ * Registriert Dateien, Puffer oder einen eventfd beim Ring (`io_uring_register`).
+ *
+ * Parameter:
+ * - ring: Der Ring.
+ * - opcode: IORING_REGISTER_* bzw. IORING_UNREGISTER_*.
+ * - arg: Feld der Dateideskriptoren bzw. iovecs, NULL beim Abmelden.
+ * - count: Anzahl der Einträge in `arg`.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 bei Fehlern, `errno` nennt den Grund.
+ */
+int uring_register(struct uring* ring, unsigned int opcode, const void* arg, unsigned int count)
+{
+    return syscall(__NR_io_uring_register, ring->fd, opcode, arg, count) < 0 ? -1 : 0;
+}
+#endif
@@ -3,18 +3,38 @@
 
 /* !!! HIER MUSS NICHTS MEHR GEÄNDERT WERDEN !!! */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // Für sendmmsg und recvmmsg
+#endif
 
 #include <stdio.h>  // Standard-Ein-/Ausgabefunktionen
 #include <stdlib.h> // Standardbibliothek für Speicherverwaltung und mehr
 #include <string.h> // Funktionen für die Zeichenkettenverarbeitung
 #include <unistd.h> // Zugriff auf POSIX-API-Funktionen
 #include <time.h>   // Funktionen zur Zeitmessung und -manipulation
+#include <sys/time.h> // Funktionen zur Zeitmessung mit Mikrosekunden
 #include <stdbool.h> // Definition von booleschen Datentypen
 #include <arpa/inet.h> // Funktionen zur Umwandlung von Internetadressen
 #include <sys/socket.h> // Definition von Socketfunktionen
 #include <netinet/in.h> // Definition von Internetadressen und Protokollen
 #include <net/if.h> // Definition von Netzwerkinterfaces
+#include <sys/ioctl.h> // Abfrage der MTU einer Schnittstelle
 #include <fcntl.h> // Funktionen zur Steuerung von Dateideskriptoren
+#include <errno.h> // Fehlercodes von Systemaufrufen
+#include <poll.h>  // Warten auf Dateideskriptoren ohne epoll
+#include <sys/mman.h> // Einblenden der Datei in den Speicher (--mmap)
+#include <sys/stat.h> // Größe der Datei abfragen
+#include <pthread.h>  // Threads für mehrere Sitzungen (--sessions)
+#include <sched.h>    // Binden der Threads an Kerne
+#include <stdatomic.h> // Lese- und Schreibindizes der Ringe zwischen Threads (--pipeline)
+
+#ifdef __linux__
+#include <sys/epoll.h>   // Ereignisbenachrichtigung für Dateideskriptoren
+#include <sys/timerfd.h> // Timer als Dateideskriptor
+#include <sys/eventfd.h> // Wecken eines wartenden Threads
+#include <sys/syscall.h> // Systemaufrufe von io_uring ohne liburing (--uring)
+#include <linux/io_uring.h> // Aufbau der mit dem Kernel geteilten Ringe
+#endif
 
 
 // Standard-Dateipfad für Daten
@@ -38,15 +58,129 @@
 // Standard-Leerlaufzeit in Sekunden
 #define DEFAULT_IDLE_TIME 2
 
-// Maximale Anzahl erlaubter Clients
+// Dauer der Registrierung in Zeitschlitzen, die Anzahl der Clients ist nicht begrenzt
 #define MAX_ALLOWED_CLIENTS 3
 
 // Standard-Fenstergröße für die Datenübertragung
 #define DEFAULT_WINDOW_SIZE 1
 
+// Maximale Fenstergröße in Paketen
+#define MAX_WINDOW_SIZE 65536
+
 // Maximale Datengröße pro Paket
 #define DEFAULT_DATA_BUFFER_SIZE 256
 
+// Größe des Empfangspuffers im Socket in Bytes, muss einen ganzen Burst aufnehmen können
+#define DEFAULT_RECEIVE_BUFFER_SIZE (1024 * 1024)
+
+// Standard-Anzahl an Datagrammen pro Systemaufruf beim Senden und Empfangen
+#define DEFAULT_BATCH_SIZE 32
+
+// Maximale Anzahl an Datagrammen pro Systemaufruf
+#define MAX_BATCH_SIZE 256
+
+// Plätze im Übermittlungsring von io_uring, reicht für je einen Sende- und Empfangsauftrag pro Datagramm
+#define URING_ENTRIES (2 * MAX_BATCH_SIZE)
+
+// Kennung eines Abschlusses von io_uring in den oberen 32 Bit von `user_data`, unten steht der Platz
+#define URING_SEND 1ULL
+#define URING_RECEIVE 2ULL
+#define URING_CANCEL 3ULL
+
+// Standard-Senderate des Servers in kbit/s
+#define DEFAULT_RATE 1000
+
+// Maximale Senderate des Servers in kbit/s
+#define MAX_RATE 10000000
+
+// Anzahl der Pakete, die der Token-Bucket auf einmal freigeben darf
+#define DEFAULT_BURST_SIZE 4
+
+// MTU, wenn sie nicht von der Schnittstelle abgefragt werden kann
+#define DEFAULT_MTU 1500
+
+// Kleinste MTU, die IPv6 garantiert
+#define MIN_MTU 1280
+
+// Größte unterstützte MTU (Jumbo-Frames)
+#define MAX_MTU 9000
+
+// Größe von IPv6- und UDP-Kopf, die von der MTU abgezogen werden
+#define IPV6_UDP_HEADER_SIZE (40 + 8)
+
+// Grundwert der zufälligen Wartezeit vor einem NACK in Millisekunden (--suppress)
+#define DEFAULT_NACK_BACKOFF 20
+
+// Größte angebbare Anzahl an Empfängern für --suppress
+#define MAX_GROUP_SIZE 1000000
+
+// Zeit in Millisekunden, in der der Server NACKs sammelt, bevor er die Wiederholungen sendet
+#define DEFAULT_REPAIR_HOLDOFF 10
+
+// Startwert des RTO in Millisekunden, bis die erste RTT gemessen wurde. Der NACK-Timer des 
+// Clients (zwei RTO) entspricht damit ohne Messung dem bisherigen festen Timer.
+#define DEFAULT_RTO (MAX_ALLOWED_CLIENTS * DEFAULT_SLOT_TIME / 2)
+
+// Kleinstes und größtes RTO in Millisekunden
+#define MIN_RTO 5
+#define MAX_RTO 60000
+
+// Höchstens so viele lückenlos empfangene Pakete bestätigt ein Client mit einem ACK, spätestens nach einem RTO
+#define DEFAULT_ACK_INTERVAL 16
+
+// Anzahl der Verlustintervalle, aus denen der Client die Verlustereignisrate mittelt (RFC 5348)
+#define LOSS_HISTORY_SIZE 8
+
+// Abstand in Millisekunden, in dem ein Client mit Verlusten dem Server seine Verlustrate meldet
+#define DEFAULT_REPORT_INTERVAL 100
+
+// Abstand in Millisekunden, in dem ein Client eine laufende Übertragung um Beitritt bittet
+#define DEFAULT_JOIN_INTERVAL 250
+
+// Anteil von --rate, den das Aufholen später beigetretener Clients höchstens nutzt (1/n)
+#define DEFAULT_CATCHUP_SHARE 4
+
+// Nach so vielen Millisekunden ohne Meldung wird das Aufholen eines Clients abgebrochen
+#define DEFAULT_CATCHUP_TIMEOUT 5000
+
+// Nach so vielen Millisekunden (mindestens vier RTO) ohne Antwort trotz unbestätigter Pakete 
+// wird ein Mitglied entfernt, damit es die Freigabe des Fensters nicht mehr aufhält
+#define DEFAULT_MEMBER_TIMEOUT 5000
+
+// Höchstzahl an Optionen je Zeile der Sitzungsdatei (--sessions)
+#define MAX_SESSION_ARGS 64
+
+// Größte Länge einer Zeile der Sitzungsdatei
+#define MAX_SESSION_LINE 1024
+
+// Anzahl der Pakete, die das Lesen der Datei dem Senden vorauseilt (--pipeline)
+#define PIPELINE_PREFETCH 256
+
+// Plätze im Ring der empfangenen Antworten vom Empfangs- zum Sende-Thread (--pipeline)
+#define PIPELINE_ANSWERS 4096
+
+// Höchstzahl an Paketen in der Schreibwarteschlange des Clients (--writequeue)
+#define MAX_WRITE_QUEUE 65536
+
+// Höchstzahl an Streifen einer Datei (--stripes), jeder belegt eine Gruppe und zwei Ports
+#define MAX_STRIPES 64
+
+// Abstand in Millisekunden, in dem ein Client den Empfangsstand als Prüfpunkt sichert (--checkpoint)
+#define DEFAULT_CHECKPOINT_INTERVAL 1000
+
+// Der Prüfpunkt liegt neben der Zieldatei unter deren Pfad mit dieser Endung
+#define CHECKPOINT_SUFFIX ".ckpt"
+
+// Kennung am Anfang eines Prüfpunkts, gefolgt von Prüfsumme, Dateigröße, Segmentgröße und Bitmap
+#define CHECKPOINT_MAGIC "RNKSCKP1"
+#define CHECKPOINT_HEADER_SIZE 28
+
+// Auflösung der Verlustrate auf der Leitung (Verluste pro LOSS_RATE_SCALE Pakete)
+#define LOSS_RATE_SCALE 1000000000.0
+
+// Größte Anzahl an Quellpaketen je FEC-Block (--fec), ein Bit je Paket in `fec.received`
+#define MAX_FEC_SOURCE 64
+
 // ANSI-Farbcodes für die Konsolenausgabe
 #define RED "\033[31m"   // Rot für Fehler oder Warnungen
 #define GREEN "\033[32m" // Grün für erfolgreiche Operationen
@@ -87,18 +221,137 @@ struct properties
     int debug_code;          // Debug-Code zur Fehleranalyse
 
     int windows_size;        // Fenstergröße für die Datenübertragung
+    int rate;                // Senderate des Servers in kbit/s, mit --congestion die Obergrenze
+    bool congestion;         // Senderate nach den Verlustraten der Empfänger anpassen (nur Server)
+    int catchup_rate;        // Senderate für das Aufholen später Beitritte in kbit/s, 0 = --rate / DEFAULT_CATCHUP_SHARE (nur Server)
+    char rate_log_path[512]; // CSV-Datei für Senderate und Verlustrate, leer ohne (nur Server)
+    FILE* rate_log;          // Geöffnete CSV-Datei, NULL ohne
+    int batch_size;          // Anzahl an Datagrammen pro Systemaufruf
+    bool uring;              // Socket und Datei über io_uring statt sendmmsg/recvmmsg und stdio
+    bool binary;             // Datei wird in Segmenten fester Größe statt zeilenweise übertragen
+    int mtu;                 // MTU des Pfads, 0 bedeutet von der Schnittstelle abfragen
+    int segment_size;        // Nutzdaten pro Segment im Binärmodus
     struct sockaddr_in6 my_addr; // Eigene IPv6-Adresse
     int port_server;         // Portnummer Server
     int port_client;         // Protnummer Client
     struct ipv6_mreq mreq;   // Multicast-Einstellungen
     char multi_address[INET6_ADDRSTRLEN]; // Multicast-Adresse
+    struct sockaddr_in6 multi_addr;       // Multicast-Zieladresse, einmalig in start_socket umgewandelt
     char network_interface[IFNAMSIZ];     // Netzwerkschnittstelle
 
     char file_path[512];     // Pfad zur Datei
     FILE* file;              // Dateizeiger
+    bool use_mmap;           // Datei wird eingeblendet statt mit stdio gelesen (nur Server)
+    char* map;               // Eingeblendete Datei, NULL ohne --mmap oder bei leerer Datei
+    size_t map_size;         // Größe der eingeblendeten Datei in Bytes
+    size_t map_pos;          // Leseposition in der eingeblendeten Datei
+    long long file_size;     // Größe der Datei in Bytes, -1 wenn unbekannt
+    unsigned long long file_hash; // Prüfsumme der Datei im Binärmodus, 0 wenn unbekannt (nur Server)
+    bool resume;             // Zieldatei existiert mit Prüfpunkt und wird fortgesetzt (nur Client)
+    int checkpoint_interval; // Abstand der Prüfpunkte in ms, 0 = keine (nur Client)
+    int write_queue;         // Höchstzahl wartender Pakete des Schreib-Threads, 0 = ohne Thread (nur Client)
+    int stripes;             // Anzahl der Streifen der Datei (--stripes), 1 ohne Streifen
+    int stripe;              // Index des Streifens dieser Übertragung, 0 bis stripes - 1
+    struct writer* writer;   // Schreib-Thread, NULL ohne --writequeue (nur Client)
+    char sessions_path[512]; // Datei mit einer Zeile Optionen je Sitzung, leer für eine Sitzung (nur Server)
+    int threads;             // Anzahl der Threads für --sessions bzw. --stripes, 0 = Standard (nur Server)
+    bool pipeline;           // Lesen, Senden und Empfangen in eigenen Threads (nur Server)
+
+    int group_size;          // Erwartete Anzahl an Empfängern für die NACK-Unterdrückung, 0 = aus
+    int fec_source;          // Quellpakete je FEC-Block, 0 ohne FEC
+    int fec_parity;          // Paritätspakete je FEC-Block
+    long long nack_due;      // Zeitpunkt in µs, zu dem geplante NACKs gesendet werden, 0 ohne (nur Client)
+
+    int rto;                 // RTO in ms, Server: größtes RTO der Mitglieder plus Sendeabstand, Client: vom Server gemeldet
+    unsigned int echo;       // Zeitstempel des letzten Pakets vom Server, 0 ohne (nur Client)
+    long long echo_received; // Empfangszeitpunkt dieses Pakets in µs (nur Client)
+    double loss_rate;        // Eigene Verlustereignisrate, wird in jeder Antwort gemeldet (nur Client)
+
+    struct transport* transport; // Sende- und Empfangspuffer für gebündelte Systemaufrufe
 };
 
 
+/*
+ * Paketformat auf der Leitung
+ * ----------------------------
+ * Alle Felder sind lückenlos gepackt und in Netzwerk-Byte-Reihenfolge (Big Endian).
+ *
+ * Gemeinsamer Kopf (WIRE_HEADER_SIZE Bytes):
+ *   0  u8   Version (WIRE_VERSION)
+ *   1  u8   Art (WIRE_KIND_REQUEST oder WIRE_KIND_ANSWER)
+ *   2  u8   Typ (REQ_* bzw. ANS_*)
+ *   3  u8   Reserviert, 0
+ *   4  u32  Sender-ID
+ *   8  u32  Empfänger-ID (-1 für alle)
+ *  12  u32  Paket-ID
+ *
+ * Zusätzlich bei Anfragen (WIRE_REQUEST_HEADER_SIZE Bytes inklusive Kopf):
+ *  16  u32  Paketlänge (`packageLen`)
+ *  20  u16  Länge der Nutzdaten
+ *  22  u64  Byte-Position der Nutzdaten in der Datei (`offset`)
+ *  30  u32  Sendezeitpunkt des Servers in µs (`timestamp`, niederwertige 32 Bit)
+ *  34  u32  RTO des Servers in ms (`rto`)
+ *  38  ...  Nutzdaten
+ *
+ * Zusätzlich bei Antworten (WIRE_ANSWER_HEADER_SIZE Bytes inklusive Kopf):
+ *  16  u32  Echo des letzten Zeitstempels vom Server (`echo`, 0 wenn noch keiner empfangen)
+ *  20  u32  Zeit in µs zwischen dessen Empfang und dem Senden der Antwort (`echoDelay`)
+ *  24  u32  Verlustereignisrate des Clients in Verlusten pro LOSS_RATE_SCALE Paketen
+ * Der Server misst daraus je Mitglied die RTT, ohne dass die Uhren synchron sein müssen, 
+ * und bestimmt mit der Verlustrate die Senderate (--congestion).
+ *
+ * Ein HELLO trägt als Nutzdaten die Dateigröße als u64 (-1 wenn unbekannt), damit der Client 
+ * die Zieldatei vorab anlegen und Segmente direkt an ihre Position schreiben kann, gefolgt 
+ * von der erwarteten Gruppengröße als u32 (0 = NACKs ohne Unterdrückung, siehe --suppress) 
+ * und den Quell- und Paritätspaketen je FEC-Block als u16 und u16 (0 = ohne FEC, siehe --fec) 
+ * sowie der Prüfsumme der Datei als u64 (0 = unbekannt). Mit Prüfsumme und Segmentgröße erkennt 
+ * ein neu gestarteter Client, ob sein Prüfpunkt zu dieser Übertragung gehört. Zuletzt folgen 
+ * der Index des Streifens und die Anzahl der Streifen als u16 und u16 (0 und 1 ohne --stripes).
+ *
+ * Streifen (nur Binärmodus, --stripes n): Die Datei wird auf n Übertragungen verteilt. Streifen 
+ * k sendet die Segmente k, k + n, k + 2n, ... über die Multicast-Gruppe und die Ports der 
+ * Kommandozeile plus k. Seine Paket-IDs zählen je Streifen ab 1, Paket p liegt an der 
+ * Byte-Position ((p - 1) * n + k) * Segmentgröße.
+ *
+ * Später Beitritt (nur Binärmodus): Ein Client, der Segmente einer laufenden Übertragung 
+ * empfängt, sendet ein HELLO mit Paket-ID 0. Der Server antwortet per Unicast mit einem HELLO, 
+ * dessen Paket-ID der Beitrittspunkt ist (sonst 0). Bestätigt der Client ihn mit einem HELLO 
+ * mit derselben Paket-ID, wird er Mitglied und erhält alle Segmente davor per Unicast. Mit 
+ * CATCHUP meldet er dabei regelmäßig das erste noch fehlende Segment und, wie ein NACK, die 
+ * Bitmap der weiteren fehlenden Segmente.
+ *
+ * Ein Paritätspaket (REQ_PARITY) trägt als Paket-ID das erste Quellpaket seines Streifens, 
+ * als `packageLen` die Länge seiner Nutzdaten (das längste Quellpaket des Streifens) und als 
+ * `offset` das XOR der Längen aller Quellpakete des Streifens. Die Nutzdaten sind das XOR 
+ * der mit Nullen aufgefüllten Nutzdaten der Quellpakete.
+ *
+ * Ein NACK oder CATCHUP kann zusätzlich die Bitmap aller weiteren fehlenden Pakete tragen:
+ *  28  u16  Länge der Bitmap in Bytes (höchstens NACK_BITMAP_SIZE)
+ *  30  ...  Bitmap, Bit i (niederwertigstes Bit zuerst) steht für Paket-ID + 1 + i
+ * Ohne Bitmap besteht ein NACK nur aus dem Kopf einer Antwort und fordert ein Paket an.
+ *
+ * Ein ACK und ein CLOSE bestätigen mit ihrer Paket-ID kumulativ, dass der Client alle Pakete 
+ * davor geschrieben (oder ausgelassen) hat. Der Server gibt sie sofort frei, sobald alle 
+ * Mitglieder sie bestätigt haben, statt auf den Ablauf ihrer Timer zu warten.
+ *
+ * Die Version wird nur erhöht, wenn sich die Bedeutung oder Lage vorhandener Felder ändert.
+ * Pakete mit einer anderen Version werden beim Empfang verworfen.
+ */
+#define WIRE_VERSION 4
+#define WIRE_KIND_REQUEST 'R'
+#define WIRE_KIND_ANSWER  'A'
+#define WIRE_HEADER_SIZE 16
+#define WIRE_REQUEST_HEADER_SIZE (WIRE_HEADER_SIZE + 22)
+#define WIRE_ANSWER_HEADER_SIZE (WIRE_HEADER_SIZE + 12)
+#define WIRE_NACK_HEADER_SIZE (WIRE_ANSWER_HEADER_SIZE + 2)
+
+// Maximale Länge der Verlust-Bitmap eines NACKs in Bytes
+#define NACK_BITMAP_SIZE 128
+
+// Maximale Nutzdaten pro Paket bei der größten MTU
+#define MAX_PAYLOAD_SIZE (MAX_MTU - IPV6_UDP_HEADER_SIZE - WIRE_REQUEST_HEADER_SIZE)
+
+
 /**
  * Struktur: request
  * ------------------
@@ -112,9 +365,21 @@ struct request
     #define REQ_HELLO 'H'  // Begrüßungsnachricht
     #define REQ_DATA  'D'  // Datenanforderung
     #define REQ_CLOSE 'C'  // Schließanforderung
+    #define REQ_SEGMENT 'S' // Binäres Segment der Datei
+    #define REQ_PARITY 'P' // XOR-Parität eines Streifens (--fec)
     long packageLen;       // Länge des Pakets
     int packageId;         // Paket-ID
-    char data[DEFAULT_DATA_BUFFER_SIZE];  // Nutzdaten
+    long long offset;      // Byte-Position der Nutzdaten in der Datei, bei HELLO die Segmentgröße (0 = Textmodus)
+    long long fileSize;    // Größe der Datei in Bytes, nur bei HELLO, -1 wenn unbekannt
+    unsigned long long fileHash; // Prüfsumme der Datei, nur bei HELLO, 0 wenn unbekannt
+    int groupSize;         // Erwartete Anzahl an Empfängern, nur bei HELLO, 0 ohne NACK-Unterdrückung
+    int fecSource;         // Quellpakete je FEC-Block, nur bei HELLO, 0 ohne FEC
+    int fecParity;         // Paritätspakete je FEC-Block, nur bei HELLO
+    int stripe;            // Index des Streifens, nur bei HELLO, 0 ohne --stripes
+    int stripes;           // Anzahl der Streifen, nur bei HELLO, 1 ohne --stripes
+    unsigned int timestamp; // Sendezeitpunkt in µs, wird beim Senden gesetzt
+    int rto;               // RTO des Servers in ms, wird beim Senden gesetzt
+    char data[MAX_PAYLOAD_SIZE + 1];  // Nutzdaten, +1 für die Nullterminierung von Text
 };
 
 
@@ -131,7 +396,15 @@ struct answer
     #define ANS_HELLO 'H'  // Begrüßungsantwort
     #define ANS_NACK  'N'  // Negative Bestätigung
     #define ANS_CLOSE 'C'  // Schließantwort
-    int packageId;         // Paket-ID
+    #define ANS_REPORT 'R' // Regelmäßige Meldung der Verlustrate (--congestion)
+    #define ANS_ACK   'A'  // Kumulative Bestätigung aller Pakete vor `packageId`
+    #define ANS_CATCHUP 'U' // Fortschritt beim Aufholen nach spätem Beitritt, Bitmap wie NACK
+    int packageId;         // Paket-ID, bei NACK das erste fehlende Paket
+    int lossLen;           // Genutzte Bytes der Verlust-Bitmap, 0 ohne Bitmap
+    unsigned char lossMap[NACK_BITMAP_SIZE]; // Weitere fehlende Pakete ab `packageId` + 1
+    unsigned int echo;     // Echo des letzten Zeitstempels vom Server, wird beim Senden gesetzt
+    unsigned int echoDelay; // Verweildauer dieses Zeitstempels beim Client in µs
+    double lossRate;       // Verlustereignisrate des Clients, wird beim Senden gesetzt
 };
 
 
@@ -145,19 +418,317 @@ struct communication
     struct request req;    // Anfrage
     struct answer ans;     // Antwort
     struct sockaddr_in6 partner; // Partneradresse
+    int packet;            // Puffer der Nutzdaten im Paketpool, PACKET_NONE wenn sie nicht im Pool liegen
+    char* payload;         // Nutzdaten außerhalb von `req.data` (Pool oder eingeblendete Datei), NULL ohne
+    char kind;             // Art des zuletzt empfangenen Pakets (WIRE_KIND_*), Clients hören auch NACKs anderer Clients
+    int member;            // Index des Absenders in der Mitgliederliste (Server), -1 wenn nicht geprüft
 };
 
 
+// Maximale Größe eines Datagramms
+#define MAX_DATAGRAM_SIZE (WIRE_REQUEST_HEADER_SIZE + MAX_PAYLOAD_SIZE)
+
+
 /**
- * Struktur: linked_list_timer
- * ----------------------------
- * Definiert einen Eintrag in einer verketteten Liste, die Timer für Pakete speichert.
+ * Struktur: wire_header
+ * ----------------------
+ * Dekodierter gemeinsamer Kopf eines empfangenen Pakets.
+ */
+struct wire_header
+{
+    unsigned char version; // Version des Paketformats
+    unsigned char kind;    // Anfrage oder Antwort
+    char type;             // Typ der Anfrage bzw. Antwort
+    int senderId;          // ID des Senders
+    int reciverId;         // ID des Empfängers
+    int packageId;         // Paket-ID
+};
+
+
+#ifndef __linux__
+// Ohne sendmmsg/recvmmsg wird nur der Nachrichtenkopf benötigt
+struct mmsghdr
+{
+    struct msghdr msg_hdr;  // Nachrichtenkopf
+    unsigned int msg_len;   // Anzahl übertragener Bytes
+};
+#endif
+
+
+// Handle für "kein Puffer aus dem Paketpool"
+#define PACKET_NONE -1
+
+
+/**
+ * Struktur: packet_pool
+ * ----------------------
+ * Feste Anzahl gleich großer Paketpuffer mit Referenzzählern. Puffer werden über ihren 
+ * Index (Handle) weitergegeben statt kopiert. Jeder Puffer hat das Layout eines Datagramms: 
+ * WIRE_REQUEST_HEADER_SIZE Bytes Kopf, danach die Nutzdaten.
+ */
+struct packet_pool
+{
+    int count;                  // Anzahl der Puffer
+    int buffer_size;            // Bytes pro Puffer
+    int free_head;              // Erster freier Puffer, PACKET_NONE wenn alle belegt sind
+    int* refcount;              // Referenzen je Puffer, 0 wenn frei
+    int* next_free;             // Verkettung der freien Puffer
+    unsigned char* memory;      // Alle Puffer hintereinander
+};
+
+
+/**
+ * Struktur: uring
+ * ----------------
+ * Ein io_uring ohne liburing: Übermittlungs- und Abschlussring werden mit dem Kernel geteilt. 
+ * Aufträge werden in den Übermittlungsring geschrieben und mit einem `io_uring_enter` 
+ * gesammelt übergeben, Abschlüsse werden ohne Systemaufruf aus dem Abschlussring gelesen.
+ */
+struct uring
+{
+    int fd;                             // Deskriptor des Rings, -1 ohne
+    unsigned int sq_entries;            // Plätze im Übermittlungsring
+    unsigned int sq_tail;               // Eigenes Ende des Übermittlungsrings, noch nicht veröffentlicht
+    unsigned int pending;               // Geschriebene, noch nicht übergebene Aufträge
+    unsigned int* sq_head;              // Vom Kernel gelesene Aufträge
+    unsigned int* sq_tail_shared;       // Für den Kernel sichtbares Ende des Übermittlungsrings
+    unsigned int* sq_mask;
+    unsigned int* sq_array;             // Indizes der Aufträge in `sqes`
+    struct io_uring_sqe* sqes;          // Aufträge
+    unsigned int* cq_head;              // Gelesene Abschlüsse
+    unsigned int* cq_tail;              // Vom Kernel geschriebene Abschlüsse
+    unsigned int* cq_mask;
+    unsigned int* cq_flags;             // Schaltet die Benachrichtigung über den eventfd ab
+    struct io_uring_cqe* cqes;          // Abschlüsse
+    void* sq_map;                       // Eingeblendeter Übermittlungsring
+    size_t sq_map_size;
+    void* cq_map;                       // Eingeblendeter Abschlussring
+    size_t cq_map_size;
+    size_t sqes_size;                   // Größe des eingeblendeten Felds `sqes`
+};
+
+
+/**
+ * Struktur: transport
+ * --------------------
+ * Vorab angelegte Puffer für das gebündelte Senden (`sendmmsg`) und Empfangen (`recvmmsg`)
+ * von Datagrammen sowie Zähler für die Anzahl der Systemaufrufe.
+ * Mit einem angebundenen Paketpool (`transport_attach_pool`) werden Nutzdaten beim Senden 
+ * direkt aus dem Pool übertragen (Kopf und Nutzdaten als zwei iovecs) und der Client 
+ * empfängt direkt in Puffer des Pools.
+ * Mit --uring gehen die Datagramme über einen io_uring: Für jeden Empfangsplatz liegt ein 
+ * Empfangsauftrag beim Kernel, fertige Plätze stehen in `rx_order` und `event_fd` wird bei 
+ * jedem Abschluss lesbar.
+ */
+struct transport
+{
+    int batch_size;                                     // Datagramme pro Systemaufruf
+    struct uring ring;                                  // io_uring, `ring.fd` -1 ohne --uring
+    int event_fd;                                       // Wird bei Abschlüssen des Rings lesbar, -1 ohne
+    bool rx_failed;                                     // Ein Empfangsauftrag ist mit einem Fehler beendet
+
+    // Ausgehende Datagramme, die beim nächsten `flush_cast` gesendet werden
+    int tx_count;                                       // Anzahl wartender Datagramme
+    struct mmsghdr tx_msgs[MAX_BATCH_SIZE];             // Nachrichtenköpfe für sendmmsg
+    struct iovec tx_iov[MAX_BATCH_SIZE][2];             // Kopf bzw. ganzes Datagramm, Nutzdaten aus dem Pool
+    struct sockaddr_in6 tx_addr[MAX_BATCH_SIZE];        // Zieladressen
+    int tx_packet[MAX_BATCH_SIZE];                      // Referenzierter Poolpuffer, PACKET_NONE ohne
+    unsigned char tx_buffer[MAX_BATCH_SIZE][MAX_DATAGRAM_SIZE]; // Kodierte Datagramme
+
+    // Empfangene Datagramme, die von `receive_cast` nacheinander abgeholt werden
+    int rx_count;                                       // Anzahl empfangener Datagramme
+    int rx_next;                                        // Nächstes abzuholendes Datagramm
+    struct mmsghdr rx_msgs[MAX_BATCH_SIZE];             // Nachrichtenköpfe für recvmmsg
+    struct iovec rx_iov[MAX_BATCH_SIZE];                // Verweise auf die Puffer
+    struct sockaddr_in6 rx_addr[MAX_BATCH_SIZE];        // Absenderadressen
+    int rx_packet[MAX_BATCH_SIZE];                      // Poolpuffer des Datagramms, PACKET_NONE ohne
+    int rx_order[MAX_BATCH_SIZE];                       // Plätze in Empfangsreihenfolge (--uring)
+    bool rx_armed[MAX_BATCH_SIZE];                      // Empfangsauftrag des Platzes liegt beim Kernel
+    unsigned char rx_buffer[MAX_BATCH_SIZE][MAX_DATAGRAM_SIZE]; // Kodierte Datagramme
+
+    struct packet_pool* pool;                           // Angebundener Paketpool, NULL ohne
+
+    // Statistik
+    long long send_calls;                               // Systemaufrufe zum Senden
+    long long send_packets;                             // Gesendete Datagramme
+    long long receive_calls;                            // Systemaufrufe zum Empfangen
+    long long receive_packets;                          // Empfangene Datagramme
+};
+
+
+// Auflösung des Timer-Rads in Millisekunden
+#define TIMER_WHEEL_TICK_MS 1
+
+// Aufbau des Timer-Rads: Ebene 0 mit 256 Fächern, darüber drei Ebenen mit je 64 Fächern
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_WHEEL_LEVEL0_BITS 8
+#define TIMER_WHEEL_LEVEL_BITS 6
+#define TIMER_WHEEL_LEVEL0_SLOTS (1 << TIMER_WHEEL_LEVEL0_BITS)
+#define TIMER_WHEEL_LEVEL_SLOTS (1 << TIMER_WHEEL_LEVEL_BITS)
+
+// Liste der abgelaufenen Timer hinter den Fächern aller Ebenen
+#define TIMER_WHEEL_EXPIRED (TIMER_WHEEL_LEVEL0_SLOTS + (TIMER_WHEEL_LEVELS - 1) * TIMER_WHEEL_LEVEL_SLOTS)
+#define TIMER_WHEEL_BUCKETS (TIMER_WHEEL_EXPIRED + 1)
+
+
+/**
+ * Struktur: timer_node
+ * ---------------------
+ * Ein Timer im Timer-Rad. Die Knoten liegen in einem vorab reservierten Feld und sind 
+ * über Indizes statt Zeiger verkettet.
+ */
+struct timer_node
+{
+    int package_id;     // Paket-ID
+    long long expires;  // Ablaufzeitpunkt in Ticks des Rads
+    int next;           // Index des nächsten Knotens im Fach, -1 am Ende
+    int prev;           // Index des vorherigen Knotens im Fach, -1 am Anfang
+    int bucket;         // Fach des Knotens, -1 wenn der Timer nicht läuft
+};
+
+
+/**
+ * Struktur: timer_wheel
+ * ----------------------
+ * Hierarchisches Timer-Rad mit Einfügen, Löschen und Ablaufen in O(1). Die Zeit wird 
+ * an der monotonen Uhr gemessen, nicht an Schleifendurchläufen.
+ */
+struct timer_wheel
+{
+    long long current;                  // Nächster zu bearbeitender Tick
+    int capacity;                       // Anzahl der Knoten (Zweierpotenz)
+    int mask;                           // capacity - 1
+    int count;                          // Anzahl laufender und abgelaufener Timer
+    struct timer_node* nodes;           // Knoten, Index ist packageId & mask
+    int heads[TIMER_WHEEL_BUCKETS];     // Erster Knoten jedes Fachs, -1 wenn leer
+};
+
+
+/**
+ * Struktur: window_slot
+ * ----------------------
+ * Kopfdaten eines Pakets in einem Platz des Fensters. Die Nutzdaten liegen getrennt 
+ * in einem Puffer des Paketpools des Fensters.
+ */
+struct window_slot
+{
+    int senderId;          // ID des Senders
+    int reciverId;         // ID des Empfängers
+    char type;             // Typ der Anfrage
+    long packageLen;       // Länge des Pakets
+    int packageId;         // Paket-ID
+    long long offset;      // Byte-Position der Nutzdaten in der Datei
+    int packet;            // Puffer mit den Nutzdaten im Paketpool des Fensters, PACKET_NONE ohne
+    char* data;            // Nutzdaten außerhalb des Pools (eingeblendete Datei), NULL ohne
+    long long repaired;    // Zeitpunkt der letzten Wiederholung in µs, 0 ohne (Server)
+    int repair_count;      // Anzahl der NACKs seit der letzten Wiederholung (Server)
+    int repair_member;     // Index des ersten anfordernden Mitglieds in der Mitgliederliste (Server)
+};
+
+
+/**
+ * Struktur: window
+ * -----------------
+ * Sende- bzw. Empfangsfenster als Ringpuffer. Die Paket-ID bestimmt über `packageId & mask` 
+ * direkt den Platz, beim Weiterschieben von `base` wird nichts kopiert.
+ * Zustandsbits, Kopfdaten und Nutzdaten liegen in getrennten Feldern, damit die häufig 
+ * gelesenen Zustandsbits dicht beieinander liegen. Die Nutzdaten liegen in Puffern des 
+ * Paketpools, die ohne Kopie an den Transport weitergereicht werden.
+ */
+struct window
+{
+    int capacity;                   // Anzahl der Plätze, Zweierpotenz >= Fenstergröße
+    int mask;                       // capacity - 1
+    int payload_size;               // Bytes Nutzdaten pro Platz
+    unsigned char* flags;           // Zustandsbits je Platz
+    #define WINDOW_USED     0x01    // Platz enthält ein Paket
+    #define WINDOW_TIMEOUT  0x02    // Timer des Pakets ist abgelaufen bzw. NACK gesendet
+    #define WINDOW_RECEIVED 0x04    // Paket wurde empfangen
+    #define WINDOW_PENDING  0x08    // NACK ist geplant, aber noch nicht gesendet (--suppress)
+    struct window_slot* slots;      // Kopfdaten je Platz
+    struct packet_pool pool;        // Puffer für die Nutzdaten
+};
+
+
+/**
+ * Struktur: event_loop
+ * ---------------------
+ * Wartet gleichzeitig auf den Socket und auf einen periodischen Takt einer monotonen Uhr.
+ * Unter Linux werden epoll und timerfd verwendet, sonst poll und die monotone Uhr.
+ */
+struct event_loop
+{
+    struct properties* props;       // Eigenschaften mit Socket und Sende-/Empfangspuffern
+    int sockfd;                     // Überwachter Socket bzw. Weckmechanismus (`event_loop_watch`)
+    int tick_ms;                    // Länge eines Ticks in Millisekunden
+    int epoll_fd;                   // epoll-Instanz (nur Linux)
+    int timer_fd;                   // timerfd für den Takt (nur Linux)
+    long long next_tick;            // Zeitpunkt des nächsten Ticks in Mikrosekunden (ohne timerfd)
+};
+
+
+/**
+ * Struktur: pacer
+ * ----------------
+ * Token-Bucket, der die Senderate des Servers begrenzt. Die Tokens entsprechen Bytes.
+ */
+struct pacer
+{
+    double rate;                    // Auffüllrate in Bytes pro Sekunde
+    double burst;                   // Maximale Anzahl an Tokens im Bucket
+    double tokens;                  // Aktuell verfügbare Tokens
+    long long last_refill;          // Zeitpunkt der letzten Auffüllung in Mikrosekunden
+};
+
+
+/**
+ * Struktur: rtt_estimator
+ * ------------------------
+ * Geglättete RTT und ihre mittlere Abweichung nach Jacobson/Karels (RFC 6298), alle Werte in µs.
+ */
+struct rtt_estimator
+{
+    long long srtt;             // Geglättete RTT, 0 ohne Messung
+    long long rttvar;           // Mittlere Abweichung der RTT
+    long long rto;              // srtt + 4 * rttvar, begrenzt auf MIN_RTO bis MAX_RTO
+};
+
+
+/**
+ * Struktur: loss_history
+ * -----------------------
+ * Verlustintervalle eines Clients nach TFRC (RFC 5348). Ein Verlustereignis umfasst alle 
+ * Verluste innerhalb einer RTT nach dem ersten, ein Intervall zählt die Pakete zwischen 
+ * den ersten Verlusten zweier Ereignisse.
+ */
+struct loss_history
+{
+    int intervals[LOSS_HISTORY_SIZE]; // Abgeschlossene Intervalle in Paketen, das neueste zuerst
+    int count;                  // Anzahl der abgeschlossenen Intervalle
+    int event_start;            // Paket-ID des ersten Verlusts des laufenden Ereignisses, 0 ohne
+    long long event_time;       // Zeitpunkt dieses Verlusts in µs
+    int highest;                // Höchste bisher empfangene Paket-ID
+};
+
+
+/**
+ * Struktur: congestion
+ * ---------------------
+ * Senderate des Servers nach TFMCC: Die Rate folgt dem langsamsten Empfänger (CLR), dessen 
+ * TCP-freundliche Rate aus Verlustrate und RTT berechnet wird.
  */
-struct linked_list_timer
+struct congestion
 {
-    struct linked_list_timer* next; // Zeiger auf den nächsten Timer
-    int packageId;                  // Paket-ID
-    int ticksToGo;                  // Verbleibende Zeit in Ticks
+    double rate;                // Aktuelle Senderate in Bytes pro Sekunde
+    double max_rate;            // Obergrenze aus --rate in Bytes pro Sekunde
+    int clr;                    // ID des begrenzenden Empfängers, -1 wenn keiner unter --rate liegt
+    int slowest;                // Index des langsamsten Empfängers mit Verlusten, -1 wenn keiner
+    double slowest_rate;        // Dessen TCP-freundliche Rate in Bytes pro Sekunde
+    double max_rtt;             // Größte RTT aller Mitglieder in Sekunden
+    long long scanned;          // Zeitpunkt des letzten Durchlaufs über alle Mitglieder in µs
+    long long updated;          // Zeitpunkt der letzten Anpassung in µs
+    long long started;          // Beginn der Übertragung in µs
+    long long logged;           // Zeitpunkt des letzten Eintrags im Rate-Log in µs
 };
 
 
@@ -170,33 +741,451 @@ struct member
 {
     int member_id;              // ID des Mitglieds
     struct sockaddr_in6 member; // Adresse des Mitglieds
+    struct rtt_estimator rtt;   // Geschätzte RTT zum Mitglied
+    double loss_rate;           // Zuletzt gemeldete Verlustereignisrate
+    int acked;                  // Alle Pakete vor dieser ID sind bestätigt (ACK bzw. CLOSE)
+    int join;                   // Erstes Paket, das das Mitglied per Multicast erhalten hat (1 ohne späten Beitritt)
+    long long heard;            // Letzte Antwort des Mitglieds in µs
 };
 
 
 /**
  * Struktur: memberlist
  * ---------------------
- * Speichert eine Liste der Mitglieder der Übertragung.
+ * Mitglieder der Übertragung. Die Mitglieder liegen lückenlos in `member`, eine Hashtabelle 
+ * mit offener Adressierung findet sie über ID und Adresse in O(1). Beide wachsen bei Bedarf 
+ * auf die doppelte Größe, es gibt keine feste Obergrenze für die Anzahl der Empfänger.
+ *
+ * Für die Freigabe des Fensters zählt ein Ring je Paket-ID oberhalb von `ack_base`, wie viele 
+ * Mitglieder genau bis zu dieser ID bestätigt haben. Ob alle Mitglieder `ack_base` bestätigt 
+ * haben, ist damit ohne Durchlauf über alle Mitglieder bekannt.
  */
 struct memberlist
 {
     int number_members;         // Anzahl der Mitglieder
-    struct member member[MAX_ALLOWED_CLIENTS]; // Array von Mitgliedern
+    int capacity;               // Plätze in `member`
+    struct member* member;      // Mitglieder, der Index bleibt bis zum Entfernen gleich
+    int* slots;                 // Hashtabelle: Index in `member`, MEMBER_SLOT_FREE wenn frei
+    int slot_mask;              // Anzahl der Plätze der Hashtabelle - 1 (Zweierpotenz)
+    int* ack_counts;            // Ring: Anzahl der Mitglieder je `acked` oberhalb von `ack_base`
+    int ack_mask;               // Anzahl der Plätze im Ring - 1 (Zweierpotenz)
+    int ack_base;               // Erste Paket-ID, die noch nicht aus dem Fenster entfernt wurde
+    int ack_ahead;              // Anzahl der Mitglieder, die `ack_base` bestätigt haben
+};
+
+// Freier Platz in der Hashtabelle der Mitglieder
+#define MEMBER_SLOT_FREE -1
+
+// Anfangsgröße der Mitgliederliste, wächst bei Bedarf
+#define DEFAULT_MEMBER_CAPACITY 16
+
+
+/**
+ * Struktur: segment_map
+ * ----------------------
+ * Bitmap der bereits geschriebenen Segmente einer Datei im Binärmodus. Ein Bit je Segment, 
+ * der Speicherbedarf hängt damit nur von der Dateigröße und nicht von der Fenstergröße ab.
+ * Der Client sichert sie regelmäßig als Prüfpunkt, damit ein Neustart nur fehlende Segmente braucht.
+ */
+struct segment_map
+{
+    long long file_size;        // Größe der Datei in Bytes
+    int segment_size;           // Nutzdaten pro Segment in Bytes
+    long long count;            // Anzahl der Segmente
+    long long done;             // Anzahl der bereits geschriebenen Segmente
+    unsigned char* bits;        // Ein Bit je Segment, gesetzt wenn geschrieben
+    unsigned char* pending;     // Ein Bit je Segment in der Schreibwarteschlange, NULL ohne --writequeue
+    unsigned long long file_hash; // Prüfsumme der Datei laut HELLO, kennzeichnet den Prüfpunkt
+    int stripe;                 // Index des Streifens, die Bitmap enthält nur dessen Segmente
+    int stripes;                // Anzahl der Streifen, 1 ohne --stripes
+};
+
+
+/**
+ * Struktur: repair_queue
+ * -----------------------
+ * Sammelt die Paket-IDs, für die während der Sammelzeit NACKs eingegangen sind. Jede ID 
+ * steht höchstens einmal in der Liste, die anfordernden Empfänger zählt der Fensterplatz.
+ */
+struct repair_queue
+{
+    int* ids;                   // Paket-IDs mit ausstehender Wiederholung
+    int count;                  // Anzahl der gesammelten IDs
+    int capacity;               // Platz für IDs, entspricht der Kapazität des Fensters
+    long long due;              // Zeitpunkt in µs, zu dem die Wiederholungen gesendet werden, 0 ohne
+};
+
+
+/**
+ * Struktur: catchup
+ * ------------------
+ * Aufholen eines spät beigetretenen Mitglieds. Der erste Durchlauf sendet alle Segmente vor 
+ * dem Beitrittspunkt, die der Client laut seinen Meldungen noch nicht hat, jeder weitere nur 
+ * die in der letzten CATCHUP-Meldung fehlenden.
+ */
+struct catchup
+{
+    int member;                 // Index des Mitglieds in der Mitgliederliste
+    int next;                   // Nächstes zu sendendes Segment, -1 wenn der Durchlauf beendet ist
+    int end;                    // Erstes Segment nach dem ersten Durchlauf
+    bool sweep;                 // Erster Durchlauf: alle Segmente bis `end` ohne die schon gemeldeten
+    struct answer report;       // Letzte Meldung, Paket-ID 0 bis zur ersten
+    long long finished;         // Ende des letzten Durchlaufs in µs
+    long long heard;            // Letzte Meldung des Mitglieds in µs
+};
+
+
+/**
+ * Struktur: catchup_queue
+ * ------------------------
+ * Alle Mitglieder, die gerade aufholen. Sie werden reihum bedient.
+ */
+struct catchup_queue
+{
+    struct catchup* entries;    // Aufholende Mitglieder
+    int count;                  // Anzahl der Einträge
+    int capacity;               // Plätze in `entries`
+    int turn;                   // Eintrag, der als nächster ein Segment erhält
+};
+
+
+/**
+ * Struktur: fec
+ * --------------
+ * Vorwärtsfehlerkorrektur mit verschachtelter XOR-Parität (--fec n:k). Je `source` Quellpakete 
+ * bilden einen Block, Paritätspaket j ist das XOR aller Quellpakete des Blocks an den 
+ * Positionen j, j + `parity`, j + 2 * `parity`, ... (ein Streifen). Je Streifen kann ein 
+ * verlorenes Paket wiederhergestellt werden, ein Burst von bis zu `parity` Verlusten also ganz.
+ * Der Server rechnet in einem Block, der Client in einem Ring über alle Blöcke im Fenster.
+ */
+struct fec
+{
+    int source;                 // Quellpakete je Block (n), 0 ohne FEC
+    int parity;                 // Paritätspakete je Block (k)
+    int payload_size;           // Bytes Nutzdaten je Streifen
+    int blocks;                 // Anzahl der Blöcke im Ring
+    int* block_ids;             // Blocknummer je Ringplatz, -1 wenn frei
+    unsigned long long* received; // Eingerechnete Quellpakete je Ringplatz, ein Bit je Position
+    unsigned char* data;        // XOR der Nutzdaten, `payload_size` Bytes je Streifen
+    long* xor_len;              // XOR der Längen je Streifen
+    int* max_len;               // Längste Nutzdaten je Streifen
+    bool* has_parity;           // Paritätspaket je Streifen eingerechnet (Client)
+};
+
+
+/**
+ * Struktur: spsc_ring
+ * --------------------
+ * Ring fester Größe zwischen genau einem schreibenden und einem lesenden Thread, ohne Sperren. 
+ * Der Schreiber setzt nur `head`, der Leser nur `tail`, beide liegen in eigenen Cachezeilen.
+ */
+struct spsc_ring
+{
+    _Alignas(64) atomic_uint head;  // Nächster Schreibplatz, nur vom Schreiber verändert
+    _Alignas(64) atomic_uint tail;  // Nächster Leseplatz, nur vom Leser verändert
+    _Alignas(64) unsigned int mask; // Anzahl der Plätze - 1, Anzahl ist eine Zweierpotenz
+    int entry_size;                 // Bytes je Eintrag
+    unsigned char* entries;         // Einträge
+};
+
+
+/**
+ * Struktur: wakeup
+ * -----------------
+ * Weckt einen Thread, der auf einen leeren Ring wartet. Geschrieben wird nur, wenn sich 
+ * der Thread vorher mit `wakeup_arm` schlafen gelegt hat, sonst bleibt es bei einem Lesezugriff.
+ */
+struct wakeup
+{
+    int read_fd;                    // Lesbar, sobald der Thread geweckt wurde (eventfd bzw. Pipe)
+    int write_fd;                   // Schreibseite, unter Linux gleich `read_fd`
+    atomic_bool armed;              // Der Thread wartet bzw. will warten
+};
+
+
+/**
+ * Struktur: prefetch
+ * -------------------
+ * Vom Lese-Thread gelesenes Paket (--pipeline). Mit `length` < 0 ist das Dateiende erreicht.
+ */
+struct prefetch
+{
+    int packet;                     // Puffer im Paketpool des Fensters, PACKET_NONE mit --mmap
+    int length;                     // Länge der Nutzdaten, -1 am Dateiende
+    long long offset;               // Byte-Position in der Datei
+    char* data;                     // Nutzdaten im Puffer bzw. in der eingeblendeten Datei
+};
+
+
+/**
+ * Struktur: feedback
+ * -------------------
+ * Vom Empfangs-Thread dekodierte Antwort eines Clients (--pipeline).
+ */
+struct feedback
+{
+    struct answer ans;              // Antwort
+    struct sockaddr_in6 partner;    // Absender
+};
+
+
+/**
+ * Struktur: pipeline
+ * -------------------
+ * Aufteilung einer Sitzung auf drei Threads (--pipeline). Der Lese-Thread liest die Datei 
+ * voraus in Puffer des Paketpools, der Empfangs-Thread liest und dekodiert die Antworten, 
+ * der Thread der Sitzung sendet, behandelt Timer und wertet die Antworten aus. Verbunden 
+ * sind sie nur über Ringe mit Paket-Handles bzw. Antworten.
+ */
+struct pipeline
+{
+    struct properties* props;       // Eigenschaften der Sitzung (Datei und Einblendung gehören dem Lese-Thread)
+    struct window* window;          // Fenster mit dem Paketpool der Sitzung
+    struct properties receive_props; // Kopie der Eigenschaften mit eigenem Empfangspuffer
+
+    pthread_t reader;               // Lese-Thread, läuft für eine Runde der Übertragung
+    bool reader_started;
+    atomic_bool reader_stop;
+    struct wakeup reader_wake;      // Weckt den Lese-Thread bei neuen freien Puffern
+    struct spsc_ring free;          // Sendethread -> Lese-Thread: freie Puffer
+    struct spsc_ring filled;        // Lese-Thread -> Sendethread: gelesene Pakete
+    int outstanding;                // Puffer beim Lese-Thread (nur Sendethread)
+    bool eof;                       // Dateiende vom Lese-Thread gemeldet (nur Sendethread)
+    struct uring reader_ring;       // Ring des Lese-Threads mit --uring (Binärmodus ohne --mmap), sonst fd -1
+    bool reader_fixed;              // Paketpool ist beim Ring des Lese-Threads registriert
+    long long read_offset;          // Position des nächsten Segments in der Datei (nur Lese-Thread)
+
+    pthread_t receiver;             // Empfangs-Thread, läuft so lange wie die Sitzung
+    bool receiver_started;
+    atomic_bool receiver_stop;
+    atomic_bool receiver_failed;    // Fehler beim Empfang, die Sitzung wird beendet
+    struct wakeup receiver_wake;    // Weckt den Empfangs-Thread zum Beenden
+    struct spsc_ring answers;       // Empfangs-Thread -> Sendethread: Antworten
+    long long dropped;              // Wegen vollem Ring verworfene Antworten (nur Empfangs-Thread)
+
+    struct wakeup sender_wake;      // Weckt den Sendethread bei neuen Paketen oder Antworten
+};
+
+
+/**
+ * Struktur: write_job
+ * --------------------
+ * Schreibauftrag des Clients an den Schreib-Thread (--writequeue), nach dem Schreiben 
+ * kommt er als Rückmeldung zurück.
+ */
+struct write_job
+{
+    int packet;                     // Puffer im Paketpool des Fensters, hält die Nutzdaten
+    int length;                     // Länge der Nutzdaten, in der Rückmeldung -1 bei einem Fehler
+    long long offset;               // Byte-Position in der Datei, -1 zum Anhängen (Textmodus)
+    char* data;                     // Nutzdaten im Puffer
+};
+
+
+/**
+ * Struktur: writer
+ * -----------------
+ * Schreib-Thread des Clients (--writequeue). Der Empfangsthread übergibt die Puffer der 
+ * Pakete über den Ring `jobs` und erhält sie nach dem Schreiben über `done` zurück. Sind 
+ * `bound` Aufträge unterwegs, wartet der Empfangsthread (Gegendruck).
+ * Mit --uring schreibt der Thread alle wartenden Aufträge mit einem `io_uring_enter` aus 
+ * dem beim Ring registrierten Speicher des Pools in die registrierte Zieldatei.
+ */
+struct writer
+{
+    pthread_t thread;               // Der Schreib-Thread
+    bool started;                   // Der Schreib-Thread läuft
+    FILE* file;                     // Zieldatei, im Textmodus schreibt nur noch dieser Thread
+    int bound;                      // Höchstzahl übergebener, noch nicht zurückgemeldeter Aufträge
+    int inflight;                   // Übergebene, noch nicht zurückgemeldete Aufträge (nur Empfangsthread)
+    bool failed;                    // Ein Schreibzugriff ist fehlgeschlagen (nur Empfangsthread)
+    atomic_bool stop;               // Beendet den Schreib-Thread, sobald `jobs` leer ist
+    struct spsc_ring jobs;          // Empfangsthread -> Schreib-Thread
+    struct spsc_ring done;          // Schreib-Thread -> Empfangsthread
+    struct wakeup writer_wake;      // Weckt den Schreib-Thread bei neuen Aufträgen
+    struct wakeup network_wake;     // Weckt den Empfangsthread, wenn er auf Rückmeldungen wartet
+    struct packet_pool* pool;       // Paketpool des Fensters
+    struct segment_map* map;        // Bitmap, die nach dem Schreiben gesetzt wird
+    struct uring ring;              // Gebündeltes Schreiben mit --uring, `ring.fd` -1 ohne
+    bool fixed;                     // Speicher des Pools ist beim Ring registriert
+    long long append;               // Byte-Position für Aufträge zum Anhängen mit --uring
+};
+
+
+/**
+ * Struktur: session
+ * ------------------
+ * Zustand einer Übertragung des Servers mit eigener Datei, Multicast-Gruppe, eigenem Socket 
+ * und Fenster. Die Zustandsmaschine wird mit `session_step` um je eine Iteration 
+ * weitergeschaltet, sodass ein Thread mehrere Sitzungen abwechselnd bedienen kann.
+ */
+struct session
+{
+    struct properties* props;       // Eigenschaften der Sitzung mit Socket und Datei
+    connection_state state;         // Aktueller Zustand
+    bool running;                   // false, sobald die Sitzung beendet ist
+
+    struct communication com;       // Kommunikation: Anfragen und Antworten
+    struct memberlist list_members; // Liste der Mitglieder im Netzwerk
+    struct window window;           // Sendefenster als Ringpuffer
+    int packages_in_queue;          // Anzahl der Pakete im Fenster
+    int base;                       // Basis-ID des aktuellen Fensters
+    int current;                    // Aktuelle Paket ID
+    bool closed;                    // Speichert ob close Paket gepuffert wurde
+
+    struct timer_wheel timers;      // Timer-Rad zur Verwaltung von Timeouts
+    struct event_loop loop;         // Ereignisschleife für Socket und Zeitschlitze
+    long long wake_at;              // Zeitpunkt in µs, zu dem STATE_ESTABLISHED weiterarbeitet, 0 ohne
+    long long idle_until;           // Ende der Wartezeit in STATE_IDLE in µs, 0 vor dem Beginn
+    int slots_left;                 // Verbleibende Zeitschlitze der Registrierung in STATE_PREPARE
+
+    struct pacer pacer;             // Token-Bucket zur Begrenzung der Senderate
+    struct congestion cc;           // Senderate nach den Verlustraten der Empfänger (--congestion)
+    struct repair_queue repairs;    // Gesammelte NACKs bis zur nächsten Wiederholung
+    struct catchup_queue catchups;  // Spät beigetretene Mitglieder, die noch aufholen
+    long long members_checked;      // Letzte Suche nach verstummten Mitgliedern in µs
+    struct pacer catchup;           // Token-Bucket der Senderate zum Aufholen (--catchup)
+    struct fec fec;                 // Parität des aktuellen FEC-Blocks (--fec)
+    struct pipeline* pipeline;      // Threads für Lesen und Empfangen, NULL ohne --pipeline
+};
+
+
+/**
+ * Struktur: worker
+ * -----------------
+ * Ein Thread des Servers mit mehreren Sitzungen (--sessions), an einen Kern gebunden.
+ */
+struct worker
+{
+    pthread_t thread;               // Der Thread
+    int core;                       // Kern, an den der Thread gebunden wird
+    struct session** sessions;      // Die Sitzungen des Threads
+    int count;                      // Anzahl der Sitzungen
 };
 
 
 /* Die Kommentare und Erklärung der Funktionen sind connection.c zu entnehmen! */
 
 void print_timestamp();
+long long get_time_us();
 int setup_properties(int argc, char** argv, struct properties* props);
+int stripe_properties(struct properties* props, int stripe);
+long long segment_offset(struct properties* props, int package_id);
 int start_socket(struct properties* props);
 void close_socket(struct properties* props);
+int transport_init(struct properties* props);
+void transport_attach_pool(struct properties* props, struct packet_pool* pool);
+void transport_free(struct properties* props);
+int transport_fd(struct properties* props);
+int get_interface_mtu(unsigned int ifindex);
 int send_unicast(struct properties *props, struct communication* com);
 int send_multicast(struct properties* props, struct communication* com);
+int flush_cast(struct properties* props);
+int get_request_payload_size(const struct request* req);
+int get_request_wire_size(const struct request* req);
+int encode_request(const struct request* req, unsigned char* buffer, size_t size);
+int encode_request_header(const struct request* req, unsigned char* buffer, size_t size);
+int encode_answer(const struct answer* ans, unsigned char* buffer, size_t size);
+int decode_header(const unsigned char* buffer, size_t len, struct wire_header* header);
+int decode_request(const unsigned char* buffer, size_t len, struct request* req);
+int decode_request_header(const unsigned char* buffer, size_t len, struct request* req);
+int decode_answer(const unsigned char* buffer, size_t len, struct answer* ans);
+bool nack_mark_loss(struct answer* ans, int package_id);
+int nack_next_loss(const struct answer* ans, int package_id);
+int nack_backoff_max_ms(int group_size);
+int nack_backoff_ms(int group_size);
+void rtt_init(struct rtt_estimator* rtt);
+void rtt_sample(struct rtt_estimator* rtt, long long sample_us);
+long long rtt_echo_sample(const struct answer* ans);
+int memberlist_init(struct memberlist* list, int window_size);
+void memberlist_free(struct memberlist* list);
+int member_find(const struct memberlist* list, int member_id, const struct in6_addr* addr);
+int member_add(struct memberlist* list, int member_id, const struct sockaddr_in6* addr);
+void member_remove(struct memberlist* list, int index);
+void member_set_acked(struct memberlist* list, int index, int acked);
+bool member_all_acked(const struct memberlist* list);
+void member_ack_advance(struct memberlist* list);
+int group_rto_ms(struct properties* props, long long rto);
+void member_update_feedback(struct properties* props, struct memberlist* list, int index, const struct answer* ans);
+void loss_history_init(struct loss_history* history);
+bool loss_history_add(struct loss_history* history, int package_id, int rtt_ms);
+double loss_event_rate(const struct loss_history* history);
+double tcp_friendly_rate(int size, double rtt, double loss_rate);
+int nack_timeout_ms(struct properties* props);
+int release_timeout_ms(struct properties* props);
+void print_transport_statistics(struct properties* props);
 int receive_cast(struct properties* props, struct communication* com, struct memberlist* list);
-void add_timer_linked_list_timer(struct linked_list_timer** head, int package_id, int tick);
-void del_timer_linked_list_timer(struct linked_list_timer** head, int package_id);
-int tick_timer_linked_list_timer(struct linked_list_timer** head);
-void print_timer_linked_list_timer(struct linked_list_timer** head);
+int event_loop_init(struct event_loop* loop, struct properties* props, int tick_ms);
+int event_loop_reset(struct event_loop* loop);
+int event_loop_wait(struct event_loop* loop, int timeout_ms, int* ticks);
+int event_loop_fd(struct event_loop* loop);
+int event_loop_watch(struct event_loop* loop, int fd);
+int event_loop_wait_ms(struct event_loop* loop, int timeout_ms);
+void event_loop_close(struct event_loop* loop);
+int timer_wheel_init(struct timer_wheel* wheel, int capacity);
+void timer_wheel_free(struct timer_wheel* wheel);
+void timer_wheel_add(struct timer_wheel* wheel, int package_id, int timeout_ms);
+void timer_wheel_del(struct timer_wheel* wheel, int package_id);
+void timer_wheel_advance(struct timer_wheel* wheel);
+int timer_wheel_expire(struct timer_wheel* wheel);
+int timer_wheel_next_ms(struct timer_wheel* wheel);
+int timer_wheel_wait_ms(struct timer_wheel* wheel, int wait_ms);
+void print_timer_wheel(struct timer_wheel* wheel);
+void pacer_init(struct pacer* pacer, double rate, double burst);
+void pacer_refill(struct pacer* pacer);
+bool pacer_consume(struct pacer* pacer, int bytes);
+void pacer_charge(struct pacer* pacer, int bytes);
+void pacer_set_rate(struct pacer* pacer, double rate);
+int pacer_wait_ms(struct pacer* pacer, int bytes);
+
+int packet_pool_init(struct packet_pool* pool, int count, int buffer_size);
+void packet_pool_free(struct packet_pool* pool);
+int packet_alloc(struct packet_pool* pool);
+void packet_ref(struct packet_pool* pool, int packet);
+void packet_unref(struct packet_pool* pool, int packet);
+unsigned char* packet_data(struct packet_pool* pool, int packet);
+char* packet_payload(struct packet_pool* pool, int packet);
+int window_init(struct window* window, int window_size, int payload_size, bool keep_payload, int extra);
+void window_free(struct window* window);
+bool window_has(struct window* window, int package_id, unsigned char flag);
+void window_set(struct window* window, int package_id, unsigned char flag);
+void window_unset(struct window* window, int package_id, unsigned char flag);
+void window_clear(struct window* window, int package_id);
+struct window_slot* window_get_slot(struct window* window, int package_id);
+char* window_get_payload(struct window* window, int package_id);
+int window_get_wire_size(struct window* window, int package_id);
+char* window_reserve(struct window* window, int package_id);
+void window_set_data(struct window* window, int package_id, char* data);
+void window_store(struct window* window, const struct request* req, int packet);
+int window_load(struct window* window, int package_id, struct request* req);
+int fec_init(struct fec* fec, int source, int parity, int payload_size, int blocks);
+void fec_free(struct fec* fec);
+int fec_block_start(struct fec* fec, int package_id);
+bool fec_add_source(struct fec* fec, const struct request* req, const char* payload);
+void fec_add_parity(struct fec* fec, const struct request* req, const char* payload);
+void fec_get_parity(struct fec* fec, int block_start, int stripe, struct request* req);
+int fec_recover(struct fec* fec, int package_id, struct request* req, char** payload);
+int spsc_ring_init(struct spsc_ring* ring, int capacity, int entry_size);
+void spsc_ring_free(struct spsc_ring* ring);
+void spsc_ring_reset(struct spsc_ring* ring);
+bool spsc_ring_push(struct spsc_ring* ring, const void* entry);
+bool spsc_ring_pop(struct spsc_ring* ring, void* entry);
+bool spsc_ring_empty(struct spsc_ring* ring);
+int wakeup_init(struct wakeup* wakeup);
+void wakeup_free(struct wakeup* wakeup);
+void wakeup_arm(struct wakeup* wakeup);
+void wakeup_signal(struct wakeup* wakeup);
+void wakeup_notify(struct wakeup* wakeup);
+void wakeup_drain(struct wakeup* wakeup);
+int uring_init(struct uring* ring, unsigned int entries);
+void uring_free(struct uring* ring);
+#ifdef __linux__
+struct io_uring_sqe* uring_get_sqe(struct uring* ring);
+int uring_submit(struct uring* ring, unsigned int wait);
+struct io_uring_cqe* uring_peek(struct uring* ring);
+void uring_seen(struct uring* ring);
+void uring_notify(struct uring* ring, bool enabled);
+int uring_register(struct uring* ring, unsigned int opcode, const void* arg, unsigned int count);
+#endif
 
 #endif
@@ -5,61 +5,80 @@
 
 
 /**
- * Struktur: queue
- * ---------------------
- * Speichert die Pakete in der Warteschlange und notiert ob ein TIMEOUT registriert wurde.
- */
-struct queue 
-{
-    bool timeout;
-    struct request req;
-};
-
-
-/**
- * Funktion: shift_queue
- * ---------------------
- * Verschiebt die Elemente einer Warteschlange (`queue`) um eine Position nach vorne.
- * Das erste Element wird entfernt, und alle nachfolgenden Elemente werden einen Schritt 
- * nach vorne verschoben.
+ * Funktion: open_mapped_file
+ * --------------------------
+ * Blendet die Datei schreibgeschützt in den Speicher ein (--mmap). Die Nutzdaten der Pakete 
+ * werden später direkt aus der Einblendung gesendet.
  *
  * Parameter:
- * - queue: Ein Pointer auf einen Pointer zur Warteschlange (Array von `queue`-Elementen).
- * - packages_in_queue: Anzahl der Elemente in der Warteschlange.
+ * - props: Ein Pointer auf die Struktur `properties` mit dem Pfad zur Datei, die 
+ *          Einblendung wird in `map` und `map_size` gespeichert.
  *
  * Rückgabewert:
- * - Keiner (void).
+ * - 0, wenn die Datei eingeblendet wurde.
+ * - -1, wenn die Datei nicht geöffnet oder eingeblendet werden konnte.
  *
  * Beschreibung:
- * - Die Funktion überprüft die Gültigkeit der Eingaben und verschiebt die Elemente 
- *   der Warteschlange um eine Position nach vorne.
- * - Das erste Element der Warteschlange wird dabei "überschrieben", sodass Platz für ein neues Element frei wird.
- * - Die Funktion geht davon aus, dass die Warteschlange als Array von Strukturen implementiert ist.
- *
- * Einschränkungen:
- * - Die Funktion bearbeitet nur die ersten `packages_in_queue` Elemente im Array.
- * - Es wird nicht überprüft, ob genügend Speicherplatz im Array vorhanden ist.
+ * - Die Datei wird der Reihe nach gelesen (MADV_SEQUENTIAL) und sofort vorausgelesen 
+ *   (MADV_WILLNEED), damit der Kernel die Seiten vor dem ersten Zugriff lädt.
+ * - Eine leere Datei wird nicht eingeblendet, es wird dann direkt CLOSE gesendet.
  */
-void shift_queue(struct queue** queue, int packages_in_queue)
+int open_mapped_file(struct properties* props)
 {
-    if(packages_in_queue == 1)
+    int fd = open(props->file_path, O_RDONLY);
+    if(fd < 0)
     {
-        memset((*queue), 0, sizeof(struct queue)); // Lösche das einzige Element
-        return;
+        print_timestamp();
+        printf(RED "Datei konnte nicht geöffnet werden\n" RESET);
+        return -1;
+    }
+
+    struct stat st;
+    if(fstat(fd, &st) < 0)
+    {
+        print_timestamp();
+        printf(RED "Größe der Datei konnte nicht bestimmt werden\n" RESET);
+        close(fd);
+        return -1;
     }
 
-    // Elemente verschieben
-    for(int i = 1; i < packages_in_queue; i++)
+    props->map = NULL;
+    props->map_size = (size_t)st.st_size;
+    props->map_pos = 0;
+    props->file_size = (long long)st.st_size;
+
+    if(props->map_size > 0)
     {
-        (*queue)[i - 1] = (*queue)[i]; // Verschiebe jedes Element um eine Position nach vorne
+        void* map = mmap(NULL, props->map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(map == MAP_FAILED)
+        {
+            print_timestamp();
+            printf(RED "Datei konnte nicht eingeblendet werden\n" RESET);
+            perror("\t\t");
+            close(fd);
+            return -1;
+        }
+
+        madvise(map, props->map_size, MADV_SEQUENTIAL);
+        madvise(map, props->map_size, MADV_WILLNEED);
+        props->map = map;
     }
+
+    // Die Einblendung bleibt auch nach dem Schließen des Deskriptors gültig
+    close(fd);
+
+    print_timestamp();
+    printf(GREEN "Datei mit %zu Bytes eingeblendet\n" RESET, props->map_size);
+    return 0;
 }
 
+
 /**
  * Funktion: open_file
  * --------------------
  * Öffnet eine Datei im Lesemodus anhand des Dateipfads, der in der `properties`-Struktur gespeichert ist,
  * und speichert den Datei-Zeiger in der Struktur. Überprüft, ob die Datei erfolgreich geöffnet wurde.
+ * Mit --mmap wird die Datei stattdessen mit `open_mapped_file` eingeblendet.
  *
  * Parameter:
  * - props: Ein Pointer auf die Struktur `properties`, die den Pfad zur Datei (`file_path`) 
@@ -71,6 +90,12 @@ void shift_queue(struct queue** queue, int packages_in_queue)
  */
 int open_file(struct properties* props)
 {
+    if(props->use_mmap)
+    {
+        props->file = NULL;
+        return open_mapped_file(props);
+    }
+
     // Datei im Lesemodus ("r") öffnen
     props->file = fopen(props->file_path, "r");
     if (props->file == NULL) 
@@ -80,6 +105,10 @@ int open_file(struct properties* props)
         return -1;
     }
 
+    // Größe für das HELLO bestimmen, damit Clients die Datei vorab anlegen können
+    struct stat st;
+    props->file_size = fstat(fileno(props->file), &st) == 0 && S_ISREG(st.st_mode) ? (long long)st.st_size : -1;
+
     print_timestamp();
     printf(GREEN "Datei geöffnet\n" RESET); // Erfolgsmeldung
     return 0;
@@ -88,22 +117,165 @@ int open_file(struct properties* props)
 
 
 /**
- * Funktion: get_file_line
- * ------------------------
- * Liest eine Zeile aus der Datei, die in `props->file` geöffnet ist, 
- * und speichert sie im bereitgestellten Puffer `line`.
+ * Funktion: open_rate_log
+ * -----------------------
+ * Öffnet die CSV-Datei für den Verlauf der Senderate (--ratelog) und schreibt die Kopfzeile.
  *
  * Parameter:
- * - props: Ein Pointer auf die Struktur `properties`, die den Datei-Zeiger enthält.
- * - line: Ein Puffer, in dem die gelesene Zeile gespeichert wird.
+ * - props: Ein Pointer auf die Struktur `properties` mit dem Pfad (`rate_log_path`).
+ *
+ * Rückgabewert:
+ * - 0, wenn kein Rate-Log verlangt ist oder die Datei geöffnet wurde.
+ * - -1, wenn die Datei nicht geöffnet werden konnte.
  */
-int get_file_line(struct properties* props, char* line)
+int open_rate_log(struct properties* props)
 {
-    if(fgets(line, DEFAULT_DATA_BUFFER_SIZE, props->file) == NULL)
+    if(props->rate_log_path[0] == '\0')
+    {
+        return 0;
+    }
+
+    props->rate_log = fopen(props->rate_log_path, "w");
+    if(props->rate_log == NULL)
     {
+        print_timestamp();
+        printf(RED "Rate-Log konnte nicht geöffnet werden\n" RESET);
         return -1;
     }
 
+    fprintf(props->rate_log, "zeit_s;rate_kbit;clr_id;verlustrate;rtt_ms\n");
+    return 0;
+}
+
+
+/**
+ * Funktion: close_file
+ * --------------------
+ * Schließt die Datei bzw. hebt ihre Einblendung auf. Ein offenes Rate-Log wird ebenfalls geschlossen.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties` mit Datei-Zeiger bzw. Einblendung.
+ */
+void close_file(struct properties* props)
+{
+    if(props->rate_log != NULL)
+    {
+        fclose(props->rate_log);
+        props->rate_log = NULL;
+    }
+
+    if(props->map != NULL)
+    {
+        munmap(props->map, props->map_size);
+        props->map = NULL;
+    }
+
+    if(props->file != NULL)
+    {
+        fclose(props->file);
+        props->file = NULL;
+    }
+}
+
+
+/**
+ * Funktion: rewind_file
+ * ---------------------
+ * Setzt die Leseposition für eine neue Runde (--loop) auf den Anfang der Datei bzw. mit 
+ * --stripes auf das erste Segment des Streifens.
+ * Eine eingeblendete Datei wird dabei nicht erneut gelesen, sondern kommt aus dem Seitencache.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties` mit Datei-Zeiger bzw. Einblendung.
+ */
+void rewind_file(struct properties* props)
+{
+    long long start = props->binary ? segment_offset(props, 1) : 0;
+
+    if(props->use_mmap)
+    {
+        props->map_pos = (size_t)start;
+        return;
+    }
+
+    rewind(props->file);
+    if(start > 0)
+    {
+        fseeko(props->file, (off_t)start, SEEK_SET);
+    }
+}
+
+
+/**
+ * Funktion: hash_file
+ * -------------------
+ * Berechnet im Binärmodus die Prüfsumme der Datei (FNV-1a über 64-Bit-Wörter), die im HELLO 
+ * mitgesendet wird. Ein neu gestarteter Client erkennt daran, ob sein Prüfpunkt zu dieser 
+ * Datei gehört. Die Leseposition bleibt unverändert.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties` mit Datei-Zeiger bzw. Einblendung, 
+ *          die Prüfsumme wird in `file_hash` gespeichert.
+ *
+ * Rückgabewert:
+ * - 0, wenn die Prüfsumme berechnet wurde oder im Textmodus bzw. bei unbekannter Größe keine nötig ist.
+ * - -1, wenn die Datei nicht gelesen werden konnte.
+ */
+int hash_file(struct properties* props)
+{
+    props->file_hash = 0;
+    if(!props->binary || props->file_size <= 0)
+    {
+        return 0;
+    }
+
+    static unsigned char chunk[1 << 16];
+    uint64_t hash = 14695981039346656037ull;
+    long long done = 0;
+
+    while(done < props->file_size)
+    {
+        const unsigned char* data;
+        size_t length = props->file_size - done < (long long)sizeof(chunk) ? (size_t)(props->file_size - done) : sizeof(chunk);
+        if(props->use_mmap)
+        {
+            data = (const unsigned char*)props->map + done;
+        }
+        else
+        {
+            if(pread(fileno(props->file), chunk, length, (off_t)done) != (ssize_t)length)
+            {
+                print_timestamp();
+                printf(RED "Prüfsumme der Datei konnte nicht berechnet werden\n" RESET);
+                perror("\t\t");
+                return -1;
+            }
+            data = chunk;
+        }
+
+        // Ganze Wörter auf einmal, nur der Rest der Datei byteweise. Die Wörter werden wie 
+        // auf der Leitung big-endian gelesen, damit die Prüfsumme nicht von der Architektur abhängt
+        size_t i = 0;
+        for(; i + 8 <= length; i += 8)
+        {
+            const unsigned char* bytes = data + i;
+            uint64_t word = ((uint64_t)bytes[0] << 56) | ((uint64_t)bytes[1] << 48) | ((uint64_t)bytes[2] << 40) | ((uint64_t)bytes[3] << 32)
+                | ((uint64_t)bytes[4] << 24) | ((uint64_t)bytes[5] << 16) | ((uint64_t)bytes[6] << 8) | (uint64_t)bytes[7];
+            hash = (hash ^ word) * 1099511628211ull;
+        }
+        for(; i < length; i++)
+        {
+            hash = (hash ^ data[i]) * 1099511628211ull;
+        }
+
+        done += length;
+    }
+
+    // 0 steht auf der Leitung für eine unbekannte Prüfsumme
+    props->file_hash = hash != 0 ? hash : 1;
+
+    print_timestamp();
+    printf(GREEN "Prüfsumme der Datei: %016llx\n" RESET, props->file_hash);
     return 0;
 }
 
@@ -123,17 +295,151 @@ int get_file_line(struct properties* props, char* line)
  * - Die Funktion zählt die Anzahl der Zeichen in der Zeichenkette `line`, 
  *   bis der erste Zeilenumbruch (`\n`) gefunden wird.
  * - Der Zeilenumbruch (`\n`) wird in die berechnete Länge einbezogen.
- * - Es wird davon ausgegangen, dass die Zeichenkette garantiert einen Zeilenumbruch enthält.
+ * - Fehlt der Zeilenumbruch (letzte Zeile der Datei oder Zeile länger als der Puffer), 
+ *   wird bis zum Ende der Zeichenkette gezählt.
  */
 int get_line_length(char* line)
 {
     int c = 0; // Zähler für die Länge der Zeichenkette
-    while(line[c] != '\n') // Schleife bis zum Zeilenumbruch
+    while(line[c] != '\n' && line[c] != '\0') // Schleife bis zum Zeilenumbruch
     {
         c += 1;
     }
 
-    return c + 1; // Länge inklusive des Zeilenumbruchs zurückgeben
+    if(line[c] == '\n')
+    {
+        c += 1; // Zeilenumbruch mitzählen
+    }
+
+    return c;
+}
+
+
+/**
+ * Funktion: get_file_line
+ * ------------------------
+ * Liest eine Zeile aus der Datei, die in `props->file` geöffnet ist, 
+ * und speichert sie im bereitgestellten Puffer `line`.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties`, die den Datei-Zeiger enthält.
+ * - line: Ein Puffer, in dem die gelesene Zeile gespeichert wird.
+ *
+ * Rückgabewert:
+ * - Länge der Zeile (siehe `get_line_length`).
+ * - -1 am Dateiende oder bei einem Lesefehler.
+ */
+int get_file_line(struct properties* props, char* line)
+{
+    if(fgets(line, DEFAULT_DATA_BUFFER_SIZE, props->file) == NULL)
+    {
+        return -1;
+    }
+
+    return get_line_length(line);
+}
+
+
+/**
+ * Funktion: get_file_segment
+ * --------------------------
+ * Liest das nächste Segment von höchstens `segment_size` Bytes aus der Datei. Mit --stripes 
+ * werden danach die Segmente der anderen Streifen übersprungen.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties`, die den Datei-Zeiger und die Segmentgröße enthält.
+ * - segment: Ein Puffer mit mindestens `segment_size` Bytes.
+ *
+ * Rückgabewert:
+ * - Anzahl der gelesenen Bytes.
+ * - -1 am Dateiende oder bei einem Lesefehler.
+ */
+int get_file_segment(struct properties* props, char* segment)
+{
+    size_t length = fread(segment, 1, props->segment_size, props->file);
+    if(length == 0)
+    {
+        return -1;
+    }
+
+    if(props->stripes > 1)
+    {
+        fseeko(props->file, (off_t)(props->stripes - 1) * props->segment_size, SEEK_CUR);
+    }
+
+    return (int)length;
+}
+
+
+/**
+ * Funktion: get_mapped_line
+ * -------------------------
+ * Liefert die nächste Zeile der eingeblendeten Datei, ohne sie zu kopieren. Wie bei `fgets` 
+ * endet eine Zeile nach dem Zeilenumbruch oder nach DEFAULT_DATA_BUFFER_SIZE - 1 Bytes.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties` mit der Einblendung.
+ * - line: Ausgabe des Zeigers auf die Zeile in der Einblendung.
+ *
+ * Rückgabewert:
+ * - Länge der Zeile in Bytes.
+ * - -1 am Dateiende.
+ */
+int get_mapped_line(struct properties* props, char** line)
+{
+    if(props->map == NULL || props->map_pos >= props->map_size)
+    {
+        return -1;
+    }
+
+    size_t length = props->map_size - props->map_pos;
+    if(length > DEFAULT_DATA_BUFFER_SIZE - 1)
+    {
+        length = DEFAULT_DATA_BUFFER_SIZE - 1;
+    }
+
+    *line = props->map + props->map_pos;
+    char* newline = memchr(*line, '\n', length);
+    if(newline != NULL)
+    {
+        length = (size_t)(newline - *line) + 1; // Zeilenumbruch mitzählen
+    }
+
+    props->map_pos += length;
+    return (int)length;
+}
+
+
+/**
+ * Funktion: get_mapped_segment
+ * ----------------------------
+ * Liefert das nächste Segment von höchstens `segment_size` Bytes der eingeblendeten Datei, 
+ * ohne es zu kopieren. Mit --stripes werden danach die Segmente der anderen Streifen übersprungen.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die Struktur `properties` mit der Einblendung und der Segmentgröße.
+ * - segment: Ausgabe des Zeigers auf das Segment in der Einblendung.
+ *
+ * Rückgabewert:
+ * - Anzahl der Bytes des Segments.
+ * - -1 am Dateiende.
+ */
+int get_mapped_segment(struct properties* props, char** segment)
+{
+    if(props->map == NULL || props->map_pos >= props->map_size)
+    {
+        return -1;
+    }
+
+    size_t length = props->map_size - props->map_pos;
+    if(length > (size_t)props->segment_size)
+    {
+        length = props->segment_size;
+    }
+
+    *segment = props->map + props->map_pos;
+    props->map_pos += props->stripes > 1 ? (size_t)props->stripes * props->segment_size : length;
+    return (int)length;
 }
 
 
@@ -155,6 +461,10 @@ int get_line_length(char* line)
  * - Setzt den Nachrichtentyp (`REQ_HELLO`) in der Anfragestruktur.
  * - Initialisiert relevante Felder wie `packageId`, `packageLen`, `senderId`, `reciverId`, und `data`.
  * - Überträgt die Fenstergröße (`windows_size`) als Paketlänge.
+ * - Überträgt im Binärmodus die Segmentgröße als `offset`, im Textmodus 0.
+ * - Überträgt die Dateigröße (`fileSize`), die Gruppengröße für --suppress, die 
+ *   FEC-Parameter für --fec, die Prüfsumme der Datei (`fileHash`) und den Streifen für 
+ *   --stripes als Nutzdaten.
  * - Löscht den Datenpuffer (`data`), da für ein "Hello"-Paket keine Nutzdaten erforderlich sind.
  */
 void prepare_hello_package(struct properties* props, struct communication* com)
@@ -162,9 +472,19 @@ void prepare_hello_package(struct properties* props, struct communication* com)
     com->req.type = REQ_HELLO;            // Nachrichtentyp: "Hello"
     com->req.packageId = 0;               // Paket-ID: 0 für Initialnachrichten
     com->req.packageLen = props->windows_size; // Fenstergröße als Paketlänge
+    com->req.offset = props->binary ? props->segment_size : 0; // Segmentgröße, 0 im Textmodus
+    com->req.fileSize = props->file_size; // Dateigröße, -1 wenn unbekannt
+    com->req.fileHash = props->file_hash; // Prüfsumme der Datei, 0 wenn unbekannt
+    com->req.groupSize = props->group_size; // Gruppengröße, 0 ohne NACK-Unterdrückung
+    com->req.fecSource = props->fec_source; // Quellpakete je FEC-Block, 0 ohne FEC
+    com->req.fecParity = props->fec_parity; // Paritätspakete je FEC-Block
+    com->req.stripe = props->stripe;      // Index des Streifens, 0 ohne --stripes
+    com->req.stripes = props->stripes;    // Anzahl der Streifen, 1 ohne --stripes
     com->req.senderId = props->id;        // Absender-ID aus den Eigenschaften
     com->req.reciverId = -1;              // Empfänger-ID: Broadcast (-1 bedeutet, an alle senden)
     memset(com->req.data, 0, DEFAULT_DATA_BUFFER_SIZE); // Datenpuffer löschen
+    com->packet = PACKET_NONE;            // Keine Nutzdaten im Paketpool
+    com->payload = NULL;
 }
 
 
@@ -179,25 +499,49 @@ void prepare_hello_package(struct properties* props, struct communication* com)
  * - props: Ein Pointer auf die `properties`-Struktur, die Server- oder Client-Eigenschaften wie die ID speichert.
  * - com: Ein Pointer auf die `communication`-Struktur, in der die Anfragedaten (`req`) gespeichert werden.
  * - package_id: Die ID des Pakets, das gesendet werden soll.
- * - line: Ein Zeiger auf den Datenpuffer (Zeichenkette), der im Paket enthalten sein soll.
+ * - length: Länge der Zeile, die im Puffer des Fensters bzw. in der eingeblendeten Datei liegt.
  *
  * Rückgabewert:
  * - Keiner (void).
  *
  * Beschreibung:
  * - Setzt den Nachrichtentyp (`REQ_DATA`) in der Anfragestruktur.
- * - Initialisiert relevante Felder wie `packageId`, `packageLen`, `senderId`, `reciverId`, und `data`.
- * - Berechnet die Länge der Daten (`line`) und speichert sie in `packageLen`.
- * - Kopiert die Daten (`line`) in den Datenpuffer der Anfrage.
+ * - Initialisiert relevante Felder wie `packageId`, `packageLen`, `senderId` und `reciverId`.
+ * - Die Daten werden nicht kopiert, sie bleiben im Puffer des Fensters bzw. in der Datei.
  */
-void prepare_data_package(struct properties* props, struct communication* com, int package_id, char* line)
+void prepare_data_package(struct properties* props, struct communication* com, int package_id, int length)
 {
     com->req.type = REQ_DATA;                      // Nachrichtentyp: Datenpaket
     com->req.packageId = package_id;              // ID des Pakets
-    com->req.packageLen = get_line_length(line);  // Länge der Daten berechnen
+    com->req.packageLen = length;                 // Länge der Zeile
+    com->req.offset = 0;                          // Zeilen werden der Reihe nach geschrieben
+    com->req.senderId = props->id;                // Absender-ID aus den Eigenschaften
+    com->req.reciverId = -1;                      // Empfänger-ID: Broadcast (-1 bedeutet, an alle senden)
+}
+
+
+/**
+ * Funktion: prepare_segment_package
+ * ---------------------------------
+ * Bereitet ein binäres Segment der Datei vor. Das Segment trägt seine Länge und seine
+ * Byte-Position in der Datei, damit der Client es unabhängig von der Reihenfolge
+ * byte-genau an die richtige Stelle schreiben kann.
+ *
+ * Parameter:
+ * - props: Ein Pointer auf die `properties`-Struktur, die die ID speichert.
+ * - com: Ein Pointer auf die `communication`-Struktur, in der die Anfragedaten (`req`) gespeichert werden.
+ * - package_id: Die ID des Pakets.
+ * - length: Anzahl der Bytes des Segments im Puffer des Fensters.
+ * - offset: Byte-Position des Segments in der Datei.
+ */
+void prepare_segment_package(struct properties* props, struct communication* com, int package_id, int length, long long offset)
+{
+    com->req.type = REQ_SEGMENT;                  // Nachrichtentyp: Binäres Segment
+    com->req.packageId = package_id;              // ID des Pakets
+    com->req.packageLen = length;                 // Länge der Nutzdaten
+    com->req.offset = offset;                     // Byte-Position in der Datei
     com->req.senderId = props->id;                // Absender-ID aus den Eigenschaften
     com->req.reciverId = -1;                      // Empfänger-ID: Broadcast (-1 bedeutet, an alle senden)
-    strcpy(com->req.data, line);                  // Kopiere die Daten in den Puffer
 }
 
 
@@ -227,494 +571,2920 @@ void prepare_close_package(struct properties* props, struct communication* com,
     com->req.type = REQ_CLOSE;          // Nachrichtentyp: Schließen
     com->req.packageId = package_id;   // ID des Pakets, das geschlossen wird
     com->req.packageLen = 0;           // Keine Nutzdaten
+    com->req.offset = 0;               // Keine Byte-Position
     com->req.senderId = props->id;     // Absender-ID wird aus den Eigenschaften übernommen
     com->req.reciverId = -1;           // Empfänger-ID: Broadcast (-1 bedeutet, an alle senden)
     memset(com->req.data, 0, DEFAULT_DATA_BUFFER_SIZE); // Datenpuffer löschen
+    com->packet = PACKET_NONE;         // Keine Nutzdaten im Paketpool
+    com->payload = NULL;
 }
 
 
 /**
- * Funktion: run_state_machine
- * ----------------------------------
- * Implementiert die Zustandsmaschine für den Server, beginnend mit dem Init-Zustand.
- * Die Zustandsmaschine steuert den Ablauf des Servers durch verschiedene Zustände,
- * von der Initialisierung über die Kommunikation bis zur Beendigung.
+ * Funktion: send_data_package
+ * ---------------------------
+ * Sendet das Paket in `com->req` per Multicast oder per Unicast an `com->partner` 
+ * und simuliert dabei den mit --debug eingestellten Paketverlust.
  *
  * Parameter:
- * - props: Pointer auf die `properties`-Struktur mit Server-Informationen.
+ * - props: Pointer auf die `properties`-Struktur mit Socket und Debug-Code.
+ * - com: Pointer auf die `communication`-Struktur mit dem zu sendenden Paket.
+ * - unicast: true, wenn das Paket nur an `com->partner` gesendet werden soll.
+ *
+ * Rückgabewert:
+ * - 0: Paket gesendet oder absichtlich verworfen.
+ * - -1: Fehler beim Senden.
  */
-void run_state_machine(struct properties* props) 
+int send_data_package(struct properties* props, struct communication* com, bool unicast)
 {
-    // Lokale Variablen initialisieren
-    struct communication com;               // Kommunikation: Anfragen und Antworten
-    struct memberlist list_members;         // Liste der Mitglieder im Netzwerk
-        
-    struct queue* queue = NULL;             // Warteschlange für zu sendende Pakete
-    int packages_in_queue;                  // Anzahl der Pakete in der Warteschlange
-    int base;                               // Basis-ID des aktuellen Fensters
-    int current;                            // Aktuelle Paket ID
-
-    struct linked_list_timer* timer_list;   // Timer-Liste zur Verwaltung von Timeouts
-    
-    bool closed = false;                    // Speichert ob close Paket gepuffert wurde
-
-    // Startzustand setzen
-    connection_state state = STATE_INIT;   // Initialzustand
-    bool running = true;                   // Steuerung der Hauptschleife
+    // Paketverlust simulieren
+    if(props->debug_code > 0 && (rand()%100)+1 <= props->debug_code)
+    {
+        print_timestamp();
+        printf(RED "Paket %d verloren\n" RESET, com->req.packageId);
+        return 0;
+    }
 
-    srand(time(NULL)); // Zufallsgenerator initialisieren
+    // Verlust des CLOSE Pakets simulieren
+    if(props->debug_code == -1 && com->req.type == REQ_CLOSE)
+    {
+        props->debug_code = 0;
+        print_timestamp();
+        printf(RED "CLOSE Paket verloren\n" RESET);
+        return 0;
+    }
 
-    // Hauptschleife der Zustandsmaschine
-    while(running) 
+    if(unicast)
     {
-        switch (state) 
+        if(send_unicast(props, com) < 0)
         {
-            case STATE_INIT:
-            {
-                // Initialisierung des Servers
-                list_members.number_members = 0; // Leere Mitgliederliste
-                
-                // Warteschlange freigeben, falls vorhanden
-                if(queue != NULL)
-                {
-                    free(queue);
-                }
-                
-                // Warteschlange erstellen
-                queue = malloc(sizeof(struct queue) * props->windows_size);
+            return -1;
+        }
 
-                // Datei auf Anfang zurücksetzen
-                rewind(props->file);
-                
-                // Kommunikationsstruktur initialisieren
-                com.ans.type = '0';
+        print_timestamp();
+        printf(GREEN "Paket %d gesendet an Empfänger mit Id %d\n" RESET, com->req.packageId, com->req.reciverId);
+        return 0;
+    }
 
-                // Variablen initialisieren
-                packages_in_queue = 0;
-                base = 1;
-                current = 1;
+    if(send_multicast(props, com) < 0)
+    {
+        return -1;
+    }
 
-                timer_list = NULL; // Timer-Liste initialisieren
+    print_timestamp();
+    printf(GREEN "Paket %d gesendet\n" RESET, com->req.packageId);
+    return 0;
+}
 
-                closed = false;     // Pufferendemarkierung zurücksetzen
 
-                // Zustand wechseln
-                print_timestamp();
-                printf("Wechsel zu STATE_IDLE\n");
-                state = STATE_IDLE;
-                break;
-            }
+/**
+ * Funktion: send_parity_packages
+ * ------------------------------
+ * Rechnet ein erstmals gesendetes Quellpaket in die Parität des Blocks ein. Schließt es den 
+ * Block ab, werden die `fec_parity` Paritätspakete des Blocks per Multicast gesendet.
+ * Wiederholungen werden nicht eingerechnet, der letzte unvollständige Block vor CLOSE 
+ * erhält keine Parität und wird nur über NACKs repariert.
+ *
+ * Parameter:
+ * - props: Eigenschaften des Servers.
+ * - com: Kommunikationsstruktur mit dem gerade gesendeten Quellpaket, wird überschrieben.
+ * - fec: Parität des aktuellen Blocks.
+ * - pacer: Token-Bucket, wird mit den Paritätspaketen belastet.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 wenn ein Paritätspaket nicht gesendet werden konnte.
+ */
+int send_parity_packages(struct properties* props, struct communication* com, struct fec* fec, struct pacer* pacer)
+{
+    if(fec->source == 0 || (com->req.type != REQ_DATA && com->req.type != REQ_SEGMENT))
+    {
+        return 0;
+    }
 
-            case STATE_IDLE:
-            {
-                // Wartezeit
-                print_timestamp();
-                printf(BLUE "Warte... %is\n" RESET, DEFAULT_IDLE_TIME);
-                sleep(DEFAULT_IDLE_TIME); // Warten
+    if(!fec_add_source(fec, &com->req, com->payload != NULL ? com->payload : com->req.data))
+    {
+        return 0;
+    }
 
-                // Hello-Paket vorbereiten und senden
-                prepare_hello_package(props, &com);
-                if(send_multicast(props, &com)<0)
-                {
-                    running = false; // Fehler beim Senden
-                }
-                
-                // Zustand wechseln
-                print_timestamp();
-                printf("Wechsel zu STATE_PREPARE\n");
-                state = STATE_PREPARE;
-                break;
-            }
+    int block_start = fec_block_start(fec, com->req.packageId);
+    com->packet = PACKET_NONE;
+    com->payload = NULL;
+    com->req.senderId = props->id;
+    com->req.reciverId = -1;
 
-            case STATE_PREPARE:
+    for(int stripe = 0; stripe < fec->parity; stripe++)
+    {
+        fec_get_parity(fec, block_start, stripe, &com->req);
+        pacer_charge(pacer, get_request_wire_size(&com->req));
+
+        if(send_data_package(props, com, false) < 0)
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+
+/**
+ * Funktion: handle_ack
+ * --------------------
+ * Übernimmt die kumulative Bestätigung eines ACKs bzw. CLOSE in das Mitglied, von dem sie 
+ * stammt. Bestätigungen für noch nicht gesendete Pakete werden ignoriert.
+ *
+ * Parameter:
+ * - list: Die Mitgliederliste.
+ * - index: Index des Absenders (`com->member`).
+ * - ans: Die empfangene Antwort.
+ * - current: Die nächste noch nicht gesendete Paket-ID (in STATE_CLOSE die des CLOSE-Pakets).
+ */
+void handle_ack(struct memberlist* list, int index, const struct answer* ans, int current)
+{
+    if(ans->type != ANS_ACK && ans->type != ANS_CLOSE)
+    {
+        return;
+    }
+
+    if(index >= 0 && index < list->number_members && ans->packageId <= current + 1)
+    {
+        member_set_acked(list, index, ans->packageId);
+    }
+}
+
+
+/**
+ * Funktion: member_rtt_s
+ * ----------------------
+ * Liefert die geglättete RTT eines Mitglieds in Sekunden, ohne Messung das Start-RTO.
+ */
+static double member_rtt_s(const struct member* member)
+{
+    return (member->rtt.srtt > 0 ? member->rtt.srtt : DEFAULT_RTO * 1000LL) / 1000000.0;
+}
+
+
+/**
+ * Funktion: congestion_feedback
+ * -----------------------------
+ * Übernimmt die Rückmeldung eines Mitglieds in die Ratenregelung, ohne die übrigen Mitglieder 
+ * zu durchlaufen. Ist seine TCP-freundliche Rate kleiner als die des bisher langsamsten 
+ * Empfängers, wird es sofort zum langsamsten. Ist es bereits der langsamste, gilt seine neue 
+ * Rate, auch wenn sie gestiegen ist. Ob dann ein anderer langsamer ist, klärt der nächste 
+ * Durchlauf in `update_congestion`.
+ *
+ * Parameter:
+ * - props: Eigenschaften des Servers mit Paketgröße.
+ * - cc: Zustand der Ratenregelung.
+ * - list: Die Mitgliederliste.
+ * - index: Index des Absenders, -1 wenn unbekannt.
+ */
+void congestion_feedback(struct properties* props, struct congestion* cc, struct memberlist* list, int index)
+{
+    if(index < 0 || index >= list->number_members)
+    {
+        return;
+    }
+
+    int size = (props->binary ? props->segment_size : DEFAULT_DATA_BUFFER_SIZE) + WIRE_REQUEST_HEADER_SIZE + IPV6_UDP_HEADER_SIZE;
+    struct member* member = &list->member[index];
+
+    double rtt = member_rtt_s(member);
+    if(rtt > cc->max_rtt)
+    {
+        cc->max_rtt = rtt;
+    }
+
+    double rate = tcp_friendly_rate(size, rtt, member->loss_rate);
+    if(index == cc->slowest || (rate > 0 && (cc->slowest < 0 || rate < cc->slowest_rate)))
+    {
+        cc->slowest = rate > 0 ? index : -1;
+        cc->slowest_rate = rate;
+    }
+}
+
+
+/**
+ * Funktion: update_congestion
+ * ---------------------------
+ * Bestimmt die Senderate nach TFMCC. Für jedes Mitglied mit gemeldeter Verlustrate wird die 
+ * TCP-freundliche Rate aus Verlustrate und gemessener RTT berechnet, das Mitglied mit der 
+ * kleinsten Rate ist der begrenzende Empfänger (CLR). Liegt dessen Rate unter der aktuellen, 
+ * wird sofort auf sie gesenkt, sonst steigt die Rate um höchstens ein Paket pro RTT je RTT 
+ * bis zur Rate des CLR bzw. bis --rate. Ohne --congestion bleibt die Rate fest und wird 
+ * nur protokolliert. Das Rate-Log zeigt den langsamsten Empfänger auch, wenn er nicht begrenzt.
+ *
+ * Parameter:
+ * - props: Eigenschaften des Servers mit Paketgröße und Rate-Log.
+ * - cc: Zustand der Ratenregelung.
+ * - list: Die Mitgliederliste mit Verlustraten und RTTs.
+ * - pacer: Token-Bucket, dessen Rate gesetzt wird.
+ *
+ * Beschreibung:
+ * - Zwischen zwei Aufrufen hält `congestion_feedback` den langsamsten Empfänger aktuell. 
+ *   Nur alle DEFAULT_REPORT_INTERVAL ms werden alle Mitglieder durchlaufen, um ihn und das 
+ *   RTO des Servers neu zu bestimmen. Beide können dabei auch sinken.
+ */
+void update_congestion(struct properties* props, struct congestion* cc, struct memberlist* list, struct pacer* pacer)
+{
+    int size = (props->binary ? props->segment_size : DEFAULT_DATA_BUFFER_SIZE) + WIRE_REQUEST_HEADER_SIZE + IPV6_UDP_HEADER_SIZE;
+    long long now = get_time_us();
+
+    // Langsamsten Empfänger und größtes RTO regelmäßig über alle Mitglieder neu bestimmen
+    if(now - cc->scanned >= DEFAULT_REPORT_INTERVAL * 1000LL)
+    {
+        cc->scanned = now;
+        cc->slowest = -1;
+        cc->max_rtt = 0;
+
+        long long rto = 0;
+        for(int i = 0; i < list->number_members; i++)
+        {
+            congestion_feedback(props, cc, list, i);
+            if(list->member[i].rtt.rto > rto)
+            {
+                rto = list->member[i].rtt.rto;
+            }
+        }
+
+        if(rto > 0)
+        {
+            props->rto = group_rto_ms(props, rto);
+        }
+    }
+
+    // Der langsamste Empfänger begrenzt nur unterhalb von --rate (CLR)
+    struct member* slowest = cc->slowest >= 0 ? &list->member[cc->slowest] : NULL;
+    double slowest_rtt = slowest != NULL ? member_rtt_s(slowest) : 0;
+    int clr = slowest != NULL && cc->slowest_rate < cc->max_rate ? slowest->member_id : -1;
+    double target = clr >= 0 ? cc->slowest_rate : cc->max_rate;
+
+    double elapsed = (now - cc->updated) / 1000000.0;
+    cc->updated = now;
+    cc->clr = clr;
+
+    if(props->congestion)
+    {
+        double rtt = clr >= 0 ? slowest_rtt : cc->max_rtt;
+        if(target < cc->rate)
+        {
+            cc->rate = target;
+        }
+        else if(rtt > 0)
+        {
+            cc->rate += size * elapsed / (rtt * rtt);
+            if(cc->rate > target)
+            {
+                cc->rate = target;
+            }
+        }
+
+        // Untergrenze aus RFC 5348: ein Paket in 64 Sekunden
+        if(cc->rate < size / 64.0)
+        {
+            cc->rate = size / 64.0;
+        }
+
+        pacer_set_rate(pacer, cc->rate);
+    }
+
+    if(now - cc->logged < DEFAULT_REPORT_INTERVAL * 1000LL)
+    {
+        return;
+    }
+    cc->logged = now;
+
+    int slowest_id = slowest != NULL ? slowest->member_id : -1;
+    double slowest_loss = slowest != NULL ? slowest->loss_rate : 0;
+
+    if(slowest != NULL)
+    {
+        print_timestamp();
+        printf(BLUE "Senderate %.0f kbit/s, langsamster Empfänger Id %d (%s) mit Verlustrate %.4f und RTT %.3f ms\n" RESET, 
+            cc->rate * 8 / 1000, slowest_id, clr >= 0 ? "CLR" : "unter --rate", slowest_loss, slowest_rtt * 1000);
+    }
+
+    // Verlauf für --ratelog, die Zeit zählt ab dem Beginn der Übertragung
+    if(props->rate_log != NULL)
+    {
+        fprintf(props->rate_log, "%.3f;%.1f;%d;%.6f;%.3f\n", (now - cc->started) / 1000000.0, 
+            cc->rate * 8 / 1000, slowest_id, slowest_loss, slowest_rtt * 1000);
+    }
+}
+
+
+/**
+ * Funktion: handle_timeouts
+ * -------------------------
+ * Dreht das Timer-Rad bis zur aktuellen Zeit weiter und markiert alle Pakete mit 
+ * abgelaufenem Timer im Fenster.
+ *
+ * Parameter:
+ * - timers: Timer-Rad der Pakete.
+ * - window: Sendefenster.
+ * - ticks: Anzahl der seit dem letzten Aufruf abgelaufenen Zeitschlitze.
+ *
+ * Rückgabewert:
+ * - Anzahl der abgelaufenen Timer.
+ */
+int handle_timeouts(struct timer_wheel* timers, struct window* window, int ticks)
+{
+    int expired = 0;
+
+    timer_wheel_advance(timers);
+
+    int timeout_package_id;
+    while((timeout_package_id = timer_wheel_expire(timers)) > 0)
+    {
+        print_timestamp();
+        printf(RED "Paket %d TIMEOUT\n" RESET, timeout_package_id);
+        window_set(window, timeout_package_id, WINDOW_TIMEOUT);
+        expired += 1;
+    }
+
+    if(expired == 0 && ticks > 0)
+    {
+        print_timestamp();
+        printf(RED "Kein TIMEOUT\n" RESET);
+    }
+
+    return expired;
+}
+
+
+/**
+ * Funktion: repair_queue_init / repair_queue_free
+ * -----------------------------------------------
+ * Legt die Liste der ausstehenden Wiederholungen mit Platz für jedes Paket des Fensters an 
+ * bzw. gibt sie frei. Ein mehrfacher Aufruf von `repair_queue_free` ist unschädlich.
+ *
+ * Parameter:
+ * - queue: Die Liste.
+ * - capacity: Kapazität des Fensters.
+ *
+ * Rückgabewert (repair_queue_init):
+ * - 0 bei Erfolg, -1 wenn kein Speicher reserviert werden konnte.
+ */
+int repair_queue_init(struct repair_queue* queue, int capacity)
+{
+    queue->ids = malloc(capacity * sizeof(int));
+    queue->count = 0;
+    queue->capacity = capacity;
+    queue->due = 0;
+
+    if(queue->ids == NULL)
+    {
+        print_timestamp();
+        printf(RED "Speicher für die Wiederholungen konnte nicht reserviert werden\n" RESET);
+        return -1;
+    }
+
+    return 0;
+}
+
+void repair_queue_free(struct repair_queue* queue)
+{
+    free(queue->ids);
+    queue->ids = NULL;
+    queue->count = 0;
+    queue->due = 0;
+}
+
+
+/**
+ * Funktion: repair_queue_wait_ms
+ * ------------------------------
+ * Begrenzt eine Wartezeit auf die Zeit bis zum Senden der gesammelten Wiederholungen.
+ *
+ * Parameter:
+ * - queue: Die Liste der ausstehenden Wiederholungen.
+ * - wait_ms: Bisherige Wartezeit in Millisekunden, -1 für unbegrenzt.
+ *
+ * Rückgabewert:
+ * - Die kürzere der beiden Wartezeiten in Millisekunden.
+ */
+int repair_queue_wait_ms(struct repair_queue* queue, int wait_ms)
+{
+    if(queue->due == 0)
+    {
+        return wait_ms;
+    }
+
+    long long due_us = queue->due - get_time_us();
+    int due_ms = due_us > 0 ? (int)((due_us + 999) / 1000) : 0;
+
+    return (wait_ms < 0 || due_ms < wait_ms) ? due_ms : wait_ms;
+}
+
+
+/**
+ * Funktion: request_repair
+ * ------------------------
+ * Merkt ein per NACK angefordertes Paket für die nächste Wiederholung vor. NACKs werden 
+ * DEFAULT_REPAIR_HOLDOFF ms lang gesammelt, damit ein Paket, das mehreren Empfängern fehlt, 
+ * nur einmal wiederholt wird. Der Timer des Pakets wird sofort neu gestartet, damit das 
+ * Fenster in der Zwischenzeit nicht über das Paket hinweg geschoben wird.
+ * Mit --suppress werden weitere NACKs für dasselbe Paket innerhalb der längsten Wartezeit 
+ * der Clients nach einer Wiederholung nicht erneut beantwortet.
+ *
+ * Parameter:
+ * - props: Pointer auf die `properties`-Struktur.
+ * - com: Pointer auf die `communication`-Struktur mit dem NACK in `ans` und dem Absender in `member`.
+ * - window: Sendefenster.
+ * - timers: Timer-Rad der Pakete.
+ * - queue: Liste der ausstehenden Wiederholungen.
+ * - package_id: Die ID des angeforderten Pakets.
+ * - base: Basis-ID des Fensters.
+ * - current: ID des nächsten noch nie gesendeten Pakets.
+ */
+void request_repair(struct properties* props, struct communication* com, struct window* window, struct timer_wheel* timers, struct repair_queue* queue, int package_id, int base, int current)
+{
+    // NACK außerhalb des Fensters
+    if(package_id < base)
+    {
+        print_timestamp();
+        printf(RED "NACK von Empänger mit ID %d für Paket %d, außerhalb des Sendefensters!\n" RESET, com->ans.senderId, package_id);
+        return;
+    }
+
+    if(package_id >= current)
+    {
+        print_timestamp();
+        printf(RED "NACK von Empänger mit ID %d für Paket %d, wurde noch nicht gesendet!\n" RESET, com->ans.senderId, package_id);
+        return;
+    }
+
+    struct window_slot* slot = window_get_slot(window, package_id);
+    if(slot->type == REQ_CLOSE)
+    {
+        print_timestamp();
+        printf(RED "NACK für CLOSE wird ignoriert!\n" RESET);
+        return;
+    }
+
+    if(props->group_size > 0 && slot->repaired > 0 && get_time_us() - slot->repaired < nack_backoff_max_ms(props->group_size) * 1000LL)
+    {
+        print_timestamp();
+        printf(RED "NACK von Empänger mit ID %d für Paket %d, Wiederholung läuft bereits!\n" RESET, com->ans.senderId, package_id);
+        return;
+    }
+
+    print_timestamp();
+    printf(RED "NACK von Empänger mit ID %d für Paket %d erhalten\n" RESET, com->ans.senderId, package_id);
+
+    // Anfordernden Empfänger merken, weitere NACKs desselben Empfängers zählen nicht doppelt
+    int member = com->member;
+
+    if(slot->repair_count == 0 && queue->count < queue->capacity)
+    {
+        slot->repair_member = member;
+        slot->repair_count = 1;
+        queue->ids[queue->count] = package_id;
+        queue->count += 1;
+    }
+    else if(slot->repair_count > 1 || slot->repair_member != member)
+    {
+        slot->repair_count += 1;
+    }
+
+    if(queue->due == 0)
+    {
+        queue->due = get_time_us() + DEFAULT_REPAIR_HOLDOFF * 1000LL;
+    }
+
+    // Timer neu setzen
+    timer_wheel_add(timers, package_id, release_timeout_ms(props));
+    window_unset(window, package_id, WINDOW_TIMEOUT);
+}
+
+
+/**
+ * Funktion: flush_repairs
+ * -----------------------
+ * Sendet alle gesammelten Wiederholungen. Ein Paket, das mehrere Empfänger angefordert 
+ * haben, wird einmal per Multicast gesendet, ein einzelner Verlust per Unicast an den 
+ * Empfänger. Lokal und mit --suppress wird immer per Multicast gesendet.
+ *
+ * Parameter:
+ * - props: Pointer auf die `properties`-Struktur.
+ * - com: Pointer auf die `communication`-Struktur, `req` und `partner` werden überschrieben.
+ * - window: Sendefenster.
+ * - pacer: Senderate, Wiederholungen werden immer gesendet, aber angerechnet.
+ * - queue: Liste der ausstehenden Wiederholungen, wird geleert.
+ * - list: Mitgliederliste mit den Adressen der Empfänger.
+ * - base: Basis-ID des Fensters.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg, -1 bei einem Fehler beim Senden.
+ */
+int flush_repairs(struct properties* props, struct communication* com, struct window* window, struct pacer* pacer, struct repair_queue* queue, struct memberlist* list, int base)
+{
+    int result = 0;
+
+    for(int i = 0; i < queue->count; i++)
+    {
+        int package_id = queue->ids[i];
+        struct window_slot* slot = window_get_slot(window, package_id);
+        if(package_id < base || slot->packageId != package_id || slot->repair_count == 0)
+        {
+            continue;
+        }
+
+        // Ein einzelner Verlust geht nur an seinen Empfänger, lokal trotzdem per Multicast
+        bool single = props->group_size == 0 && slot->repair_count == 1 && slot->repair_member >= 0 && slot->repair_member < list->number_members;
+        bool unicast = single && !props->local;
+        int receivers = slot->repair_count;
+        slot->repair_count = 0;
+        slot->repaired = get_time_us();
+
+        // Wiederholungen werden immer gesendet, verbrauchen aber Senderate
+        pacer_charge(pacer, window_get_wire_size(window, package_id));
+
+        com->packet = window_load(window, package_id, &com->req);
+        com->payload = window_get_payload(window, package_id);
+        com->req.reciverId = single ? list->member[slot->repair_member].member_id : -1;
+
+        if(unicast)
+        {
+            com->partner = list->member[slot->repair_member].member;
+        }
+        else if(!single)
+        {
+            print_timestamp();
+            printf(GREEN "Paket %d wird für %d NACKs einmal per Multicast wiederholt\n" RESET, package_id, receivers);
+        }
+
+        if(send_data_package(props, com, unicast) < 0)
+        {
+            result = -1;
+        }
+    }
+
+    queue->count = 0;
+    queue->due = 0;
+
+    return result;
+}
+
+
+/**
+ * Funktion: catchup_queue_free
+ * ----------------------------
+ * Gibt die Liste der aufholenden Mitglieder frei.
+ *
+ * Parameter:
+ * - queue: Die Liste.
+ */
+void catchup_queue_free(struct catchup_queue* queue)
+{
+    free(queue->entries);
+    queue->entries = NULL;
+    queue->count = 0;
+    queue->capacity = 0;
+    queue->turn = 0;
+}
+
+
+/**
+ * Funktion: catchup_remove
+ * ------------------------
+ * Entfernt einen Eintrag aus der Liste der aufholenden Mitglieder.
+ *
+ * Parameter:
+ * - queue: Die Liste.
+ * - index: Index des Eintrags.
+ */
+void catchup_remove(struct catchup_queue* queue, int index)
+{
+    queue->count -= 1;
+    queue->entries[index] = queue->entries[queue->count];
+
+    if(queue->turn >= queue->count)
+    {
+        queue->turn = 0;
+    }
+}
+
+
+/**
+ * Funktion: catchup_find
+ * ----------------------
+ * Sucht den Eintrag eines Mitglieds. Es holen nur wenige Mitglieder gleichzeitig auf, 
+ * die Liste wird deshalb durchsucht.
+ *
+ * Parameter:
+ * - queue: Die Liste.
+ * - member: Index des Mitglieds in der Mitgliederliste.
+ *
+ * Rückgabewert:
+ * - Index des Eintrags, -1 wenn das Mitglied nicht aufholt.
+ */
+int catchup_find(struct catchup_queue* queue, int member)
+{
+    for(int i = 0; i < queue->count; i++)
+    {
+        if(queue->entries[i].member == member)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+
+/**
+ * Funktion: handle_join
+ * ---------------------
+ * Behandelt ein HELLO während der Übertragung. Bittet ein Client mit Paket-ID 0 um Beitritt, 
+ * erhält er per Unicast ein HELLO mit dem nächsten neuen Paket als Beitrittspunkt. Bestätigt 
+ * er diesen, wird er Mitglied und holt alle Segmente davor per Unicast auf. Bis dahin speichert 
+ * der Server nichts, ein verlorenes HELLO wiederholt der Client. Ein Mitglied, das neu gestartet 
+ * wurde (z. B. mit einem Prüfpunkt), tritt so mit einem neuen Beitrittspunkt erneut bei.
+ *
+ * Parameter:
+ * - props: Eigenschaften des Servers.
+ * - com: Kommunikationsstruktur mit dem HELLO in `ans`, `req` wird überschrieben.
+ * - list: Die Mitgliederliste.
+ * - queue: Liste der aufholenden Mitglieder.
+ * - base: Basis-ID des Fensters.
+ * - current: ID des nächsten noch nie gesendeten Pakets.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg oder wenn das HELLO ignoriert wird.
+ * - -1 bei einem Fehler beim Senden oder ohne Speicher.
+ */
+int handle_join(struct properties* props, struct communication* com, struct memberlist* list, struct catchup_queue* queue, int base, int current)
+{
+    if(com->ans.type != ANS_HELLO)
+    {
+        return 0;
+    }
+
+    // Wiederholte Bestätigung eines Beitrittspunkts
+    int join = com->ans.packageId;
+    if(com->member >= 0 && join > 0 && join <= list->member[com->member].join)
+    {
+        return 0;
+    }
+
+    // Clients im Textmodus schreiben Zeilen der Reihe nach und können nicht nachträglich aufholen
+    if(!props->binary || props->file_size < 0)
+    {
+        print_timestamp();
+        printf(RED "Später Beitritt von Id %d nur im Binärmodus möglich\n" RESET, com->ans.senderId);
+        return 0;
+    }
+
+    // Beitrittspunkt anbieten bzw. erneut anbieten, wenn der bestätigte nicht mehr gesendet wird
+    if(join < 1 || join > current)
+    {
+        // Lokal teilen sich alle Clients einen Port, die Empfänger-ID wählt den Client aus
+        prepare_hello_package(props, com);
+        com->req.packageId = current;
+        com->req.reciverId = com->ans.senderId;
+        if((props->local ? send_multicast(props, com) : send_unicast(props, com)) < 0)
+        {
+            return -1;
+        }
+
+        print_timestamp();
+        printf(GREEN "Id %d kann bei Paket %d beitreten\n" RESET, com->ans.senderId, current);
+        return 0;
+    }
+
+    int index = com->member >= 0 ? catchup_find(queue, com->member) : -1;
+    if(index < 0 && queue->count == queue->capacity)
+    {
+        int capacity = queue->capacity > 0 ? queue->capacity * 2 : 4;
+        struct catchup* entries = realloc(queue->entries, capacity * sizeof(struct catchup));
+        if(entries == NULL)
+        {
+            print_timestamp();
+            printf(RED "Speicher für das Aufholen konnte nicht reserviert werden\n" RESET);
+            return -1;
+        }
+        queue->entries = entries;
+        queue->capacity = capacity;
+    }
+
+    if(com->member < 0)
+    {
+        com->member = member_add(list, com->ans.senderId, &com->partner);
+        if(com->member < 0)
+        {
+            return -1;
+        }
+    }
+
+    // Pakete vor der Fensterbasis kann der Client nicht mehr per NACK anfordern, sie kommen mit dem Aufholen
+    struct member* member = &list->member[com->member];
+    member->join = join;
+    member_set_acked(list, com->member, join > base ? join : base);
+    member_update_feedback(props, list, com->member, &com->ans);
+
+    if(index < 0)
+    {
+        index = queue->count;
+        queue->count += 1;
+    }
+
+    struct catchup* entry = &queue->entries[index];
+    entry->member = com->member;
+    entry->next = 1;
+    entry->end = member->acked;
+    entry->sweep = true;
+    entry->report.packageId = 0;
+    entry->report.lossLen = 0;
+    entry->finished = 0;
+    entry->heard = get_time_us();
+
+    print_timestamp();
+    printf(GREEN "Mitglied mit ID:%i ab Paket %d registriert, holt %d Segmente auf\n" RESET, member->member_id, join, entry->end - 1);
+    return 0;
+}
+
+
+/**
+ * Funktion: catchup_skip
+ * ----------------------
+ * Sucht ab `package_id` das erste Segment, das dem Client laut seiner letzten Meldung noch 
+ * fehlen kann. Alles vor dem gemeldeten ersten fehlenden Segment hat er schon, ebenso alle 
+ * nicht markierten Segmente im Bereich der Bitmap. Passen nicht alle fehlenden Segmente in 
+ * die Bitmap, füllt der Client sie auf volle Länge auf (`prepare_catchup_package`), hinter 
+ * ihr ist dann alles unbekannt und wird gesendet. Nur eine kürzere Bitmap führt alle 
+ * fehlenden Segmente bis zum Ende auf. Ein Client, der mit einem Prüfpunkt neu gestartet 
+ * wurde, erhält so beim ersten Durchlauf nur die Segmente, die ihm wirklich fehlen.
+ */
+static int catchup_skip(const struct catchup* entry, int package_id)
+{
+    const struct answer* report = &entry->report;
+    if(package_id <= report->packageId)
+    {
+        return report->packageId;
+    }
+
+    int loss = nack_next_loss(report, package_id - 1);
+    if(loss >= 0)
+    {
+        return loss;
+    }
+
+    if(report->lossLen < NACK_BITMAP_SIZE)
+    {
+        return entry->end;
+    }
+
+    int covered = report->packageId + 8 * report->lossLen;
+    return package_id > covered ? package_id : covered + 1;
+}
+
+
+/**
+ * Funktion: handle_catchup_report
+ * -------------------------------
+ * Übernimmt eine CATCHUP-Meldung. Der erste Durchlauf beginnt erst mit der ersten Meldung und 
+ * überspringt jeweils die Segmente, die der Client laut seiner neuesten Meldung schon hat. Ist 
+ * ein Durchlauf beendet und die Meldung mindestens ein RTO jünger als sein Ende, beginnt ein 
+ * neuer Durchlauf mit den gemeldeten Segmenten. So werden Segmente, die noch unterwegs waren, 
+ * nicht doppelt gesendet. Ein CLOSE oder eine Meldung ohne fehlende Segmente beendet das Aufholen.
+ *
+ * Parameter:
+ * - props: Eigenschaften des Servers mit dem RTO.
+ * - queue: Liste der aufholenden Mitglieder.
+ * - com: Kommunikationsstruktur mit der Antwort und dem Absender.
+ */
+void handle_catchup_report(struct properties* props, struct catchup_queue* queue, struct communication* com)
+{
+    if(com->ans.type != ANS_CATCHUP && com->ans.type != ANS_CLOSE)
+    {
+        return;
+    }
+
+    int index = com->member >= 0 ? catchup_find(queue, com->member) : -1;
+    if(index < 0)
+    {
+        return;
+    }
+
+    struct catchup* entry = &queue->entries[index];
+    if(com->ans.type == ANS_CLOSE || com->ans.packageId >= entry->end)
+    {
+        print_timestamp();
+        printf(GREEN "Id %d hat aufgeholt\n" RESET, com->ans.senderId);
+        catchup_remove(queue, index);
+        return;
+    }
+
+    long long now = get_time_us();
+    entry->heard = now;
+
+    if(entry->sweep && entry->next > 0 && com->ans.packageId > 0)
+    {
+        entry->report = com->ans;
+        int next = catchup_skip(entry, entry->next);
+        entry->next = next < entry->end ? next : -1;
+        if(entry->next < 0)
+        {
+            entry->finished = now;
+        }
+    }
+    else if(entry->next < 0 && com->ans.packageId > 0 && now - entry->finished >= props->rto * 1000LL)
+    {
+        entry->sweep = false;
+        entry->report = com->ans;
+        entry->next = com->ans.packageId;
+    }
+}
+
+
+/**
+ * Funktion: catchup_ready
+ * -----------------------
+ * Prüft, ob für einen Eintrag gerade ein Segment zu senden ist. Der erste Durchlauf wartet 
+ * auf die erste Meldung des Clients.
+ */
+static bool catchup_ready(const struct catchup* entry)
+{
+    return entry->next > 0 && entry->report.packageId > 0;
+}
+
+
+/**
+ * Funktion: catchup_advance
+ * -------------------------
+ * Bestimmt das nächste Segment eines Durchlaufs nach `package_id`.
+ */
+static void catchup_advance(struct catchup* entry, int package_id)
+{
+    if(entry->sweep)
+    {
+        int next = catchup_skip(entry, package_id + 1);
+        entry->next = next < entry->end ? next : -1;
+    }
+    else
+    {
+        entry->next = nack_next_loss(&entry->report, package_id);
+    }
+
+    if(entry->next < 0)
+    {
+        entry->finished = get_time_us();
+    }
+}
+
+
+/**
+ * Funktion: send_catchup
+ * ----------------------
+ * Sendet den aufholenden Mitgliedern reihum Segmente per Unicast (lokal per Multicast an 
+ * ihre Empfänger-ID), solange die Senderate zum Aufholen es erlaubt. Die Segmente werden 
+ * direkt aus der Datei gelesen und auch auf die Senderate der Übertragung angerechnet. 
+ * Mitglieder, die länger als DEFAULT_CATCHUP_TIMEOUT ms nichts gemeldet haben, werden 
+ * aus der Liste entfernt.
+ *
+ * Parameter:
+ * - props: Eigenschaften des Servers mit Datei und Segmentgröße.
+ * - com: Kommunikationsstruktur, `req`, `partner` und Nutzdaten werden überschrieben.
+ * - list: Die Mitgliederliste mit den Adressen.
+ * - queue: Liste der aufholenden Mitglieder.
+ * - catchup: Token-Bucket der Senderate zum Aufholen.
+ * - pacer: Token-Bucket der Übertragung, wird belastet.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg, -1 bei einem Fehler beim Lesen oder Senden.
+ */
+int send_catchup(struct properties* props, struct communication* com, struct memberlist* list, struct catchup_queue* queue, struct pacer* catchup, struct pacer* pacer)
+{
+    long long now = get_time_us();
+    for(int i = 0; i < queue->count; i++)
+    {
+        if(now - queue->entries[i].heard > DEFAULT_CATCHUP_TIMEOUT * 1000LL)
+        {
+            print_timestamp();
+            printf(RED "Aufholen von Id %d abgebrochen, keine Meldung\n" RESET, list->member[queue->entries[i].member].member_id);
+            catchup_remove(queue, i);
+            i -= 1;
+        }
+    }
+
+    int idle = 0;
+    while(queue->count > 0 && idle < queue->count)
+    {
+        struct catchup* entry = &queue->entries[queue->turn];
+        queue->turn = (queue->turn + 1) % queue->count;
+
+        if(!catchup_ready(entry))
+        {
+            idle += 1;
+            continue;
+        }
+
+        long long offset = segment_offset(props, entry->next);
+        int length = props->file_size - offset < props->segment_size ? (int)(props->file_size - offset) : props->segment_size;
+        if(length <= 0)
+        {
+            catchup_advance(entry, entry->next);
+            continue;
+        }
+
+        int size = WIRE_REQUEST_HEADER_SIZE + length;
+        if(!pacer_consume(catchup, size))
+        {
+            break; // Warten bis genug Tokens vorhanden sind
+        }
+        pacer_charge(pacer, size);
+
+        // Segment aus der eingeblendeten Datei bzw. ohne die Leseposition zu verändern lesen
+        com->packet = PACKET_NONE;
+        if(props->use_mmap)
+        {
+            com->payload = props->map + offset;
+        }
+        else
+        {
+            com->payload = NULL;
+            if(pread(fileno(props->file), com->req.data, length, (off_t)offset) != length)
+            {
+                print_timestamp();
+                printf(RED "Segment %d konnte nicht gelesen werden\n" RESET, entry->next);
+                return -1;
+            }
+        }
+
+        struct member* member = &list->member[entry->member];
+        prepare_segment_package(props, com, entry->next, length, offset);
+        com->req.reciverId = member->member_id;
+        com->partner = member->member;
+
+        // Lokal per Multicast an die Empfänger-ID, wie bei den Wiederholungen
+        if(send_data_package(props, com, !props->local) < 0)
+        {
+            return -1;
+        }
+
+        catchup_advance(entry, entry->next);
+        idle = 0;
+    }
+
+    return 0;
+}
+
+
+/**
+ * Funktion: catchup_wait_ms
+ * -------------------------
+ * Begrenzt eine Wartezeit auf den nächsten Token zum Aufholen, solange ein Durchlauf läuft, 
+ * und sonst auf DEFAULT_REPORT_INTERVAL, damit abgebrochene Mitglieder entfernt werden.
+ *
+ * Parameter:
+ * - props: Eigenschaften des Servers mit der Segmentgröße.
+ * - queue: Liste der aufholenden Mitglieder.
+ * - catchup: Token-Bucket der Senderate zum Aufholen.
+ * - wait_ms: Bisherige Wartezeit in Millisekunden, -1 für unbegrenzt.
+ *
+ * Rückgabewert:
+ * - Die kürzere der Wartezeiten in Millisekunden.
+ */
+int catchup_wait_ms(struct properties* props, struct catchup_queue* queue, struct pacer* catchup, int wait_ms)
+{
+    if(queue->count == 0)
+    {
+        return wait_ms;
+    }
+
+    int catchup_ms = DEFAULT_REPORT_INTERVAL;
+    for(int i = 0; i < queue->count; i++)
+    {
+        if(catchup_ready(&queue->entries[i]))
+        {
+            catchup_ms = pacer_wait_ms(catchup, WIRE_REQUEST_HEADER_SIZE + props->segment_size);
+            break;
+        }
+    }
+
+    return (wait_ms < 0 || catchup_ms < wait_ms) ? catchup_ms : wait_ms;
+}
+
+
+#ifdef __linux__
+/**
+ * Funktion: reader_read_batch
+ * ---------------------------
+ * Liest mit --uring in den Puffer `first` und alle weiteren freien Puffer (bis zu 
+ * MAX_BATCH_SIZE) die nächsten Segmente mit einem `io_uring_enter` und legt sie in ihrer 
+ * Reihenfolge in den Ring `filled`.
+ *
+ * Parameter:
+ * - p: Die Pipeline mit dem Ring des Lese-Threads.
+ * - first: Der schon aus `free` genommene Puffer.
+ *
+ * Rückgabewert:
+ * - 0 wenn weitere Segmente folgen.
+ * - -1 am Dateiende oder bei einem Lesefehler, der Eintrag mit Länge -1 liegt dann in `filled`.
+ *
+ * Beschreibung:
+ * - Die Positionen der Segmente stehen vorher fest (`read_offset`, mit --stripes im Abstand 
+ *   der Streifen), die Reihenfolge der Abschlüsse spielt daher keine Rolle.
+ * - Mit registriertem Pool liest der Kernel direkt in die festen Puffer (READ_FIXED).
+ * - Ein kurzer Lesezugriff wird mit `pread` vervollständigt, ebenso Segmente, die wegen 
+ *   eines Fehlers des Rings nicht übergeben wurden.
+ * - Puffer hinter dem Dateiende bleiben unbenutzt und werden mit dem Paketpool freigegeben.
+ */
+static int reader_read_batch(struct pipeline* p, int first)
+{
+    struct properties* props = p->props;
+    struct prefetch entries[MAX_BATCH_SIZE];
+    int results[MAX_BATCH_SIZE];
+    long long stride = (long long)props->segment_size * props->stripes;
+    int count = 0;
+    int packet = first;
+    do
+    {
+        entries[count].packet = packet;
+        entries[count].data = packet_payload(&p->window->pool, packet);
+        entries[count].offset = p->read_offset + count * stride;
+        count += 1;
+    } while(count < MAX_BATCH_SIZE && spsc_ring_pop(&p->free, &packet));
+    p->read_offset += count * stride;
+
+    int queued = 0;
+    for(int i = 0; i < count; i++)
+    {
+        results[i] = 0;
+        struct io_uring_sqe* sqe = uring_get_sqe(&p->reader_ring);
+        if(sqe == NULL)
+        {
+            continue;
+        }
+
+        sqe->opcode = p->reader_fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+        sqe->fd = 0; // Feste Datei 0, die Quelldatei
+        sqe->flags = IOSQE_FIXED_FILE;
+        sqe->addr = (unsigned long long)(uintptr_t)entries[i].data;
+        sqe->len = (unsigned int)props->segment_size;
+        sqe->off = (unsigned long long)entries[i].offset;
+        sqe->buf_index = 0;
+        sqe->user_data = (unsigned long long)i;
+        queued += 1;
+    }
+
+    // Alle Segmente übergeben und auf ihre Abschlüsse warten
+    int done = 0;
+    while(done < queued)
+    {
+        if(uring_submit(&p->reader_ring, (unsigned int)(queued - done)) < 0)
+        {
+            // Ohne Ring weiter mit fread ab der nächsten Position
+            print_timestamp();
+            printf(RED "Fehler bei io_uring_enter, der Lese-Thread liest ohne io_uring weiter\n" RESET);
+            perror("\t\t");
+            uring_free(&p->reader_ring);
+            fseeko(props->file, (off_t)p->read_offset, SEEK_SET);
+            break;
+        }
+
+        struct io_uring_cqe* cqe;
+        while((cqe = uring_peek(&p->reader_ring)) != NULL)
+        {
+            results[cqe->user_data] = cqe->res;
+            uring_seen(&p->reader_ring);
+            done += 1;
+        }
+    }
+
+    int fd = fileno(props->file);
+    for(int i = 0; i < count; i++)
+    {
+        int length = results[i];
+        if(length >= 0 && length < props->segment_size)
+        {
+            // Rest eines kurzen Lesezugriffs, ein nicht übergebenes Segment beginnt bei 0
+            ssize_t rest = pread(fd, entries[i].data + length, (size_t)(props->segment_size - length), (off_t)(entries[i].offset + length));
+            length = rest < 0 ? -errno : length + (int)rest;
+        }
+
+        if(length < 0)
+        {
+            errno = -length;
+            print_timestamp();
+            printf(RED "Lesen des Segments an Position %lld fehlgeschlagen\n" RESET, entries[i].offset);
+            perror("\t\t");
+        }
+
+        // Dateiende wie bei `get_file_segment`
+        entries[i].length = length > 0 ? length : -1;
+        spsc_ring_push(&p->filled, &entries[i]);
+        if(entries[i].length < 0)
+        {
+            wakeup_signal(&p->sender_wake);
+            return -1;
+        }
+    }
+
+    wakeup_signal(&p->sender_wake);
+    return 0;
+}
+#endif
+
+
+/**
+ * Funktion: run_reader
+ * --------------------
+ * Lese-Thread einer Sitzung mit --pipeline. Für jeden freien Puffer aus dem Ring `free` wird 
+ * das nächste Segment bzw. die nächste Zeile direkt in den Puffer gelesen und als Handle über 
+ * den Ring `filled` an den Sendethread gegeben. Mit --mmap gibt es keine Puffer, der Thread 
+ * lädt dann die Seiten der Einblendung voraus. Am Dateiende endet der Thread.
+ *
+ * Parameter:
+ * - arg: Pointer auf die `pipeline`-Struktur der Sitzung.
+ *
+ * Rückgabewert:
+ * - NULL.
+ *
+ * Beschreibung:
+ * - Datei bzw. Einblendung gehören während der Laufzeit allein diesem Thread. Das Aufholen 
+ *   später Beitritte liest mit pread und verändert die Leseposition nicht.
+ * - Es sind nie mehr als PIPELINE_PREFETCH Puffer unterwegs, `filled` kann daher nicht 
+ *   überlaufen.
+ * - Mit --uring im Binärmodus liest `reader_read_batch` alle freien Puffer auf einmal, die 
+ *   Leseposition der Datei wird erst am Ende nachgezogen.
+ */
+static void* run_reader(void* arg)
+{
+    struct pipeline* p = (struct pipeline*)arg;
+    struct properties* props = p->props;
+    long page_size = sysconf(_SC_PAGESIZE);
+
+    while(!atomic_load(&p->reader_stop))
+    {
+        int packet;
+        if(!spsc_ring_pop(&p->free, &packet))
+        {
+            // Auf freie Puffer warten, nach der Ankündigung wird der Ring noch einmal geprüft
+            wakeup_arm(&p->reader_wake);
+            if(spsc_ring_empty(&p->free) && !atomic_load(&p->reader_stop))
+            {
+                struct pollfd pfd;
+                pfd.fd = p->reader_wake.read_fd;
+                pfd.events = POLLIN;
+                pfd.revents = 0;
+                poll(&pfd, 1, -1);
+            }
+            wakeup_drain(&p->reader_wake);
+            continue;
+        }
+
+        struct prefetch entry;
+        entry.packet = packet;
+        if(props->use_mmap)
+        {
+            entry.offset = props->map_pos;
+            entry.length = props->binary ? get_mapped_segment(props, &entry.data) : get_mapped_line(props, &entry.data);
+
+            // Seiten hier laden, damit der Sendethread keinen Seitenfehler abwarten muss
+            for(long i = 0; i < entry.length; i += page_size)
+            {
+                volatile char touch = entry.data[i];
+                (void)touch;
+            }
+        }
+#ifdef __linux__
+        else if(p->reader_ring.fd >= 0)
+        {
+            if(reader_read_batch(p, packet) < 0)
+            {
+                break; // Dateiende
+            }
+            continue;
+        }
+#endif
+        else
+        {
+            entry.data = packet_payload(&p->window->pool, packet);
+            entry.offset = ftello(props->file);
+            entry.length = props->binary ? get_file_segment(props, entry.data) : get_file_line(props, entry.data);
+        }
+
+        spsc_ring_push(&p->filled, &entry);
+        wakeup_signal(&p->sender_wake);
+
+        if(entry.length < 0)
+        {
+            break; // Dateiende
+        }
+    }
+
+    // Leseposition für die nächste Runde bzw. den Sendethread nachziehen
+    if(p->reader_ring.fd >= 0)
+    {
+        fseeko(props->file, (off_t)p->read_offset, SEEK_SET);
+    }
+
+    return NULL;
+}
+
+
+/**
+ * Funktion: run_receiver
+ * ----------------------
+ * Empfangs-Thread einer Sitzung mit --pipeline. Liest die Antworten der Clients mit eigenen 
+ * Empfangspuffern, dekodiert sie und legt sie in den Ring `answers` für den Sendethread.
+ *
+ * Parameter:
+ * - arg: Pointer auf die `pipeline`-Struktur der Sitzung.
+ *
+ * Rückgabewert:
+ * - NULL.
+ *
+ * Beschreibung:
+ * - Ist der Ring voll, wird die Antwort verworfen wie bei einem vollen Empfangspuffer des 
+ *   Sockets. Verlorene Rückmeldungen fängt das Protokoll ohnehin ab.
+ * - Ausgewertet werden die Antworten im Sendethread, da sie Fenster, Timer und 
+ *   Mitgliederliste verändern.
+ */
+static void* run_receiver(void* arg)
+{
+    struct pipeline* p = (struct pipeline*)arg;
+    struct communication com;
+
+    struct pollfd fds[2];
+    fds[0].fd = transport_fd(&p->receive_props);
+    fds[0].events = POLLIN;
+    fds[1].fd = p->receiver_wake.read_fd;
+    fds[1].events = POLLIN;
+
+    while(!atomic_load(&p->receiver_stop))
+    {
+        // Socket leeren, danach den Sendethread einmal wecken
+        int result;
+        int received = 0;
+        while((result = receive_cast(&p->receive_props, &com, NULL)) > 0)
+        {
+            struct feedback entry;
+            entry.ans = com.ans;
+            entry.partner = com.partner;
+            if(!spsc_ring_push(&p->answers, &entry))
+            {
+                p->dropped += 1;
+                continue;
+            }
+            received += 1;
+        }
+
+        if(received > 0)
+        {
+            wakeup_signal(&p->sender_wake);
+        }
+
+        fds[0].revents = 0;
+        fds[1].revents = 0;
+        if(result < 0 || (poll(fds, 2, -1) < 0 && errno != EINTR))
+        {
+            print_timestamp();
+            printf(RED "Empfangs-Thread wird beendet\n" RESET);
+            atomic_store(&p->receiver_failed, true);
+            wakeup_notify(&p->sender_wake);
+            break;
+        }
+
+        wakeup_drain(&p->receiver_wake);
+    }
+
+    return NULL;
+}
+
+
+/**
+ * Funktion: pipeline_start_reader
+ * -------------------------------
+ * Startet den Lese-Thread für eine neue Runde der Übertragung. Datei und Fenster müssen 
+ * bereits zurückgesetzt sein.
+ *
+ * Parameter:
+ * - p: Die Pipeline der Sitzung.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 wenn der Thread nicht gestartet werden konnte.
+ */
+int pipeline_start_reader(struct pipeline* p)
+{
+    spsc_ring_reset(&p->free);
+    spsc_ring_reset(&p->filled);
+    p->outstanding = 0;
+    p->eof = false;
+    atomic_store(&p->reader_stop, false);
+
+#ifdef __linux__
+    if(p->reader_ring.fd >= 0)
+    {
+        // Das Fenster ist neu angelegt, der Pool wird neu registriert
+        if(p->reader_fixed)
+        {
+            uring_register(&p->reader_ring, IORING_UNREGISTER_BUFFERS, NULL, 0);
+        }
+
+        struct iovec iov;
+        iov.iov_base = p->window->pool.memory;
+        iov.iov_len = (size_t)p->window->pool.count * (size_t)p->window->pool.buffer_size;
+        p->reader_fixed = uring_register(&p->reader_ring, IORING_REGISTER_BUFFERS, &iov, 1) == 0;
+        if(!p->reader_fixed)
+        {
+            print_timestamp();
+            printf(RED "Paketpool konnte nicht beim Ring registriert werden\n" RESET);
+            perror("\t\t");
+        }
+
+        p->read_offset = (long long)ftello(p->props->file);
+    }
+#endif
+
+    if(pthread_create(&p->reader, NULL, run_reader, p) != 0)
+    {
+        print_timestamp();
+        printf(RED "Lese-Thread konnte nicht gestartet werden\n" RESET);
+        return -1;
+    }
+
+    p->reader_started = true;
+    return 0;
+}
+
+
+/**
+ * Funktion: pipeline_stop_reader
+ * ------------------------------
+ * Beendet den Lese-Thread und wartet auf ihn. Danach gehören Datei und Paketpool wieder 
+ * allein dem Sendethread. Puffer in den Ringen werden mit dem Paketpool freigegeben.
+ *
+ * Parameter:
+ * - p: Die Pipeline der Sitzung.
+ */
+void pipeline_stop_reader(struct pipeline* p)
+{
+    if(!p->reader_started)
+    {
+        return;
+    }
+
+    atomic_store(&p->reader_stop, true);
+    wakeup_notify(&p->reader_wake);
+    pthread_join(p->reader, NULL);
+    wakeup_drain(&p->reader_wake);
+    p->reader_started = false;
+}
+
+
+/**
+ * Funktion: pipeline_refill
+ * -------------------------
+ * Gibt dem Lese-Thread freie Puffer aus dem Paketpool, bis PIPELINE_PREFETCH Pakete 
+ * vorausgelesen werden bzw. sind. Mit --mmap werden nur Handles ohne Puffer vergeben.
+ *
+ * Parameter:
+ * - p: Die Pipeline der Sitzung.
+ */
+static void pipeline_refill(struct pipeline* p)
+{
+    bool refilled = false;
+    while(!p->eof && p->outstanding < PIPELINE_PREFETCH)
+    {
+        int packet = PACKET_NONE;
+        if(!p->props->use_mmap)
+        {
+            packet = packet_alloc(&p->window->pool);
+            if(packet == PACKET_NONE)
+            {
+                break; // Puffer liegen noch in der Sendewarteschlange
+            }
+        }
+
+        spsc_ring_push(&p->free, &packet);
+        p->outstanding += 1;
+        refilled = true;
+    }
+
+    if(refilled)
+    {
+        wakeup_signal(&p->reader_wake);
+    }
+}
+
+
+/**
+ * Funktion: pipeline_uring_init
+ * -----------------------------
+ * Legt für --uring im Binärmodus ohne --mmap den Ring des Lese-Threads an und registriert 
+ * die Quelldatei als feste Datei 0. Ohne io_uring liest der Thread wie bisher mit `fread`.
+ *
+ * Parameter:
+ * - p: Die Pipeline, deren Lese-Thread noch nicht läuft.
+ */
+static void pipeline_uring_init(struct pipeline* p)
+{
+    int fd = fileno(p->props->file);
+    if(uring_init(&p->reader_ring, MAX_BATCH_SIZE) == 0)
+    {
+#ifdef __linux__
+        if(uring_register(&p->reader_ring, IORING_REGISTER_FILES, &fd, 1) == 0)
+        {
+            print_timestamp();
+            printf(GREEN "Lese-Thread liest über io_uring\n" RESET);
+            return;
+        }
+#endif
+        uring_free(&p->reader_ring);
+    }
+
+    print_timestamp();
+    printf(RED "io_uring nicht verfügbar, der Lese-Thread verwendet fread\n" RESET);
+    perror("\t\t");
+}
+
+
+/**
+ * Funktion: pipeline_init
+ * -----------------------
+ * Legt Ringe und Weckmechanismen einer Sitzung mit --pipeline an und startet den 
+ * Empfangs-Thread. Die Ereignisschleife der Sitzung überwacht danach statt des Sockets 
+ * den Weckmechanismus des Sendethreads.
+ *
+ * Parameter:
+ * - s: Die Sitzung, die Pipeline wird in `s->pipeline` gespeichert.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 bei einem Fehler, `pipeline_free` gibt dann bereits Angelegtes frei.
+ */
+int pipeline_init(struct session* s)
+{
+    struct pipeline* p = (struct pipeline*)calloc(1, sizeof(struct pipeline));
+    if(p == NULL)
+    {
+        print_timestamp();
+        printf(RED "Speicher für die Pipeline konnte nicht reserviert werden\n" RESET);
+        return -1;
+    }
+
+    s->pipeline = p;
+    p->props = s->props;
+    p->window = &s->window;
+    p->sender_wake.read_fd = p->sender_wake.write_fd = -1;
+    p->reader_wake.read_fd = p->reader_wake.write_fd = -1;
+    p->receiver_wake.read_fd = p->receiver_wake.write_fd = -1;
+    p->reader_ring.fd = -1;
+
+    if(wakeup_init(&p->sender_wake) < 0 || wakeup_init(&p->reader_wake) < 0 || wakeup_init(&p->receiver_wake) < 0)
+    {
+        return -1;
+    }
+
+    if(spsc_ring_init(&p->free, PIPELINE_PREFETCH, sizeof(int)) < 0 
+        || spsc_ring_init(&p->filled, PIPELINE_PREFETCH, sizeof(struct prefetch)) < 0 
+        || spsc_ring_init(&p->answers, PIPELINE_ANSWERS, sizeof(struct feedback)) < 0)
+    {
+        return -1;
+    }
+
+    // Eigene Empfangspuffer, die Sendepuffer bleiben beim Sendethread
+    p->receive_props = *s->props;
+    p->receive_props.transport = NULL;
+    if(transport_init(&p->receive_props) < 0)
+    {
+        return -1;
+    }
+
+    if(event_loop_watch(&s->loop, p->sender_wake.read_fd) < 0)
+    {
+        return -1;
+    }
+
+    if(pthread_create(&p->receiver, NULL, run_receiver, p) != 0)
+    {
+        print_timestamp();
+        printf(RED "Empfangs-Thread konnte nicht gestartet werden\n" RESET);
+        return -1;
+    }
+    p->receiver_started = true;
+
+    if(s->props->uring && s->props->binary && !s->props->use_mmap)
+    {
+        pipeline_uring_init(p);
+    }
+
+    print_timestamp();
+    printf(GREEN "Lesen, Senden und Empfangen in eigenen Threads\n" RESET);
+
+    return 0;
+}
+
+
+/**
+ * Funktion: pipeline_free
+ * -----------------------
+ * Beendet Lese- und Empfangs-Thread einer Sitzung und gibt die Pipeline frei.
+ *
+ * Parameter:
+ * - s: Die Sitzung.
+ */
+void pipeline_free(struct session* s)
+{
+    struct pipeline* p = s->pipeline;
+    if(p == NULL)
+    {
+        return;
+    }
+
+    pipeline_stop_reader(p);
+
+    if(p->receiver_started)
+    {
+        atomic_store(&p->receiver_stop, true);
+        wakeup_notify(&p->receiver_wake);
+        pthread_join(p->receiver, NULL);
+    }
+
+    if(p->dropped > 0)
+    {
+        print_timestamp();
+        printf(RED "%lld Antworten wegen vollem Ring verworfen\n" RESET, p->dropped);
+    }
+
+    transport_free(&p->receive_props);
+    uring_free(&p->reader_ring);
+
+    spsc_ring_free(&p->free);
+    spsc_ring_free(&p->filled);
+    spsc_ring_free(&p->answers);
+    wakeup_free(&p->sender_wake);
+    wakeup_free(&p->reader_wake);
+    wakeup_free(&p->receiver_wake);
+
+    free(p);
+    s->pipeline = NULL;
+}
+
+
+/**
+ * Funktion: session_receive
+ * -------------------------
+ * Holt die nächste Antwort der Sitzung: ohne --pipeline mit `receive_cast` direkt aus dem 
+ * Socket, sonst aus dem Ring des Empfangs-Threads. Rückgabewerte und Prüfung des Absenders 
+ * entsprechen `receive_cast`.
+ *
+ * Parameter:
+ * - s: Die Sitzung, die Antwort steht danach in `s->com`.
+ * - list: Mitgliederliste zur Prüfung des Absenders, NULL ohne Prüfung.
+ *
+ * Rückgabewert:
+ * - 1: Antwort erhalten.
+ * - 0: Keine Antwort mehr vorhanden.
+ * - -1: Fehler beim Empfang.
+ */
+static int session_receive(struct session* s, struct memberlist* list)
+{
+    struct pipeline* p = s->pipeline;
+    if(p == NULL)
+    {
+        return receive_cast(s->props, &s->com, list);
+    }
+
+    struct communication* com = &s->com;
+    struct feedback entry;
+    while(spsc_ring_pop(&p->answers, &entry))
+    {
+        com->ans = entry.ans;
+        com->partner = entry.partner;
+        com->packet = PACKET_NONE;
+        com->payload = NULL;
+        com->kind = WIRE_KIND_ANSWER;
+
+        // Wie in receive_cast: ein HELLO eines Unbekannten bittet um späten Beitritt
+        com->member = -1;
+        if(list != NULL)
+        {
+            com->member = member_find(list, com->ans.senderId, &com->partner.sin6_addr);
+            if(com->member < 0 && com->ans.type != ANS_HELLO)
+            {
+                print_timestamp();
+                printf("Paket von unbekanntem Sender ignoriert\n");
+                continue;
+            }
+        }
+
+        return 1;
+    }
+
+    return atomic_load(&p->receiver_failed) ? -1 : 0;
+}
+
+
+/**
+ * Funktion: session_init
+ * ----------------------
+ * Legt eine Sitzung im Init-Zustand an. Socket und Datei müssen bereits geöffnet sein.
+ *
+ * Parameter:
+ * - s: Die anzulegende Sitzung.
+ * - props: Pointer auf die `properties`-Struktur der Sitzung.
+ *
+ * Rückgabewert:
+ * - 0 bei Erfolg.
+ * - -1 wenn die Ereignisschleife nicht angelegt werden konnte.
+ *
+ * Beschreibung:
+ * - Nach dem Aufruf darf `session_free` auch im Fehlerfall aufgerufen werden.
+ */
+int session_init(struct session* s, struct properties* props)
+{
+    memset(s, 0, sizeof(*s));
+    s->props = props;
+    s->state = STATE_INIT;     // Initialzustand
+    s->running = true;         // Steuerung der Hauptschleife
+    s->base = 1;
+    s->current = 1;
+
+    srand(time(NULL)); // Zufallsgenerator initialisieren
+
+    if(event_loop_init(&s->loop, props, DEFAULT_SLOT_TIME) < 0 || (props->pipeline && pipeline_init(s) < 0))
+    {
+        s->running = false;
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/**
+ * Funktion: session_free
+ * ----------------------
+ * Gibt die Ressourcen einer Sitzung frei. Socket und Datei werden nicht geschlossen.
+ *
+ * Parameter:
+ * - s: Die Sitzung.
+ */
+void session_free(struct session* s)
+{
+    pipeline_free(s); // Threads greifen auf Datei und Paketpool zu
+    transport_attach_pool(s->props, NULL);
+    window_free(&s->window);
+    memberlist_free(&s->list_members);
+    timer_wheel_free(&s->timers);
+    repair_queue_free(&s->repairs);
+    catchup_queue_free(&s->catchups);
+    fec_free(&s->fec);
+    event_loop_close(&s->loop);
+}
+
+
+/**
+ * Funktion: session_wait_ms
+ * -------------------------
+ * Berechnet, wie lange die Sitzung warten darf, bevor `session_step` wieder aufgerufen 
+ * werden muss, falls bis dahin kein Paket und kein Tick eintrifft.
+ *
+ * Parameter:
+ * - s: Die Sitzung.
+ *
+ * Rückgabewert:
+ * - Die Wartezeit in Millisekunden, 0 für sofort, -1 bis zum nächsten Paket oder Tick.
+ */
+int session_wait_ms(struct session* s)
+{
+    int wait_ms = -1;
+    long long now = get_time_us();
+
+    switch(s->state)
+    {
+        case STATE_INIT:
+            wait_ms = 0;
+            break;
+
+        case STATE_IDLE:
+            wait_ms = (s->idle_until > now) ? (int)((s->idle_until - now + 999) / 1000) : 0;
+            break;
+
+        case STATE_PREPARE:
+            wait_ms = -1; // Bis zum nächsten Zeitschlitz
+            break;
+
+        case STATE_ESTABLISHED:
+            if(s->wake_at > 0)
+            {
+                wait_ms = (s->wake_at > now) ? (int)((s->wake_at - now + 999) / 1000) : 0;
+            }
+            break;
+
+        case STATE_CLOSE:
+            // Spätestens zum Ablauf des nächsten Timers bzw. der Sammelzeit aufwachen
+            wait_ms = timer_wheel_wait_ms(&s->timers, repair_queue_wait_ms(&s->repairs, catchup_wait_ms(s->props, &s->catchups, &s->catchup, -1)));
+            break;
+    }
+
+    // Mit --pipeline nur warten, wenn in den Ringen nichts liegt, was jetzt verarbeitet würde
+    struct pipeline* p = s->pipeline;
+    if(p != NULL && wait_ms != 0)
+    {
+        wakeup_arm(&p->sender_wake);
+        if(!spsc_ring_empty(&p->answers) || atomic_load(&p->receiver_failed) 
+            || (s->state == STATE_ESTABLISHED && s->packages_in_queue < s->props->windows_size && !spsc_ring_empty(&p->filled)))
+        {
+            wait_ms = 0;
+        }
+    }
+
+    return event_loop_wait_ms(&s->loop, wait_ms);
+}
+
+
+/**
+ * Funktion: session_remove_member
+ * -------------------------------
+ * Entfernt ein Mitglied aus der Sitzung. Vorher werden seine ausstehenden Wiederholungen und 
+ * sein Aufholen verworfen und alle Verweise auf das letzte Mitglied auf `index` umgestellt, 
+ * da `member_remove` es auf diesen Index verschiebt.
+ *
+ * Parameter:
+ * - s: Die Sitzung.
+ * - index: Index des Mitglieds in der Mitgliederliste.
+ */
+static void session_remove_member(struct session* s, int index)
+{
+    struct memberlist* list = &s->list_members;
+    if(index < 0 || index >= list->number_members)
+    {
+        return;
+    }
+
+    int last = list->number_members - 1;
+
+    // Aufholen beenden, der Eintrag des letzten Mitglieds folgt ihm auf den neuen Index
+    int entry = catchup_find(&s->catchups, index);
+    if(entry >= 0)
+    {
+        catchup_remove(&s->catchups, entry);
+    }
+    entry = catchup_find(&s->catchups, last);
+    if(entry >= 0)
+    {
+        s->catchups.entries[entry].member = index;
+    }
+
+    // Nur von ihm angeforderte Wiederholungen entfallen, die übrigen gehen per Multicast
+    for(int i = 0; i < s->repairs.count; i++)
+    {
+        struct window_slot* slot = window_get_slot(&s->window, s->repairs.ids[i]);
+        if(slot->packageId != s->repairs.ids[i] || slot->repair_count == 0)
+        {
+            continue;
+        }
+
+        if(slot->repair_member == index)
+        {
+            slot->repair_count -= 1;
+            slot->repair_member = -1;
+        }
+        else if(slot->repair_member == last)
+        {
+            slot->repair_member = index;
+        }
+    }
+
+    if(s->cc.slowest == index)
+    {
+        s->cc.slowest = -1;
+        s->cc.slowest_rate = 0;
+    }
+    else if(s->cc.slowest == last)
+    {
+        s->cc.slowest = index;
+    }
+
+    print_timestamp();
+    printf(BLUE "Mitglied mit ID %d entfernt, %d verbleiben\n" RESET, list->member[index].member_id, list->number_members - 1);
+    member_remove(list, index);
+}
+
+
+/**
+ * Funktion: handle_leave
+ * ----------------------
+ * Entfernt den Absender eines CLOSE. Der Client hat alles erhalten und beendet sich, auf seine 
+ * Bestätigungen muss das Fenster nicht mehr warten.
+ *
+ * Parameter:
+ * - s: Die Sitzung.
+ * - com: Kommunikationsstruktur mit der Antwort, `member` wird danach ungültig (-1).
+ */
+static void handle_leave(struct session* s, struct communication* com)
+{
+    if(com->ans.type != ANS_CLOSE)
+    {
+        return;
+    }
+
+    session_remove_member(s, com->member);
+    com->member = -1;
+}
+
+
+/**
+ * Funktion: evict_silent_members
+ * ------------------------------
+ * Entfernt alle DEFAULT_REPORT_INTERVAL ms die Mitglieder, die unbestätigte Pakete im Fenster 
+ * haben, aber seit DEFAULT_MEMBER_TIMEOUT ms (mindestens vier RTO) nicht geantwortet haben. 
+ * Ein abgestürzter oder verschwundener Client hält so die Freigabe des Fensters nur bis 
+ * dahin auf, danach gibt es wieder die Bestätigungen der übrigen frei.
+ *
+ * Parameter:
+ * - s: Die Sitzung.
+ */
+static void evict_silent_members(struct session* s)
+{
+    long long now = get_time_us();
+    if(now - s->members_checked < DEFAULT_REPORT_INTERVAL * 1000LL)
+    {
+        return;
+    }
+    s->members_checked = now;
+
+    long long timeout = (4 * s->props->rto > DEFAULT_MEMBER_TIMEOUT ? 4 * s->props->rto : DEFAULT_MEMBER_TIMEOUT) * 1000LL;
+    int end = s->base + s->packages_in_queue;
+    for(int i = 0; i < s->list_members.number_members; i++)
+    {
+        struct member* member = &s->list_members.member[i];
+        if(member->acked < end && now - member->heard > timeout)
+        {
+            print_timestamp();
+            printf(RED "Keine Antwort von Id %d seit %lld ms\n" RESET, member->member_id, (now - member->heard) / 1000);
+            session_remove_member(s, i);
+            i -= 1; // Das letzte Mitglied liegt jetzt auf diesem Index
+        }
+    }
+}
+
+
+/**
+ * Funktion: slide_window
+ * ----------------------
+ * Verschiebt das Fenster, bestätigte Pakete sofort, alle anderen nach Ablauf ihres Timers. 
+ * Haben nach dem CLOSE alle Mitglieder die Sitzung verlassen, wartet niemand mehr auf das Fenster.
+ *
+ * Parameter:
+ * - s: Die Sitzung.
+ */
+static void slide_window(struct session* s)
+{
+    bool all_left = s->state == STATE_CLOSE && s->list_members.number_members == 0;
+    while(s->packages_in_queue > 0 && (all_left || member_all_acked(&s->list_members) || window_has(&s->window, s->base, WINDOW_TIMEOUT)))
+    {
+        timer_wheel_del(&s->timers, s->base);
+        window_clear(&s->window, s->base);
+        s->base += 1;
+        member_ack_advance(&s->list_members);
+        s->packages_in_queue -= 1;
+    }
+}
+
+
+/**
+ * Funktion: session_step
+ * ----------------------
+ * Schaltet die Zustandsmaschine des Servers um eine Iteration weiter, beginnend mit dem 
+ * Init-Zustand. Die Zustandsmaschine steuert den Ablauf einer Übertragung durch verschiedene 
+ * Zustände, von der Initialisierung über die Kommunikation bis zur Beendigung.
+ *
+ * Parameter:
+ * - s: Die Sitzung.
+ * - max_wait_ms: Höchstens so lange wird in `event_loop_wait` gewartet, -1 ohne Grenze.
+ *                Ein Thread mit mehreren Sitzungen wartet selbst mit poll und übergibt 0.
+ *
+ * Rückgabewert:
+ * - true, solange die Sitzung läuft.
+ * - false, wenn die Sitzung beendet ist oder ein Fehler aufgetreten ist.
+ *
+ * Beschreibung:
+ * - Jede Iteration wartet in `event_loop_wait` auf den Socket, den Zeitschlitz-Takt 
+ *   oder den nächsten Token der Senderate und verarbeitet danach alle wartenden Pakete.
+ */
+bool session_step(struct session* s, int max_wait_ms)
+{
+    struct properties* props = s->props;
+    struct communication* com = &s->com;
+    int ticks = 0;
+
+    if(!s->running)
+    {
+        return false;
+    }
+
+    // Warten auf Pakete, den nächsten Zeitschlitz, den nächsten Token oder einen Timer
+    if(s->state != STATE_INIT)
+    {
+        int wait_ms = session_wait_ms(s);
+        if(max_wait_ms >= 0 && (wait_ms < 0 || wait_ms > max_wait_ms))
+        {
+            wait_ms = max_wait_ms;
+        }
+
+        if(event_loop_wait(&s->loop, wait_ms, &ticks) < 0)
+        {
+            s->running = false;
+            return false;
+        }
+    }
+
+    switch (s->state) 
+    {
+        case STATE_INIT:
+        {
+            // Initialisierung des Servers
+            // Leere Mitgliederliste
+            memberlist_free(&s->list_members);
+            if(memberlist_init(&s->list_members, props->windows_size) < 0)
+            {
+                s->running = false;
+                break;
+            }
+            s->catchups.count = 0;
+            props->rto = DEFAULT_RTO;        // Ohne Mitglieder gibt es keine RTT-Messung
+            
+            // Der Lese-Thread der letzten Runde schreibt in den Paketpool
+            if(s->pipeline != NULL)
+            {
+                pipeline_stop_reader(s->pipeline);
+            }
+
+            // Fenster freigeben, falls vorhanden, und neu anlegen
+            transport_attach_pool(props, NULL);
+            window_free(&s->window);
+            if(window_init(&s->window, props->windows_size, props->binary ? props->segment_size : DEFAULT_DATA_BUFFER_SIZE, true, s->pipeline != NULL ? PIPELINE_PREFETCH : 0) < 0)
+            {
+                s->running = false;
+                break;
+            }
+
+            // Nutzdaten werden ohne Kopie aus dem Paketpool des Fensters gesendet
+            transport_attach_pool(props, &s->window.pool);
+
+            // Datei auf Anfang zurücksetzen
+            rewind_file(props);
+
+            // Ab hier liest mit --pipeline der Lese-Thread die Datei
+            if(s->pipeline != NULL && pipeline_start_reader(s->pipeline) < 0)
+            {
+                s->running = false;
+                break;
+            }
+            
+            // Kommunikationsstruktur initialisieren
+            com->ans.type = '0';
+
+            // Variablen initialisieren
+            s->packages_in_queue = 0;
+            s->base = 1;
+            s->current = 1;
+
+            // Timer-Rad mit einem Knoten pro Platz im Fenster anlegen
+            timer_wheel_free(&s->timers);
+            repair_queue_free(&s->repairs);
+            if(timer_wheel_init(&s->timers, s->window.capacity) < 0 || repair_queue_init(&s->repairs, s->window.capacity) < 0)
+            {
+                s->running = false;
+                break;
+            }
+
+            // Parität des ersten Blocks leeren
+            fec_free(&s->fec);
+            if(props->fec_source > 0 && fec_init(&s->fec, props->fec_source, props->fec_parity, s->window.payload_size, 1) < 0)
+            {
+                s->running = false;
+                break;
+            }
+
+            s->closed = false;     // Pufferendemarkierung zurücksetzen
+
+            // Wartezeit beginnt beim Eintritt in STATE_IDLE
+            print_timestamp();
+            printf(BLUE "Warte... %is\n" RESET, DEFAULT_IDLE_TIME);
+            s->idle_until = get_time_us() + DEFAULT_IDLE_TIME * 1000000LL;
+
+            // Zustand wechseln
+            print_timestamp();
+            printf("Wechsel zu STATE_IDLE\n");
+            s->state = STATE_IDLE;
+            break;
+        }
+
+        case STATE_IDLE:
+        {
+            // Während der Wartezeit eintreffende Pakete gehören zu keiner Runde
+            int result;
+            while((result = session_receive(s, NULL)) > 0);
+            if(result < 0)
+            {
+                s->running = false;
+                break;
+            }
+
+            if(get_time_us() < s->idle_until)
+            {
+                break; // Wartezeit noch nicht abgelaufen
+            }
+
+            // Hello-Paket vorbereiten und senden
+            prepare_hello_package(props, com);
+            if(send_multicast(props, com)<0)
+            {
+                s->running = false; // Fehler beim Senden
+                break;
+            }
+
+            // Wartezeit für Mitgliederregistrierung, alle Antworten eines Zeitschlitzes werden verarbeitet
+            event_loop_reset(&s->loop);
+            s->slots_left = MAX_ALLOWED_CLIENTS;
+            
+            // Zustand wechseln
+            print_timestamp();
+            printf("Wechsel zu STATE_PREPARE\n");
+            s->state = STATE_PREPARE;
+            break;
+        }
+
+        case STATE_PREPARE:
+        {
+            s->slots_left -= ticks;
+
+            int result;
+            while((result = session_receive(s, NULL)) > 0) // Paket empfangen
+            {
+                if(com->ans.type == ANS_HELLO) // Hello-Paket erkannt
+                {
+                    // Mitglied registrieren, ein wiederholtes HELLO zählt nicht doppelt
+                    bool known = member_find(&s->list_members, com->ans.senderId, &com->partner.sin6_addr) >= 0;
+                    com->member = member_add(&s->list_members, com->ans.senderId, &com->partner);
+                    if(com->member < 0)
+                    {
+                        s->running = false;
+                        break;
+                    }
+
+                    if(!known)
+                    {
+                        print_timestamp();
+                        printf(GREEN "Mitglied mit ID:%i registriert\n" RESET, com->ans.senderId);
+                    }
+
+                    // Das HELLO spiegelt den Zeitstempel des HELLO des Servers, erste RTT-Messung
+                    member_update_feedback(props, &s->list_members, com->member, &com->ans);
+                }
+            }
+
+            if(result < 0)
+            {
+                s->running = false;
+            }
+
+            if(!s->running || s->slots_left > 0)
+            {
+                break; // Registrierung läuft noch
+            }
+
+            // Überprüfen, ob Mitglieder registriert wurden
+            if(s->list_members.number_members>0)
+            {
+                // Senderate und Zeitschlitze für die Übertragung starten
+                pacer_init(&s->pacer, props->rate * 1000.0 / 8.0, DEFAULT_BURST_SIZE * MAX_DATAGRAM_SIZE);
+                // Aufholen ohne Burst, damit die laufende Übertragung nicht ins Stocken gerät
+                pacer_init(&s->catchup, (props->catchup_rate > 0 ? props->catchup_rate : props->rate / (double)DEFAULT_CATCHUP_SHARE) * 1000.0 / 8.0, MAX_DATAGRAM_SIZE);
+
+                // Die Ratenregelung beginnt mit --rate und senkt erst bei gemeldeten Verlusten
+                s->cc.rate = s->pacer.rate;
+                s->cc.max_rate = s->pacer.rate;
+                s->cc.clr = -1;
+                s->cc.slowest = -1;
+                s->cc.slowest_rate = 0;
+                s->cc.max_rtt = 0;
+                s->cc.scanned = 0;
+                s->cc.updated = get_time_us();
+                s->cc.started = s->cc.updated;
+                s->cc.logged = 0;
+                event_loop_reset(&s->loop);
+                com->ans.type = '0';
+                s->wake_at = get_time_us();
+
+                print_timestamp();
+                printf("Wechsel zu STATE_ESTABLISHED\n");
+                s->state = STATE_ESTABLISHED;
+            }
+            else
+            {
+                print_timestamp();
+                printf(RED "Keine Teilnehmer gefunden.\n" RESET);
+                print_timestamp();
+                printf(BLUE "Warte... %is\n" RESET, DEFAULT_IDLE_TIME);
+                s->idle_until = get_time_us() + DEFAULT_IDLE_TIME * 1000000LL;
+                print_timestamp();
+                printf("Wechsel zu STATE_IDLE\n");
+                s->state = STATE_IDLE;
+            }
+
+            break;
+        }
+
+        case STATE_ESTABLISHED:
+        {
+            // Abgelaufene Timer behandeln
+            handle_timeouts(&s->timers, &s->window, ticks);
+
+            // Alle wartenden Antworten verarbeiten, ein NACK aus STATE_CLOSE liegt bereits in `com`
+            int result = (com->ans.type == ANS_NACK) ? 1 : session_receive(s, &s->list_members);
+            while(s->running && result > 0)
+            {
+                member_update_feedback(props, &s->list_members, com->member, &com->ans);
+                congestion_feedback(props, &s->cc, &s->list_members, com->member);
+                handle_ack(&s->list_members, com->member, &com->ans, s->current);
+                handle_catchup_report(props, &s->catchups, com);
+                handle_leave(s, com);
+
+                // HELLO eines unbekannten Clients: später Beitritt
+                if(handle_join(props, com, &s->list_members, &s->catchups, s->base, s->current) < 0)
+                {
+                    s->running = false;
+                }
+
+                // NACK behandeln, alle Pakete der Verlust-Bitmap werden zur Wiederholung vorgemerkt
+                if(com->ans.type == ANS_NACK)
+                {   
+                    for(int id = com->ans.packageId; id >= 0; id = nack_next_loss(&com->ans, id))
+                    {
+                        request_repair(props, com, &s->window, &s->timers, &s->repairs, id, s->base, s->current);
+                    }
+                }
+
+                com->ans.type = '0'; // Antwort zurücksetzen
+                result = session_receive(s, &s->list_members);
+            }
+
+            if(result < 0)
+            {
+                s->running = false;
+            }
+
+            // Verstummte Mitglieder entfernen, danach die Senderate an die gemeldeten Verlustraten anpassen
+            evict_silent_members(s);
+            update_congestion(props, &s->cc, &s->list_members, &s->pacer);
+
+            // Nach der Sammelzeit jedes angeforderte Paket einmal wiederholen
+            if(s->running && s->repairs.due > 0 && get_time_us() >= s->repairs.due)
+            {
+                if(flush_repairs(props, com, &s->window, &s->pacer, &s->repairs, &s->list_members, s->base) < 0)
+                {
+                    s->running = false;
+                }
+            }
+
+            // Fenster verschieben, bestätigte Pakete sofort, alle anderen nach Ablauf ihres Timers
+            slide_window(s);
+
+
+            // Füllen des Fensters bis es voll ist
+            while(s->packages_in_queue<props->windows_size)
+            {
+                // Im Nachhinhein eine etwas hässliche Lösung mit den Prepare Paclage ngl
+                // Habe übersehen das man vorpuffern soll warum auch immer
+
+                struct communication com_temp;
+                int package_id = s->base + s->packages_in_queue;
+
+                char* line;
+                long long offset;
+                int length;
+                int packet = PACKET_NONE;
+                if(s->pipeline != NULL)
+                {
+                    // Vom Lese-Thread vorausgelesenes Paket übernehmen
+                    struct prefetch entry;
+                    pipeline_refill(s->pipeline);
+                    if(!spsc_ring_pop(&s->pipeline->filled, &entry))
+                    {
+                        break; // Noch nicht gelesen, der Lese-Thread weckt den Sendethread
+                    }
+
+                    s->pipeline->outstanding -= 1;
+                    s->pipeline->eof = entry.length < 0;
+                    packet = entry.packet;
+                    offset = entry.offset;
+                    length = entry.length;
+
+                    if(length < 0 && packet != PACKET_NONE)
+                    {
+                        packet_unref(&s->window.pool, packet);
+                        packet = PACKET_NONE;
+                    }
+                    else if(length >= 0)
+                    {
+                        // Mit Puffer übernimmt window_store das Handle, mit --mmap zeigt der Platz in die Datei
+                        window_set_data(&s->window, package_id, packet == PACKET_NONE ? entry.data : NULL);
+                    }
+                }
+                else if(props->use_mmap)
+                {
+                    // Nutzdaten bleiben in der eingeblendeten Datei
+                    offset = props->map_pos;
+                    length = props->binary ? get_mapped_segment(props, &line) : get_mapped_line(props, &line);
+                    if(length >= 0)
+                    {
+                        window_set_data(&s->window, package_id, line);
+                    }
+                }
+                else
+                {
+                    // Datei direkt in den Puffer des Fensterplatzes lesen
+                    line = window_reserve(&s->window, package_id);
+                    if(line == NULL)
+                    {
+                        s->running = false;
+                        break;
+                    }
+
+                    offset = ftello(props->file);
+                    length = props->binary ? get_file_segment(props, line) : get_file_line(props, line);
+                }
+
+                if(length>=0)
+                {   
+                    print_timestamp();
+                    printf(GREEN "Paket %d wird gepackt\n" RESET, package_id);
+                    if(props->binary)
+                    {
+                        prepare_segment_package(props, &com_temp, package_id, length, offset);
+                    }
+                    else
+                    {
+                        prepare_data_package(props, &com_temp, package_id, length);
+                    }
+                    window_store(&s->window, &com_temp.req, packet);
+                    if(packet != PACKET_NONE)
+                    {
+                        packet_unref(&s->window.pool, packet); // Referenz liegt jetzt beim Platz im Fenster
+                    }
+                    s->packages_in_queue += 1;
+                }
+                else
+                {
+                    // Wenn CLOSE noch nicht erstellt wurde, wird CLOSE Paket erstellt
+                    if(!s->closed)
+                    {
+                        print_timestamp();
+                        printf(GREEN "Paket %d CLOSE wird gepackt\n" RESET, package_id);
+                        prepare_close_package(props, &com_temp, package_id);
+                        window_store(&s->window, &com_temp.req, PACKET_NONE);
+                        s->packages_in_queue += 1;
+                        s->closed = true;
+                    }
+
+                    break;
+                }
+            }
+            
+
+            // Daten senden, solange das Fenster es erlaubt und die Senderate nicht überschritten wird
+            while(s->running && s->state == STATE_ESTABLISHED && s->current < s->base + s->packages_in_queue)
+            {
+                if(!pacer_consume(&s->pacer, window_get_wire_size(&s->window, s->current)))
+                {
+                    break; // Warten bis genug Tokens vorhanden sind
+                }
+
+                // Laden des Pakets aus dem Fenster und starten eines Timers
+                com->packet = window_load(&s->window, s->current, &com->req);
+                com->payload = window_get_payload(&s->window, s->current);
+
+                // Wenn CLOSE Paket aus dem Fenster geladen wird, wird zu close state gewechselt    
+                if(com->req.type != REQ_CLOSE)
+                {
+                    timer_wheel_add(&s->timers, s->current, release_timeout_ms(props));
+                    s->current += 1;
+                }
+                else
+                {
+                    // Doppelte Timerlänge CLOSE Paket um CLOSE NACK Problem zu lösen.
+                    timer_wheel_add(&s->timers, s->current, 2 * release_timeout_ms(props));
+                    print_timestamp();
+                    printf("Wechsel zu STATE_CLOSE\n");
+
+                    s->state = STATE_CLOSE;
+                }
+
+                // Multicast senden, danach ggf. die Parität des abgeschlossenen Blocks
+                if(send_data_package(props, com, false) < 0 || send_parity_packages(props, com, &s->fec, &s->pacer) < 0)
+                {
+                    s->running = false;
+                }
+            }
+
+            // Spät beigetretene Mitglieder mit der Senderate zum Aufholen bedienen (--catchup)
+            if(s->running && send_catchup(props, com, &s->list_members, &s->catchups, &s->catchup, &s->pacer) < 0)
+            {
+                s->running = false;
+            }
+
+            // Nur auf den nächsten Token warten, wenn noch ein Paket im Fenster wartet
+            int wait_ms = -1;
+            if(s->state == STATE_ESTABLISHED && s->current < s->base + s->packages_in_queue)
+            {
+                wait_ms = pacer_wait_ms(&s->pacer, window_get_wire_size(&s->window, s->current));
+            }
+            else if(s->state == STATE_ESTABLISHED)
+            {
+                print_timestamp();
+                printf(RED "Fensterende erreicht, kein Paket gesendet\n" RESET);
+            }
+
+            // Spätestens zum Ablauf des nächsten Timers bzw. der Sammelzeit aufwachen
+            wait_ms = timer_wheel_wait_ms(&s->timers, repair_queue_wait_ms(&s->repairs, catchup_wait_ms(props, &s->catchups, &s->catchup, wait_ms)));
+            s->wake_at = (wait_ms < 0) ? 0 : get_time_us() + wait_ms * 1000LL;
+
+            print_timestamp();
+            print_timer_wheel(&s->timers); // Timer anzeigen
+            print_timestamp();
+            printf("Pakete in %d Queue\n", s->packages_in_queue);
+            print_timestamp();
+            printf("Base %d\n", s->base);
+
+            break;
+        }
+
+        case STATE_CLOSE:
+        {
+            // Alle wartenden Antworten verarbeiten, ein NACK beendet den Zustand
+            int result;
+            while((result = session_receive(s, &s->list_members)) > 0)
+            {
+                if(com->ans.type == ANS_CLOSE)
+                {
+                    print_timestamp();
+                    printf(GREEN "CLOSE erhalten von Id %d\n" RESET, com->ans.senderId);
+                }
+
+                if(com->ans.type == ANS_NACK)
+                {
+                    break; // RTT wird in STATE_ESTABLISHED gemessen
+                }
+
+                member_update_feedback(props, &s->list_members, com->member, &com->ans);
+                congestion_feedback(props, &s->cc, &s->list_members, com->member);
+                handle_ack(&s->list_members, com->member, &com->ans, s->current);
+                handle_catchup_report(props, &s->catchups, com);
+                handle_leave(s, com);
+            }
+
+            if(result < 0)
+            {
+                s->running = false;
+                break;
+            }
+
+            if(com->ans.type == ANS_NACK)
+            {
+                timer_wheel_del(&s->timers, s->current);
+                s->wake_at = get_time_us();
+                print_timestamp();
+                printf("Wechsel zu STATE_ESTABLISHED\n");
+                s->state = STATE_ESTABLISHED;
+                break;
+            }
+
+            com->ans.type = '0';
+
+            // Vor dem CLOSE gesammelte NACKs noch beantworten
+            if(s->repairs.due > 0 && get_time_us() >= s->repairs.due)
+            {
+                if(flush_repairs(props, com, &s->window, &s->pacer, &s->repairs, &s->list_members, s->base) < 0)
+                {
+                    s->running = false;
+                    break;
+                }
+            }
+
+            handle_timeouts(&s->timers, &s->window, ticks);
+            evict_silent_members(s);
+
+            // Fenster verschieben, bestätigte Pakete sofort, alle anderen nach Ablauf ihres Timers
+            slide_window(s);
+
+            print_timestamp();
+            print_timer_wheel(&s->timers); // Timer anzeigen
+
+
+            if(send_catchup(props, com, &s->list_members, &s->catchups, &s->catchup, &s->pacer) < 0)
+            {
+                s->running = false;
+                break;
+            }
+
+            // Beenden wenn keine Pakete mehr in Liste und alle spät Beigetretenen aufgeholt haben
+            if(s->packages_in_queue > 0 || s->catchups.count > 0)
+            {
+                print_timestamp();
+                printf("Pakete in %d Queue\n", s->packages_in_queue);
+                print_timestamp();
+                printf("Base %d\n", s->base);
+                break;
+            }
+
+            if(props->loop)
+            {
+                print_timestamp();
+                printf("Wechsel zu STATE_INIT\n");
+                s->state = STATE_INIT;
+                break;
+            }
+
+            s->running = false; // Beenden der Schleife
+            break;
+        }
+    }
+
+    return s->running;
+}
+
+
+/**
+ * Funktion: run_state_machine
+ * ----------------------------------
+ * Führt eine einzelne Sitzung im aufrufenden Thread aus, bis sie beendet ist.
+ *
+ * Parameter:
+ * - props: Pointer auf die `properties`-Struktur mit Server-Informationen.
+ */
+void run_state_machine(struct properties* props) 
+{
+    struct session session;
+
+    if(session_init(&session, props) == 0)
+    {
+        while(session_step(&session, -1));
+    }
+
+    // Ressourcen freigeben
+    session_free(&session);
+    close_socket(props);
+    print_timestamp();
+    printf("Programm wird beendet\n");
+}
+
+
+/**
+ * Funktion: allowed_cores
+ * -----------------------
+ * Ermittelt die Kerne, auf denen der Prozess laufen darf. Mit `taskset` oder einem cpuset 
+ * der cgroup sind das nicht alle Kerne des Rechners.
+ *
+ * Parameter:
+ * - cores: Feld mit mindestens CPU_SETSIZE Einträgen, erhält die Nummern der Kerne aufsteigend.
+ *
+ * Rückgabewert:
+ * - Anzahl der erlaubten Kerne, mindestens 1.
+ */
+static int allowed_cores(int* cores)
+{
+    int count = 0;
+
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if(sched_getaffinity(0, sizeof(set), &set) == 0)
+    {
+        for(int core = 0; core < CPU_SETSIZE && count < CPU_COUNT(&set); core++)
+        {
+            if(CPU_ISSET(core, &set))
+            {
+                cores[count++] = core;
+            }
+        }
+    }
+#endif
+
+    // Ohne Maske alle Kerne, die online sind
+    if(count == 0)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        count = online < 1 ? 1 : (online > CPU_SETSIZE ? CPU_SETSIZE : (int)online);
+        for(int core = 0; core < count; core++)
+        {
+            cores[core] = core;
+        }
+    }
+
+    return count;
+}
+
+
+/**
+ * Funktion: run_worker
+ * --------------------
+ * Thread eines Servers mit mehreren Sitzungen (--sessions). Der Thread wird an seinen Kern 
+ * gebunden und wartet mit einem poll über die Ereignisschleifen aller seiner Sitzungen. 
+ * Jede Sitzung, deren Socket oder Takt bereit ist oder deren Wartezeit abgelaufen ist, 
+ * wird um eine Iteration weitergeschaltet.
+ *
+ * Parameter:
+ * - arg: Pointer auf die `worker`-Struktur des Threads.
+ *
+ * Rückgabewert:
+ * - NULL.
+ */
+static void* run_worker(void* arg)
+{
+    struct worker* worker = (struct worker*)arg;
+
+#ifdef __linux__
+    // Thread an seinen Kern binden, damit Fenster und Puffer im Cache des Kerns bleiben
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(worker->core, &set);
+    if(pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+    {
+        print_timestamp();
+        printf(RED "Thread konnte nicht an Kern %d gebunden werden\n" RESET, worker->core);
+    }
+#endif
+
+    struct pollfd* fds = (struct pollfd*)calloc(worker->count, sizeof(struct pollfd));
+    if(fds == NULL)
+    {
+        print_timestamp();
+        printf(RED "Speicher für die Sitzungen des Threads konnte nicht reserviert werden\n" RESET);
+        return NULL;
+    }
+
+    int active = worker->count;
+    while(active > 0)
+    {
+        // Auf die kürzeste Wartezeit aller laufenden Sitzungen warten
+        int timeout_ms = -1;
+        for(int i = 0; i < worker->count; i++)
+        {
+            struct session* s = worker->sessions[i];
+            fds[i].fd = s->running ? event_loop_fd(&s->loop) : -1; // Negative Deskriptoren ignoriert poll
+            fds[i].events = POLLIN;
+            fds[i].revents = 0;
+
+            int wait_ms = s->running ? session_wait_ms(s) : -1;
+            if(wait_ms >= 0 && (timeout_ms < 0 || wait_ms < timeout_ms))
             {
-                // Wartezeit für Mitgliederregistrierung
-                for(int interval=0; interval<MAX_ALLOWED_CLIENTS; interval++)
-                {
-                    if(receive_cast(props, &com, NULL)) // Paket empfangen
-                    {
-                        if(com.ans.type == ANS_HELLO) // Hello-Paket erkannt
-                        {
-                            // Mitglied registrieren
-                            list_members.member[list_members.number_members].member_id = com.ans.senderId;
-                            list_members.member[list_members.number_members].member = com.partner;
-                            list_members.number_members += 1;
-                            
-                            print_timestamp();
-                            printf(GREEN "Mitglied mit ID:%i registriert\n" RESET, com.ans.senderId);
-                        }
-                    }
-                }
+                timeout_ms = wait_ms;
+            }
+        }
 
-                // Überprüfen, ob Mitglieder registriert wurden
-                if(list_members.number_members>0)
-                {
-                    print_timestamp();
-                    printf("Wechsel zu STATE_ESTABLISHED\n");
-                    state = STATE_ESTABLISHED;
-                }
-                else
-                {
-                    print_timestamp();
-                    printf(RED "Keine Teilnehmer gefunden.\n" RESET);
-                    print_timestamp();
-                    printf("Wechsel zu STATE_IDLE\n");
-                    state = STATE_IDLE;
-                }
+        if(poll(fds, worker->count, timeout_ms) < 0 && errno != EINTR)
+        {
+            print_timestamp();
+            printf(RED "Fehler bei poll()\n" RESET);
+            perror("\t\t");
+            break;
+        }
 
-                break;
+        active = 0;
+        for(int i = 0; i < worker->count; i++)
+        {
+            struct session* s = worker->sessions[i];
+            if(s->running && ((fds[i].revents & POLLIN) || session_wait_ms(s) == 0))
+            {
+                session_step(s, 0);
+                flush_cast(s->props); // Gesammelte Pakete vor dem nächsten poll senden
             }
 
-            // Bisschen Kacke geschrieben alles ngl, könnte mit Funktionen besser werden
-            case STATE_ESTABLISHED:
+            active += s->running ? 1 : 0;
+        }
+    }
+
+    free(fds);
+    return NULL;
+}
+
+
+/**
+ * Funktion: load_sessions
+ * -----------------------
+ * Liest die Sitzungsdatei (--sessions). Jede Zeile enthält die Optionen einer Sitzung, die 
+ * nach den Optionen der Kommandozeile ausgewertet werden und diese damit überschreiben.
+ *
+ * Parameter:
+ * - props: Eigenschaften der Kommandozeile mit dem Pfad der Sitzungsdatei.
+ * - argc: Anzahl der Kommandozeilenargumente.
+ * - argv: Array der Kommandozeilenargumente.
+ * - sessions: Ausgabe, Feld mit den Eigenschaften der Sitzungen (mit free freigeben).
+ *
+ * Rückgabewert:
+ * - Anzahl der Sitzungen.
+ * - -1 bei einem Fehler in der Datei oder ohne Sitzungen.
+ */
+static int load_sessions(struct properties* props, int argc, char** argv, struct properties** sessions)
+{
+    FILE* file = fopen(props->sessions_path, "r");
+    if(file == NULL)
+    {
+        print_timestamp();
+        printf(RED "Sitzungsdatei konnte nicht geöffnet werden\n" RESET);
+        return -1;
+    }
+
+    char** args = (char**)malloc((argc + MAX_SESSION_ARGS) * sizeof(char*));
+    if(args == NULL)
+    {
+        fclose(file);
+        return -1;
+    }
+
+    char line[MAX_SESSION_LINE];
+    int count = 0;
+    *sessions = NULL;
+
+    while(fgets(line, sizeof(line), file) != NULL)
+    {
+        // Kommandozeile übernehmen, danach die Optionen der Zeile anhängen
+        int args_count = argc;
+        memcpy(args, argv, argc * sizeof(char*));
+
+        char* save = NULL;
+        for(char* token = strtok_r(line, " \t\r\n", &save); token != NULL; token = strtok_r(NULL, " \t\r\n", &save))
+        {
+            if(token[0] == '#')
             {
-                int timeout_package_id = tick_timer_linked_list_timer(&timer_list);
+                break; // Rest der Zeile ist ein Kommentar
+            }
 
-                // Timer verwalten
-                if(timeout_package_id > 0)
-                {
-                    print_timestamp();
-                    printf(RED "Paket %d TIMEOUT\n" RESET, timeout_package_id);
-                    queue[timeout_package_id - base].timeout = true;
+            if(args_count == argc + MAX_SESSION_ARGS)
+            {
+                print_timestamp();
+                printf(RED "Zu viele Optionen in Sitzung %d\n" RESET, count + 1);
+                count = -1;
+                break;
+            }
 
-                }
-                else
-                {
-                    print_timestamp();
-                    printf(RED "Kein TIMEOUT\n" RESET);
-                }
+            args[args_count++] = token;
+        }
 
-                // NACK behandeln
-                bool nack_recived = false;
-                if(com.ans.type == ANS_NACK)
-                {   
-                    // NACK außerhalb des Fensters
-                    if(com.ans.packageId < base)
-                    {
-                        print_timestamp();
-                        printf(RED "NACK von Empänger mit ID %d für Paket %d, außerhalb des Sendefensters!\n" RESET, com.ans.senderId, com.ans.packageId);
+        if(count < 0)
+        {
+            break;
+        }
 
-                    }
-                    else if(com.ans.packageId > current)
-                    {
-                        print_timestamp();
-                        printf(RED "NACK von Empänger mit ID %d für Paket %d, wurde noch nicht gesendet!\n" RESET, com.ans.senderId, com.ans.packageId);
-                    }
-                    else if(queue[com.req.packageId-base].req.type == REQ_CLOSE)
-                    {
-                        print_timestamp();
-                        printf(RED "NACK für CLOSE wird ignoriert!\n" RESET);
-                    }
-                    else
-                    {
-                        nack_recived = true;
+        if(args_count == argc)
+        {
+            continue; // Leere Zeile
+        }
 
-                        print_timestamp();
-                        printf(RED "NACK von Empänger mit ID %d für Paket %d erhalten\n" RESET, com.ans.senderId, com.ans.packageId);
-                        
-                        // Timer neu setzen
-                        del_timer_linked_list_timer(&timer_list, com.ans.packageId);
-                        add_timer_linked_list_timer(&timer_list, com.ans.packageId, MAX_ALLOWED_CLIENTS);
-                        queue[com.ans.packageId - base].timeout = false;
-                        
-                        // Paket erneut senden
-                        com.req = queue[com.ans.packageId - base].req;
-                        com.req.reciverId = com.ans.senderId;
-                        
-                        if(!props->local)
-                        {
-                            if(props->debug_code>0)
-                            {
-                                if((rand()%100)+1<=props->debug_code)
-                                {
-                                    print_timestamp();
-                                    printf(RED "Paket %d verloren\n" RESET, com.req.packageId);
-                                }
-                                else
-                                {
-                                    if(send_unicast(props, &com)<0)
-                                    {
-                                        running = false;
-                                    }
-
-                                    print_timestamp();
-                                    printf(GREEN "Paket %d gesendet an Empfänger mit Id %d\n" RESET, com.req.packageId, com.req.reciverId);
-                                }
-                            }
-                            else
-                            {
-                                if(send_unicast(props, &com)<0)
-                                {
-                                    running = false;
-                                }
-
-                                print_timestamp();
-                                printf(GREEN "Paket %d gesendet an Empfänger mit Id %d\n" RESET, com.req.packageId, com.req.reciverId);
-                            }
-                        }
-                        else
-                        {
-                            if(props->debug_code>0)
-                            {
-                                if((rand()%100)+1<=props->debug_code)
-                                {
-                                    print_timestamp();
-                                    printf(RED "Paket %d verloren\n" RESET, com.req.packageId);
-                                }
-                                else
-                                {
-                                    if(send_multicast(props, &com)<0)
-                                    {
-                                        running = false;
-                                    }
-
-                                    print_timestamp();
-                                    printf(GREEN "Paket %d gesendet\n" RESET, com.req.packageId);
-                                }
-                            }
-                            else
-                            {
-                                if(send_multicast(props, &com)<0)
-                                {
-                                    running = false;
-                                }
-
-                                print_timestamp();
-                                printf(GREEN "Paket %d gesendet\n" RESET, com.req.packageId);
-                            }
-                        }
-                        
-                        
-                        // Setzen des Pakets auf 0, damit wird das Paket bei der nächsten Itteration überschrieben und nicht als NACK
-                        com.ans.type = '0';
-                    }
-                }
-                
+        struct properties* grown = (struct properties*)realloc(*sessions, (count + 1) * sizeof(struct properties));
+        if(grown == NULL)
+        {
+            count = -1;
+            break;
+        }
+        *sessions = grown;
 
-                // Fenster verschieben
-                while(queue[0].timeout == true && packages_in_queue > 0)
-                {
-                    shift_queue(&queue, packages_in_queue);
-                    base += 1;
-                    packages_in_queue -= 1;
-                }
+        struct properties* session = &(*sessions)[count];
+        session->is_server = true;
+        if(setup_properties(args_count, args, session) < 0)
+        {
+            print_timestamp();
+            printf(RED "Ungültige Optionen in Sitzung %d\n" RESET, count + 1);
+            count = -1;
+            break;
+        }
 
+        count += 1;
+    }
 
-                // Füllen des Fensters bis es voll ist
-                while(packages_in_queue<props->windows_size)
-                {
-                    // Im Nachhinhein eine etwas hässliche Lösung mit den Prepare Paclage ngl
-                    // Habe übersehen das man vorpuffern soll warum auch immer
+    free(args);
+    fclose(file);
 
-                    struct communication com_temp;
+    if(count == 0)
+    {
+        print_timestamp();
+        printf(RED "Sitzungsdatei enthält keine Sitzung\n" RESET);
+        count = -1;
+    }
 
-                    char line[DEFAULT_DATA_BUFFER_SIZE];
-                    if(get_file_line(props, line)>=0)
-                    {   
-                        print_timestamp();
-                        printf(GREEN "Paket %d wird gepackt\n" RESET, base+packages_in_queue);
-                        prepare_data_package(props, &com_temp, base+packages_in_queue, line);
-                        queue[packages_in_queue].req = com_temp.req;
-                        queue[packages_in_queue].timeout = false;
-                        packages_in_queue += 1;
-                    }
-                    else
-                    {
-                        // Wenn CLOSE noch nicht erstellt wurde, wird CLOSE Paket erstellt
-                        if(!closed)
-                        {
-                            print_timestamp();
-                            printf(GREEN "Paket %d CLOSE wird gepackt\n" RESET, base+packages_in_queue);
-                            prepare_close_package(props, &com_temp, base+packages_in_queue);
-                            queue[packages_in_queue].req = com_temp.req;
-                            queue[packages_in_queue].timeout = false;
-                            packages_in_queue += 1;
-                            closed = true;
-                        }
+    if(count < 0)
+    {
+        free(*sessions);
+        *sessions = NULL;
+    }
 
-                        break;
-                    }
-                }
-                
+    return count;
+}
 
-                // Daten senden, wenn kein NACK empfangen wurde
-                if(!nack_recived)
-                {   
-                    if(base+props->windows_size > current)
-                    {
-                        // Laden des Pakets aus dem Fenster und starten eines Timers
-                        com.req = queue[current-base].req;    
-
-                        // Wenn CLOSE Paket aus dem Fenster geladen wird, wird zu close state gewechselt    
-                        if(com.req.type != REQ_CLOSE)
-                        {
-                            del_timer_linked_list_timer(&timer_list, current);
-                            add_timer_linked_list_timer(&timer_list, current, MAX_ALLOWED_CLIENTS);
-                            current += 1;
-                        }
-                        else
-                        {
-                            // Doppelte Timerlänge CLOSE Paket um CLOSE NACK Problem zu lösen.
-                            del_timer_linked_list_timer(&timer_list, current);
-                            add_timer_linked_list_timer(&timer_list, current, 2 * MAX_ALLOWED_CLIENTS);                            
-                            print_timestamp();
-                            printf("Wechsel zu STATE_CLOSE\n");
-
-                            state = STATE_CLOSE;
-                        }
-
-                        // Multicast senden
-                        if(props->debug_code > 0)
-                        {
-                            if((rand()%100)+1<=props->debug_code)
-                            {
-                                print_timestamp();
-                                printf(RED "Paket %d verloren\n" RESET, com.req.packageId);
-                            }
-                            else
-                            {
-                                if(send_multicast(props, &com)<0)
-                                {
-                                    running = false;
-                                }
-
-                                print_timestamp();
-                                printf(GREEN "Paket %d gesendet\n" RESET, com.req.packageId);
-                            }                            
-                        }
-                        else if(props->debug_code == -1 && com.req.type == REQ_CLOSE)
-                        {
-                            props->debug_code = 0;
-                            print_timestamp();
-                            printf(RED "CLOSE Paket verloren\n" RESET);
-                        }
-                        else
-                        {
-                            if(send_multicast(props, &com)<0)
-                            {
-                                running = false;
-                            }
-                        }
 
-                    }
-                    else
-                    {
-                        print_timestamp();
-                        printf(RED "Fensterende erreicht, kein Paket gesendet\n" RESET);
-                    }
-                }
+/**
+ * Funktion: stripe_sessions
+ * -------------------------
+ * Legt für --stripes eine Sitzung je Streifen an. Jede sendet dieselbe Datei, aber nur die 
+ * Segmente ihres Streifens, über eine eigene Multicast-Gruppe und eigene Ports (`stripe_properties`).
+ *
+ * Parameter:
+ * - props: Eigenschaften der Kommandozeile mit der Anzahl der Streifen.
+ * - sessions: Ausgabe, Feld mit den Eigenschaften der Sitzungen (mit free freigeben).
+ *
+ * Rückgabewert:
+ * - Anzahl der Sitzungen.
+ * - -1 ohne Binärmodus, zusammen mit --sessions oder bei ungültigen Adressen.
+ */
+static int stripe_sessions(struct properties* props, struct properties** sessions)
+{
+    *sessions = NULL;
+    if(!props->binary || props->sessions_path[0] != '\0')
+    {
+        print_timestamp();
+        printf(RED "--stripes nur im Binärmodus und ohne --sessions möglich\n" RESET);
+        return -1;
+    }
 
-                print_timestamp();
-                print_timer_linked_list_timer(&timer_list); // Timer anzeigen
-                print_timestamp();
-                printf("Pakete in %d Queue\n", packages_in_queue);
-                print_timestamp();
-                printf("Base %d\n", base);
+    *sessions = (struct properties*)calloc(props->stripes, sizeof(struct properties));
+    if(*sessions == NULL)
+    {
+        return -1;
+    }
 
+    for(int k = 0; k < props->stripes; k++)
+    {
+        struct properties* session = &(*sessions)[k];
+        *session = *props;
+        if(stripe_properties(session, k) < 0)
+        {
+            free(*sessions);
+            *sessions = NULL;
+            return -1;
+        }
 
-                com.ans.type = '0'; // Antwort zurücksetzen
+        // Jeder Streifen regelt seine Rate selbst und protokolliert sie getrennt
+        if(session->rate_log_path[0] != '\0')
+        {
+            snprintf(session->rate_log_path + strlen(session->rate_log_path), sizeof(session->rate_log_path) - strlen(session->rate_log_path), ".%d", k);
+        }
+    }
 
-                // Empfang von Paketen
-                if(receive_cast(props, &com, &list_members) < 0)
-                {
-                    running = false;
-                }
+    return props->stripes;
+}
 
-                break;
-            }
 
-            case STATE_CLOSE:
-            {
-                // Empfang von Antworten
-                while(true)
-                {   
-                    if(com.ans.type == ANS_CLOSE)
-                    {
-                        print_timestamp();
-                        printf(GREEN "CLOSE erhalten von Id %d\n" RESET, com.ans.senderId);
-                    }
+/**
+ * Funktion: run_sessions
+ * ----------------------
+ * Startet alle Sitzungen der Sitzungsdatei (--sessions) bzw. alle Streifen (--stripes) in 
+ * einem Prozess. Die Sitzungen werden 
+ * reihum auf `--threads` Threads verteilt, die jeweils an einen eigenen Kern gebunden sind. 
+ * Jede Sitzung hat eigenen Socket, eigene Datei, eigenes Fenster und eigene Timer, sodass 
+ * sich die Threads nur die Konsole teilen.
+ *
+ * Parameter:
+ * - props: Eigenschaften der Kommandozeile mit dem Pfad der Sitzungsdatei.
+ * - argc: Anzahl der Kommandozeilenargumente.
+ * - argv: Array der Kommandozeilenargumente.
+ *
+ * Rückgabewert:
+ * - 0: Alle Sitzungen wurden gestartet und sind beendet.
+ * - -1: Fehler beim Starten einer Sitzung.
+ */
+int run_sessions(struct properties* props, int argc, char** argv)
+{
+    struct properties* sessions_props = NULL;
+    int count = props->stripes > 1 ? stripe_sessions(props, &sessions_props) : load_sessions(props, argc, argv, &sessions_props);
+    if(count < 0)
+    {
+        return -1;
+    }
 
-                    if(com.ans.type == ANS_NACK)
-                    {
-                        del_timer_linked_list_timer(&timer_list, current);
-                        print_timestamp();
-                        printf("Wechsel zu STATE_ESTABLISHED\n");
-                        state = STATE_ESTABLISHED;
-                        break;
-                    }
+    struct session* sessions = (struct session*)calloc(count, sizeof(struct session));
+    struct session** order = (struct session**)calloc(count, sizeof(struct session*));
+    if(sessions == NULL || order == NULL)
+    {
+        free(sessions);
+        free(order);
+        free(sessions_props);
+        return -1;
+    }
 
-                    int timeout_package_id = tick_timer_linked_list_timer(&timer_list);
+    // Socket, Datei und Zustandsmaschine jeder Sitzung vorbereiten
+    int started = 0;
+    int result = 0;
+    for(; started < count; started++)
+    {
+        struct properties* sp = &sessions_props[started];
+        sp->file = NULL;
 
+        if(start_socket(sp) < 0)
+        {
+            close_socket(sp);
+            result = -1;
+            break;
+        }
 
-                    com.ans.type = '0';
+        // Die Streifen einer Datei teilen sich die Prüfsumme, sie wird nur einmal berechnet
+        if(open_file(sp) || (sp->stripe == 0 && hash_file(sp) < 0) || open_rate_log(sp) < 0 || session_init(&sessions[started], sp) < 0)
+        {
+            session_free(&sessions[started]);
+            close_file(sp);
+            close_socket(sp);
+            result = -1;
+            break;
+        }
 
-                    if(timeout_package_id > 0)
-                    {
-                        print_timestamp();
-                        printf(RED "Paket %d TIMEOUT\n" RESET, timeout_package_id);
-                        queue[timeout_package_id - base].timeout = true;
-                    }
-                    else if(timeout_package_id == 0)
-                    {
-                        print_timestamp();
-                        printf(RED "Kein TIMEOUT\n" RESET);
-                    }
+        if(sp->stripe > 0)
+        {
+            sp->file_hash = sessions_props[0].file_hash;
+        }
 
-                    // Fenster verschieben
-                    while(queue[0].timeout == true && packages_in_queue > 0)
-                    {
-                        shift_queue(&queue, packages_in_queue);
-                        base += 1;
-                        packages_in_queue -= 1;
-                    }
+        // Jeder Streifen braucht mindestens ein Segment
+        if(sp->stripes > 1 && sp->file_size > 0 && (sp->file_size + sp->segment_size - 1) / sp->segment_size < sp->stripes)
+        {
+            print_timestamp();
+            printf(RED "Datei hat weniger Segmente als Streifen\n" RESET);
+            started += 1;
+            result = -1;
+            break;
+        }
 
-                    print_timestamp();
-                    print_timer_linked_list_timer(&timer_list); // Timer anzeigen
+        print_timestamp();
+        printf(GREEN "Sitzung %d: %s an Port %d\n" RESET, started + 1, sp->file_path, sp->port_server);
+    }
 
+    if(result == 0)
+    {
+        // Anzahl der Threads: Standardmäßig ein Thread je erlaubtem Kern bzw. je Streifen, höchstens einer je Sitzung
+        static int cores[CPU_SETSIZE];
+        int core_count = allowed_cores(cores);
 
-                    // Beenden wenn keine Pakete mehr in Liste
-                    if(packages_in_queue <= 0)
-                    {
-                        break;
-                    }
-                    else
-                    {
-                        print_timestamp();
-                        printf("Pakete in %d Queue\n", packages_in_queue);
-                        print_timestamp();
-                        printf("Base %d\n", base);
-                    }
-                    
-                    if(receive_cast(props, &com, &list_members)<0)
-                    {
-                        running = false;
-                    }
+        int threads = (props->threads > 0) ? props->threads : (props->stripes > 1 ? count : core_count);
+        if(threads > count)
+        {
+            threads = count;
+        }
+
+        struct worker* workers = (struct worker*)calloc(threads, sizeof(struct worker));
+        if(workers == NULL)
+        {
+            result = -1;
+        }
+        else
+        {
+            // Sitzungen reihum verteilen, die Sitzungen eines Threads liegen im Feld hintereinander
+            int next = 0;
+            for(int t = 0; t < threads; t++)
+            {
+                workers[t].core = cores[t % core_count];
+                workers[t].sessions = &order[next];
+                for(int i = t; i < count; i += threads)
+                {
+                    order[next++] = &sessions[i];
                 }
+                workers[t].count = (int)(&order[next] - workers[t].sessions);
+            }
 
+            print_timestamp();
+            printf(BLUE "%d Sitzungen auf %d Threads\n" RESET, count, threads);
 
-                if(state == STATE_CLOSE)
+            int created = 0;
+            for(; created < threads; created++)
+            {
+                if(pthread_create(&workers[created].thread, NULL, run_worker, &workers[created]) != 0)
                 {
-                    if(props->loop)
-                    {
-                        print_timestamp();
-                        printf("Wechsel zu STATE_INIT\n");
-                        state = STATE_INIT;
-                        break;
-                    }
-
-                    running = false; // Beenden der Schleife
-                }         
+                    print_timestamp();
+                    printf(RED "Thread konnte nicht gestartet werden\n" RESET);
+                    result = -1;
+                    break;
+                }
+            }
 
-                break;
+            // Die Sitzungen nicht gestarteter Threads werden nicht bedient, die übrigen laufen zu Ende
+            for(int t = 0; t < created; t++)
+            {
+                pthread_join(workers[t].thread, NULL);
             }
+
+            free(workers);
         }
     }
 
-    // Ressourcen freigeben
-    free(queue);
-    close_socket(props);
-    print_timestamp();
-    printf("Programm wird beendet\n");
+    // Ressourcen aller gestarteten Sitzungen freigeben
+    for(int i = 0; i < started; i++)
+    {
+        session_free(&sessions[i]);
+        close_file(&sessions_props[i]);
+        close_socket(&sessions_props[i]);
+    }
+
+    free(order);
+    free(sessions);
+    free(sessions_props);
+
+    return result;
 }
 
 
@@ -738,6 +3508,7 @@ void run_state_machine(struct properties* props)
  *   2. Erstellung und Konfiguration des Sockets.
  *   3. Öffnen der erforderlichen Datei.
  *   4. Start der Zustandsmaschine des Servers.
+ * - Mit --sessions bzw. --stripes werden stattdessen alle Sitzungen bzw. Streifen gestartet (`run_sessions`).
  * - Bei Fehlern während der Initialisierung wird der Socket geschlossen, und das Programm 
  *   beendet sich mit einer Fehlermeldung.
  */
@@ -754,6 +3525,16 @@ int main(int argc, char* argv[])
         return -1;
     }    
     
+    // Mehrere Sitzungen in einem Prozess (--sessions) bzw. ein Streifen je Sitzung (--stripes)
+    if(props.sessions_path[0] != '\0' || props.stripes > 1)
+    {
+        int result = run_sessions(&props, argc, argv);
+
+        print_timestamp();
+        printf("Programm wird beendet\n");
+        return result < 0 ? -1 : 0;
+    }
+
     // Socket erstellen    
     if(start_socket(&props) < 0)
     {  
@@ -774,8 +3555,32 @@ int main(int argc, char* argv[])
         return -1;
     }
 
+    // Prüfsumme für das Fortsetzen abgebrochener Übertragungen berechnen
+    if(hash_file(&props) < 0)
+    {
+        close_file(&props);
+        close_socket(&props);
+
+        print_timestamp();
+        printf("Programm wird beendet\n");
+        return -1;
+    }
+
+    // Rate-Log öffnen
+    if(open_rate_log(&props) < 0)
+    {
+        close_file(&props);
+        close_socket(&props);
+
+        print_timestamp();
+        printf("Programm wird beendet\n");
+        return -1;
+    }
+
     // Start der Zustandsmaschine
     run_state_machine(&props);
 
+    close_file(&props);
+
     return 0;
 }
\ No newline at end of file